@@ -0,0 +1,71 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "Distributions.h"
+#include "TTest.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Benchmark the two-tailed p-value for a range of t statistics at a given number of degrees of freedom.
+     */
+    template<class T>
+    void studentsTPValue(benchmark::State & state)
+    {
+        const auto degreesOfFreedom = static_cast<T>(state.range(0));
+        std::vector<T> statistics;
+
+        for (int idx = 0; idx < 64; ++idx) {
+            statistics.push_back(static_cast<T>(idx) / 8);
+        }
+
+        for (auto _ : state) {
+            for (const auto & t : statistics) {
+                benchmark::DoNotOptimize(studentsTTwoTailedP(t, degreesOfFreedom));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(statistics.size()));
+    }
+
+    /**
+     * Benchmark a complete test on in-memory data, with or without the p-values, to show what the p-values add to each test.
+     */
+    template<bool withP>
+    void unpairedTest(benchmark::State & state)
+    {
+        using Test = TTest<double>;
+        std::mt19937 rng(1);
+        std::normal_distribution<double> distribution(100.0, 15.0);
+        std::string csv;
+
+        for (auto row = 0; row < state.range(0); ++row) {
+            csv += (0 < row ? "\n" : "") + std::to_string(distribution(rng)) + "," + std::to_string(distribution(rng));
+        }
+
+        const auto path = (std::filesystem::temp_directory_path() / "t-test-distribution-benchmark.csv").string();
+        std::ofstream(path) << csv;
+        const Test test(Test::DataFileType(path), TTestType::Welch);
+
+        for (auto _ : state) {
+            if constexpr (withP) {
+                benchmark::DoNotOptimize(test.result());
+            } else {
+                benchmark::DoNotOptimize(test.t());
+            }
+        }
+
+        std::filesystem::remove(path);
+    }
+}
+
+BENCHMARK_TEMPLATE(studentsTPValue, double)->Arg(5)->Arg(50)->Arg(5000);
+BENCHMARK_TEMPLATE(studentsTPValue, long double)->Arg(5)->Arg(50)->Arg(5000);
+BENCHMARK_TEMPLATE(unpairedTest, false)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(unpairedTest, true)->Arg(1000)->Arg(100000);
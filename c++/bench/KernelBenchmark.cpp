@@ -0,0 +1,78 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "Kernels.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Generate benchmark values.
+     */
+    template<class T>
+    std::vector<T> benchmarkValues(std::size_t count, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<T> distribution(100.0, 15.0);
+        std::vector<T> values(count);
+
+        for (auto & value : values) {
+            value = distribution(rng);
+        }
+
+        return values;
+    }
+
+    /**
+     * Benchmark the masked sum kernel.
+     */
+    template<class T, Kernels::InstructionSet set>
+    void kernelSum(benchmark::State & state)
+    {
+        if (!Kernels::isSupported(set)) {
+            state.SkipWithError("instruction set not supported");
+            return;
+        }
+
+        const auto values = benchmarkValues<T>(static_cast<std::size_t>(state.range(0)), 1);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(Kernels::sum(values.data(), values.size(), set));
+        }
+
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(values.size() * sizeof(T)));
+    }
+
+    /**
+     * Benchmark the paired differences kernel.
+     */
+    template<class T, Kernels::InstructionSet set>
+    void kernelDifferenceSums(benchmark::State & state)
+    {
+        if (!Kernels::isSupported(set)) {
+            state.SkipWithError("instruction set not supported");
+            return;
+        }
+
+        const auto first = benchmarkValues<T>(static_cast<std::size_t>(state.range(0)), 1);
+        const auto second = benchmarkValues<T>(static_cast<std::size_t>(state.range(0)), 2);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(Kernels::differenceSums(first.data(), second.data(), first.size(), set));
+        }
+
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(2 * first.size() * sizeof(T)));
+    }
+}
+
+BENCHMARK_TEMPLATE(kernelSum, double, Kernels::InstructionSet::Scalar)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelSum, double, Kernels::InstructionSet::Avx2)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelSum, double, Kernels::InstructionSet::Avx512)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelSum, float, Kernels::InstructionSet::Scalar)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelSum, float, Kernels::InstructionSet::Avx2)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelSum, float, Kernels::InstructionSet::Avx512)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelDifferenceSums, double, Kernels::InstructionSet::Scalar)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelDifferenceSums, double, Kernels::InstructionSet::Avx2)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(kernelDifferenceSums, double, Kernels::InstructionSet::Avx512)->Arg(1 << 20);
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "DataFile.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Fetch the path to a CSV file with a given number of rows of two-column data, creating it if necessary.
+     *
+     * Files are created once per process and reused for every run of every benchmark that asks for the same size.
+     *
+     * @param rows The number of rows.
+     * @return The path.
+     */
+    const std::string & benchmarkCsv(long rows)
+    {
+        static std::map<long, std::string> paths;
+        auto & path = paths[rows];
+
+        if (path.empty()) {
+            path = (std::filesystem::temp_directory_path() / ("t-test-loader-benchmark-" + std::to_string(rows) + ".csv")).string();
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            std::mt19937_64 rng(rows);
+            std::normal_distribution<double> distribution(100.0, 15.0);
+            char buffer[64];
+
+            for (long row = 0; row < rows; ++row) {
+                const auto length = std::snprintf(buffer, sizeof(buffer), "%s%.3f,%.3f", (0 == row ? "" : "\n"), distribution(rng), distribution(rng));
+                out.write(buffer, length);
+            }
+        }
+
+        return path;
+    }
+
+    /**
+     * Benchmark loading a DataFile using a given load mode and thread count.
+     */
+    template<LoadMode mode, unsigned int threads = 1>
+    void loadDataFile(benchmark::State & state)
+    {
+        const auto & path = benchmarkCsv(state.range(0));
+        const auto bytes = static_cast<std::int64_t>(std::filesystem::file_size(path));
+
+        for (auto _ : state) {
+            DataFile<double> data(path, LoadOptions{mode, threads});
+            benchmark::DoNotOptimize(data.rowCount());
+        }
+
+        state.SetBytesProcessed(state.iterations() * bytes);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    /**
+     * Benchmark reopening a DataFile from its binary cache, then scanning a column so that the mapped pages are actually read.
+     */
+    void loadCachedDataFile(benchmark::State & state)
+    {
+        const auto & path = benchmarkCsv(state.range(0));
+        const LoadOptions options{LoadMode::Mapped, 1, CacheMode::Update, path + ".bench.ttcache"};
+        static_cast<void>(DataFile<double>(path, options));
+
+        for (auto _ : state) {
+            DataFile<double> data(path, options);
+            benchmark::DoNotOptimize(data.columnSum(0));
+        }
+
+        std::filesystem::remove(options.cachePath);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(loadDataFile, LoadMode::Stream)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(loadDataFile, LoadMode::Mapped)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// 0 threads means one per hardware thread
+BENCHMARK_TEMPLATE(loadDataFile, LoadMode::Mapped, 0)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(loadCachedDataFile)->Arg(10'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
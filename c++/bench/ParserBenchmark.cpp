@@ -0,0 +1,92 @@
+#include <charconv>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "DataFile.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Generate benchmark data items: decimals with three places, as typically found in data files.
+     *
+     * The items are views into a single buffer, like the fields of a loaded file, so that the benchmarks measure conversion rather than cache misses.
+     */
+    const std::vector<std::string_view> & benchmarkItems()
+    {
+        static std::string content;
+        static const auto items = []() {
+            std::mt19937_64 rng(1);
+            std::normal_distribution<double> distribution(100.0, 15.0);
+            std::vector<std::size_t> ends;
+            char buffer[32];
+
+            for (int idx = 0; idx < (1 << 14); ++idx) {
+                content.append(buffer, static_cast<std::size_t>(std::snprintf(buffer, sizeof(buffer), "%.3f", distribution(rng))));
+                ends.push_back(content.size());
+            }
+
+            std::vector<std::string_view> generated;
+            std::size_t begin = 0;
+
+            for (const auto end : ends) {
+                generated.emplace_back(content.data() + begin, end - begin);
+                begin = end;
+            }
+
+            return generated;
+        }();
+
+        return items;
+    }
+
+    /**
+     * Benchmark parsing data items with the default DataFile parser.
+     */
+    template<class T>
+    void parseItems(benchmark::State & state)
+    {
+        const auto & items = benchmarkItems();
+
+        for (auto _ : state) {
+            for (const auto item : items) {
+                T value{};
+                benchmark::DoNotOptimize(tryParseDataItem(item, value));
+                benchmark::DoNotOptimize(value);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(items.size()));
+    }
+
+    /**
+     * Benchmark parsing data items with std::from_chars() alone, for comparison.
+     */
+    template<class T>
+    void parseItemsFromChars(benchmark::State & state)
+    {
+        const auto & items = benchmarkItems();
+
+        for (auto _ : state) {
+            for (const auto item : items) {
+                T value{};
+                benchmark::DoNotOptimize(std::from_chars(item.data(), item.data() + item.size(), value));
+                benchmark::DoNotOptimize(value);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(items.size()));
+    }
+}
+
+BENCHMARK_TEMPLATE(parseItems, float);
+BENCHMARK_TEMPLATE(parseItems, double);
+BENCHMARK_TEMPLATE(parseItems, long double);
+BENCHMARK_TEMPLATE(parseItemsFromChars, float);
+BENCHMARK_TEMPLATE(parseItemsFromChars, double);
+BENCHMARK_TEMPLATE(parseItemsFromChars, long double);
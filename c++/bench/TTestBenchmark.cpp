@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "TTest.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Tests configured as the CLI configures them for each --storage type.
+     */
+    using FloatTest = TTest<float, NeumaierSum<double>>;
+    using DoubleTest = TTest<double, PairwiseSum<double>>;
+    using LongDoubleTest = TTest<long double>;
+
+    /**
+     * The environment variable that sets the largest number of rows to benchmark. Defaults to DefaultMaxRows.
+     */
+    constexpr const char * MaxRowsVariable = "TTEST_BENCHMARK_MAX_ROWS";
+
+    /**
+     * The largest number of rows benchmarked by default. The larger sizes take gigabytes of disk and memory, so they have to be asked for.
+     */
+    constexpr long DefaultMaxRows = 1'000'000;
+
+    /**
+     * A DataFile whose cached column summaries can be discarded, so that each iteration of a benchmark scans the data rather than reading the cache.
+     */
+    template<class TestClass>
+    class BenchmarkDataFile : public TestClass::DataFileType
+    {
+        public:
+            using TestClass::DataFileType::DataFileType;
+            using TestClass::DataFileType::invalidateSummaries;
+    };
+
+    /**
+     * Register the row counts to benchmark: powers of 10 from 1K up to the limit set in the environment, which may be at most 100M.
+     */
+    void rowCounts(benchmark::internal::Benchmark * benchmark)
+    {
+        auto maxRows = DefaultMaxRows;
+
+        if (const auto * variable = std::getenv(MaxRowsVariable)) {
+            maxRows = std::atol(variable);
+        }
+
+        for (long rows = 1'000; rows <= std::min(maxRows, 100'000'000L); rows *= 10) {
+            benchmark->Arg(rows);
+        }
+    }
+
+    /**
+     * Fetch the path to a CSV file with a given number of rows of two-column data, creating it if necessary.
+     *
+     * The second column is shifted slightly so that the tests have something to find. Files are created once per process and reused.
+     *
+     * @param rows The number of rows.
+     * @return The path.
+     */
+    std::string benchmarkCsv(long rows)
+    {
+        const auto path = (std::filesystem::temp_directory_path() / ("t-test-benchmark-" + std::to_string(rows) + ".csv")).string();
+        static std::vector<std::string> created;
+
+        if (std::find(created.cbegin(), created.cend(), path) == created.cend()) {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            std::mt19937_64 rng(static_cast<std::uint64_t>(rows));
+            std::normal_distribution<double> distribution(100.0, 15.0);
+            char buffer[64];
+
+            for (long row = 0; row < rows; ++row) {
+                const auto length = std::snprintf(buffer, sizeof(buffer), "%s%.3f,%.3f", (0 == row ? "" : "\n"), distribution(rng), distribution(rng) + 0.5);
+                out.write(buffer, length);
+            }
+
+            created.push_back(path);
+        }
+
+        return path;
+    }
+
+    /**
+     * Fetch loaded data for a test configuration and number of rows.
+     *
+     * Only the most recently requested data is kept, so that running the largest sizes doesn't hold a copy for every value type at once.
+     *
+     * @param rows The number of rows.
+     */
+    template<class TestClass>
+    std::shared_ptr<BenchmarkDataFile<TestClass>> benchmarkData(long rows)
+    {
+        static std::pair<std::type_index, long> key(typeid(void), 0);
+        static std::shared_ptr<void> data;
+
+        if (key != std::make_pair(std::type_index(typeid(TestClass)), rows)) {
+            data.reset();
+            data = std::make_shared<BenchmarkDataFile<TestClass>>(benchmarkCsv(rows), LoadOptions{LoadMode::Mapped, 0});
+            key = {typeid(TestClass), rows};
+        }
+
+        return std::static_pointer_cast<BenchmarkDataFile<TestClass>>(data);
+    }
+
+    /**
+     * Benchmark parsing a CSV file.
+     */
+    template<class TestClass>
+    void parse(benchmark::State & state)
+    {
+        const auto path = benchmarkCsv(state.range(0));
+
+        for (auto _ : state) {
+            typename TestClass::DataFileType data(path);
+            benchmark::DoNotOptimize(data.rowCount());
+        }
+
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(std::filesystem::file_size(path)));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    /**
+     * Benchmark summing a column.
+     */
+    template<class TestClass>
+    void columnSum(benchmark::State & state)
+    {
+        const auto data = benchmarkData<TestClass>(state.range(0));
+
+        for (auto _ : state) {
+            data->invalidateSummaries();
+            benchmark::DoNotOptimize(data->columnSum(0));
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(typename TestClass::ValueType)));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    /**
+     * Benchmark calculating all the aggregates for a column: the count, sum, sum of squares and extremes.
+     */
+    template<class TestClass>
+    void columnSummary(benchmark::State & state)
+    {
+        const auto data = benchmarkData<TestClass>(state.range(0));
+
+        for (auto _ : state) {
+            data->invalidateSummaries();
+            benchmark::DoNotOptimize(data->columnSummary(0));
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(typename TestClass::ValueType)));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    /**
+     * Benchmark calculating t from scratch.
+     */
+    template<class TestClass, TTestType type>
+    void t(benchmark::State & state)
+    {
+        const auto data = benchmarkData<TestClass>(state.range(0));
+        const TestClass test(data, type);
+
+        for (auto _ : state) {
+            data->invalidateSummaries();
+            benchmark::DoNotOptimize(test.t());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(2 * sizeof(typename TestClass::ValueType)));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(parse, FloatTest)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parse, DoubleTest)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parse, LongDoubleTest)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(columnSum, FloatTest)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(columnSum, DoubleTest)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(columnSum, LongDoubleTest)->Apply(rowCounts);
+
+BENCHMARK_TEMPLATE(columnSummary, FloatTest)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(columnSummary, DoubleTest)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(columnSummary, LongDoubleTest)->Apply(rowCounts);
+
+BENCHMARK_TEMPLATE(t, FloatTest, TTestType::Paired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, FloatTest, TTestType::Unpaired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, FloatTest, TTestType::Welch)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, DoubleTest, TTestType::Paired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, DoubleTest, TTestType::Unpaired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, DoubleTest, TTestType::Welch)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, LongDoubleTest, TTestType::Paired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, LongDoubleTest, TTestType::Unpaired)->Apply(rowCounts);
+BENCHMARK_TEMPLATE(t, LongDoubleTest, TTestType::Welch)->Apply(rowCounts);
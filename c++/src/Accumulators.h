@@ -0,0 +1,243 @@
+#ifndef STATISTICS_ACCUMULATORS_H
+#define STATISTICS_ACCUMULATORS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Statistics
+{
+    /**
+     * Accumulation policy that keeps a plain running sum.
+     *
+     * The fastest policy. DataFile and TTest use the vectorised kernels for it when the accumulator type is the same as the storage type. Rounding error
+     * grows with the number of values added.
+     *
+     * @tparam T The type to accumulate in.
+     */
+    template<class T>
+    class NaiveSum
+    {
+        public:
+            /**
+             * Alias for the type of the accumulated sum.
+             */
+            using ValueType = T;
+
+            /**
+             * The most values that may be reduced into one partial sum (see addPartial()). There is no limit, so a kernel sums the whole range at once.
+             */
+            static constexpr std::size_t PartialSize = static_cast<std::size_t>(-1);
+
+            /**
+             * Add a value to the sum.
+             */
+            inline void add(const ValueType & value)
+            {
+                m_sum += value;
+            }
+
+            /**
+             * Add the sum of a range of values, calculated elsewhere (e.g. by a vectorised kernel).
+             */
+            inline void addPartial(const ValueType & sum)
+            {
+                m_sum += sum;
+            }
+
+            /**
+             * The sum of the values added so far.
+             */
+            [[nodiscard]] inline ValueType value() const
+            {
+                return m_sum;
+            }
+
+        private:
+            /**
+             * The running sum.
+             */
+            ValueType m_sum = 0;
+    };
+
+    /**
+     * Accumulation policy using Neumaier's compensated summation.
+     *
+     * Neumaier's variant of Kahan summation tracks the low-order bits lost by each addition in a separate compensation term, including when the value added
+     * is larger than the running sum. The error is then independent of the number of values added, at the cost of a few extra operations per value.
+     *
+     * The compensation relies on strict IEEE evaluation order; it will silently degrade to a naive sum if compiled with -ffast-math or similar.
+     *
+     * @tparam T The type to accumulate in.
+     */
+    template<class T>
+    class NeumaierSum
+    {
+        public:
+            /**
+             * Alias for the type of the accumulated sum.
+             */
+            using ValueType = T;
+
+            /**
+             * Add a value to the sum.
+             */
+            inline void add(const ValueType & value)
+            {
+                const ValueType sum = m_sum + value;
+
+                if (std::abs(m_sum) >= std::abs(value)) {
+                    m_compensation += (m_sum - sum) + value;
+                } else {
+                    m_compensation += (value - sum) + m_sum;
+                }
+
+                m_sum = sum;
+            }
+
+            /**
+             * The sum of the values added so far.
+             */
+            [[nodiscard]] inline ValueType value() const
+            {
+                return m_sum + m_compensation;
+            }
+
+        private:
+            /**
+             * The running sum.
+             */
+            ValueType m_sum = 0;
+
+            /**
+             * The accumulated rounding error.
+             */
+            ValueType m_compensation = 0;
+    };
+
+    /**
+     * Accumulation policy using blocked pairwise summation.
+     *
+     * Values are summed naively in blocks of PartialSize, and the block sums are combined in a balanced binary tree: two sums are only ever added
+     * when they cover the same number of blocks. The rounding error grows with the block size plus the logarithm of the number of blocks, rather
+     * than with the number of values, at almost none of the cost of compensated summation. Unlike NeumaierSum it can use the vectorised kernels,
+     * which sum each block in several independent lanes, so for float and double storage it is both fast and accurate.
+     *
+     * @tparam T The type to accumulate in.
+     */
+    template<class T>
+    class PairwiseSum
+    {
+        public:
+            /**
+             * Alias for the type of the accumulated sum.
+             */
+            using ValueType = T;
+
+            /**
+             * The number of values summed naively before the block sum joins the tree. Also the most values a kernel reduces into one partial sum.
+             */
+            static constexpr std::size_t PartialSize = 1024;
+
+            /**
+             * Add a value to the sum.
+             */
+            inline void add(const ValueType & value)
+            {
+                m_block += value;
+
+                if (PartialSize == ++m_blockCount) {
+                    addPartial(m_block);
+                    m_block = 0;
+                    m_blockCount = 0;
+                }
+            }
+
+            /**
+             * Add the sum of a block of up to PartialSize values, calculated elsewhere (e.g. by a vectorised kernel).
+             */
+            inline void addPartial(ValueType sum)
+            {
+                // the tree is a binary counter of blocks: each set bit of m_partials has a sum of that power of two of blocks, and adding a block
+                // carries through the levels that are already full
+                std::size_t level = 0;
+
+                for (auto partials = m_partials; partials & 1U; partials >>= 1U, ++level) {
+                    sum = m_levels[level] + sum;
+                }
+
+                m_levels[level] = sum;
+                ++m_partials;
+            }
+
+            /**
+             * The sum of the values added so far.
+             */
+            [[nodiscard]] inline ValueType value() const
+            {
+                auto sum = m_block;
+                std::size_t level = 0;
+
+                // smallest sums first
+                for (auto partials = m_partials; 0 != partials; partials >>= 1U, ++level) {
+                    if (partials & 1U) {
+                        sum += m_levels[level];
+                    }
+                }
+
+                return sum;
+            }
+
+        private:
+            /**
+             * The sum of each full level of the tree. Level n holds the sum of 2^n blocks.
+             */
+            std::array<ValueType, 64> m_levels{};
+
+            /**
+             * The number of blocks added to the tree.
+             */
+            std::uint64_t m_partials = 0;
+
+            /**
+             * The naive sum of the block being filled by add().
+             */
+            ValueType m_block = 0;
+
+            /**
+             * The number of values in the block being filled by add().
+             */
+            std::size_t m_blockCount = 0;
+    };
+
+    /**
+     * Whether an accumulation policy for a given storage type can use the vectorised kernels.
+     *
+     * The kernels accumulate in the storage type, so they stand in for NaiveSum<T> and PairwiseSum<T> over T. Each kernel call reduces at most the
+     * accumulator's PartialSize values, and its result is added with addPartial() (see forEachPartial()).
+     */
+    template<class T, class Accumulator>
+    constexpr bool AccumulatesWithKernels = std::is_same_v<Accumulator, NaiveSum<T>> || std::is_same_v<Accumulator, PairwiseSum<T>>;
+
+    /**
+     * Split a range of values into the partial sums that an accumulator takes from a kernel.
+     *
+     * @tparam Accumulator The accumulation policy. Must have a PartialSize.
+     * @param count The number of values in the range.
+     * @param callback Called with the offset and size of each part, in order.
+     */
+    template<class Accumulator, class Callback>
+    void forEachPartial(std::size_t count, Callback && callback)
+    {
+        for (std::size_t offset = 0; offset < count;) {
+            const auto size = std::min(Accumulator::PartialSize, count - offset);
+            callback(offset, size);
+            offset += size;
+        }
+    }
+}
+
+#endif
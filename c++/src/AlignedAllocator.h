@@ -0,0 +1,96 @@
+#ifndef STATISTICS_ALIGNEDALLOCATOR_H
+#define STATISTICS_ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace Statistics
+{
+    /**
+     * Allocator that hands out storage aligned to a fixed boundary.
+     *
+     * Used for the column buffers in DataFile so that each column starts on a cache-line boundary, which keeps linear scans and vector loads from straddling
+     * lines.
+     *
+     * @tparam T The type of object to allocate.
+     * @tparam alignment The alignment, in bytes. Must be a power of two and at least alignof(T). Defaults to 64, the cache-line size on most current CPUs.
+     */
+    template<class T, std::size_t alignment = 64>
+    class AlignedAllocator
+    {
+        public:
+            static_assert(0 == (alignment & (alignment - 1)), "AlignedAllocator alignment must be a power of two.");
+            static_assert(alignment >= alignof(T), "AlignedAllocator alignment must be at least the natural alignment of the allocated type.");
+
+            /**
+             * Alias for the type of object allocated.
+             */
+            using value_type = T;
+
+            /**
+             * The same allocator for a different type of object.
+             */
+            template<class U>
+            struct rebind
+            {
+                using other = AlignedAllocator<U, alignment>;
+            };
+
+            /**
+             * Initialise a new allocator.
+             */
+            AlignedAllocator() noexcept = default;
+
+            /**
+             * Initialise a new allocator from one for another type.
+             *
+             * The allocator is stateless so there is nothing to copy.
+             */
+            template<class U>
+            AlignedAllocator(const AlignedAllocator<U, alignment> &) noexcept
+            {}
+
+            /**
+             * Allocate aligned storage for a number of objects.
+             *
+             * @param count The number of objects.
+             * @return A pointer to the uninitialised storage.
+             * @throws std::bad_array_new_length if the requested size overflows.
+             * @throws std::bad_alloc if the storage cannot be allocated.
+             */
+            [[nodiscard]] T * allocate(std::size_t count)
+            {
+                if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                    throw std::bad_array_new_length();
+                }
+
+                return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(alignment)));
+            }
+
+            /**
+             * Release storage obtained from allocate().
+             *
+             * @param ptr The storage to release.
+             */
+            void deallocate(T * ptr, std::size_t) noexcept
+            {
+                ::operator delete(ptr, std::align_val_t(alignment));
+            }
+    };
+
+    template<class T, class U, std::size_t alignment>
+    constexpr bool operator==(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &) noexcept
+    {
+        return true;
+    }
+
+    template<class T, class U, std::size_t alignment>
+    constexpr bool operator!=(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef STATISTICS_BATCHTTEST_H
+#define STATISTICS_BATCHTTEST_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "TTest.h"
+#include "Parallel.h"
+
+namespace Statistics
+{
+    /**
+     * Runs t-tests over many pairs of columns of a single DataFile.
+     *
+     * For unpaired tests the per-column aggregates (count, mean and sum of squared deviations) are calculated once for each column involved and shared
+     * by every pair that uses the column, so testing all pairs of k columns reads the data k times rather than k(k - 1) times. Paired tests depend on the
+     * row-wise differences, so each pair needs its own pass over its two columns.
+     *
+     * Work is spread across threads with parallelFor(). Results are always returned in the order in which the pairs were given.
+     *
+     * @tparam T The underlying data type for the values to be tested. See TTest.
+     * @tparam Accumulator The policy used to accumulate sums. See TTest.
+     */
+    template<class T = long double, class Accumulator = NaiveSum<T>>
+    class BatchTTest
+    {
+        public:
+            /**
+             * Alias for the single-pair test type whose calculations the batch shares.
+             */
+            using TestType = TTest<T, Accumulator>;
+
+            /**
+             * Alias for the type in which each statistic is calculated.
+             */
+            using ResultType = typename TestType::ResultType;
+
+            /**
+             * Alias for the type of DataFile the tests run on.
+             */
+            using DataFileType = typename TestType::DataFileType;
+
+            /**
+             * Alias for the shared pointer to the DataFile.
+             */
+            using DataFilePtr = typename TestType::DataFilePtr;
+
+            /**
+             * Alias for the type of column indices.
+             */
+            using IndexType = typename DataFileType::IndexType;
+
+            /**
+             * A pair of columns to test against each other.
+             */
+            struct ColumnPair
+            {
+                IndexType first;
+                IndexType second;
+            };
+
+            /**
+             * The outcome of the test for one pair of columns.
+             */
+            struct Result
+            {
+                IndexType first;
+                IndexType second;
+                ResultType t;
+                ResultType degreesOfFreedom;
+                ResultType oneTailedP;
+                ResultType twoTailedP;
+            };
+
+            /**
+             * Initialise a new batch of t-tests.
+             *
+             * @param data The data to process. Shared with the caller.
+             * @param type The type of test to run on each pair.
+             */
+            explicit BatchTTest(DataFilePtr data, const TTestType & type = TestType::DefaultTestType)
+            :   m_data(std::move(data)),
+                m_type(type)
+            {}
+
+            /**
+             * Initialise a new batch of t-tests.
+             *
+             * @param data The data to process. Moved into the batch.
+             * @param type The type of test to run on each pair.
+             */
+            explicit BatchTTest(DataFileType && data, const TTestType & type = TestType::DefaultTestType)
+            :   BatchTTest(std::make_shared<DataFileType>(std::move(data)), type)
+            {}
+
+            /**
+             * Generate every unordered pair of distinct columns, in row-major order: (0, 1), (0, 2), ..., (1, 2), ...
+             *
+             * @param columnCount The number of columns.
+             */
+            [[nodiscard]] static std::vector<ColumnPair> allPairs(const IndexType & columnCount)
+            {
+                std::vector<ColumnPair> pairs;
+
+                if (1 < columnCount) {
+                    pairs.reserve(static_cast<std::size_t>(columnCount * (columnCount - 1) / 2));
+                }
+
+                for (IndexType first = 0; first < columnCount; ++first) {
+                    for (auto second = first + 1; second < columnCount; ++second) {
+                        pairs.push_back({first, second});
+                    }
+                }
+
+                return pairs;
+            }
+
+            /**
+             * Generate a pair for every column against a control column.
+             *
+             * The control is the first column in each pair; it is not paired with itself.
+             *
+             * @param columnCount The number of columns.
+             * @param control The index of the control column.
+             */
+            [[nodiscard]] static std::vector<ColumnPair> allVersusControl(const IndexType & columnCount, const IndexType & control)
+            {
+                std::vector<ColumnPair> pairs;
+
+                for (IndexType col = 0; col < columnCount; ++col) {
+                    if (col != control) {
+                        pairs.push_back({control, col});
+                    }
+                }
+
+                return pairs;
+            }
+
+            /**
+             * Fetch a reference to the data.
+             */
+            [[nodiscard]] inline const DataFileType & data() const
+            {
+                return *m_data;
+            }
+
+            /**
+             * Fetch the type of test.
+             */
+            [[nodiscard]] inline TTestType type() const
+            {
+                return m_type;
+            }
+
+            /**
+             * Set the type of test.
+             */
+            inline void setType(const TTestType & type)
+            {
+                m_type = type;
+            }
+
+            /**
+             * Calculate t for each of a set of column pairs.
+             *
+             * @param pairs The pairs of columns to test.
+             * @param threads The maximum number of threads to use. 0 means defaultThreadCount().
+             * @return The results, one per pair, in the same order as the pairs.
+             * @throws std::invalid_argument if any pair refers to a column that is not in the data.
+             */
+            [[nodiscard]] std::vector<Result> run(const std::vector<ColumnPair> & pairs, unsigned int threads = 1) const
+            {
+                std::vector<Result> results(pairs.size());
+
+                if (TTestType::Paired == m_type) {
+                    parallelFor(threads, pairs.size(), [this, &pairs, &results](std::size_t idx) {
+                        const auto & pair = pairs[idx];
+                        results[idx] = makeResult(pair, TestType::pairedStatistic(*m_data, pair.first, pair.second));
+                    });
+
+                    return results;
+                }
+
+                // find the distinct columns involved, calculate their aggregates once, then combine them for each pair
+                std::vector<IndexType> columns;
+                columns.reserve(pairs.size() * 2);
+
+                for (const auto & pair : pairs) {
+                    columns.push_back(pair.first);
+                    columns.push_back(pair.second);
+                }
+
+                std::sort(columns.begin(), columns.end());
+                columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+                std::vector<typename TestType::ColumnAggregates> aggregates(columns.size());
+
+                parallelFor(threads, columns.size(), [this, &columns, &aggregates](std::size_t idx) {
+                    aggregates[idx] = TestType::columnAggregates(*m_data, columns[idx]);
+                });
+
+                const auto aggregatesFor = [&columns, &aggregates](const IndexType & col) -> const typename TestType::ColumnAggregates & {
+                    return aggregates[static_cast<std::size_t>(std::lower_bound(columns.cbegin(), columns.cend(), col) - columns.cbegin())];
+                };
+
+                for (std::size_t idx = 0; idx < pairs.size(); ++idx) {
+                    const auto & pair = pairs[idx];
+                    results[idx] = makeResult(pair, TestType::unpairedStatistic(m_type, aggregatesFor(pair.first), aggregatesFor(pair.second)));
+                }
+
+                return results;
+            }
+
+        private:
+            /**
+             * Helper to complete the result for a pair from its statistic.
+             */
+            static Result makeResult(const ColumnPair & pair, const typename TestType::Statistic & statistic)
+            {
+                const auto result = TTestResult<ResultType>::fromStatistic(statistic.t, statistic.degreesOfFreedom);
+                return {pair.first, pair.second, result.t, result.degreesOfFreedom, result.oneTailedP, result.twoTailedP};
+            }
+
+            /**
+             * The data.
+             */
+            DataFilePtr m_data;
+
+            /**
+             * The type of test.
+             */
+            TTestType m_type;
+    };
+}
+
+#endif
@@ -0,0 +1,493 @@
+#ifndef STATISTICS_BOOTSTRAP_H
+#define STATISTICS_BOOTSTRAP_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "TTest.h"
+#include "Distributions.h"
+#include "Parallel.h"
+#include "Random.h"
+
+namespace Statistics
+{
+    /**
+     * Options controlling a bootstrap.
+     */
+    struct BootstrapOptions
+    {
+        /**
+         * The number of bootstrap replicates.
+         */
+        std::uint64_t replicates = 10000;
+
+        /**
+         * The confidence level of the intervals, in (0, 1).
+         */
+        double confidence = 0.95;
+
+        /**
+         * The seed for the resampling. The same seed always gives the same result, whatever the thread count.
+         */
+        std::uint64_t seed = 0;
+
+        /**
+         * The number of threads to use. 0 means one per hardware thread.
+         */
+        unsigned int threads = 1;
+    };
+
+    /**
+     * A confidence interval.
+     *
+     * @tparam T The type of the bounds.
+     */
+    template<class T>
+    struct ConfidenceInterval
+    {
+        T lower;
+        T upper;
+    };
+
+    /**
+     * The outcome of a bootstrap of the difference between two means.
+     *
+     * @tparam T The type of the values.
+     */
+    template<class T>
+    struct BootstrapResult
+    {
+        /**
+         * The observed difference: the mean of the first column less the mean of the second (for paired data, the mean of the row-wise differences).
+         */
+        T meanDifference;
+
+        /**
+         * The standard deviation of the replicates, which estimates the standard error of the difference.
+         */
+        T standardError;
+
+        /**
+         * The mean of the replicates less the observed difference.
+         */
+        T bias;
+
+        /**
+         * The percentile interval: the quantiles of the replicates at (1 - confidence) / 2 and (1 + confidence) / 2.
+         */
+        ConfidenceInterval<T> percentile;
+
+        /**
+         * The bias-corrected and accelerated (BCa) interval.
+         */
+        ConfidenceInterval<T> bca;
+
+        /**
+         * The number of replicates.
+         */
+        std::uint64_t replicates;
+    };
+
+    /**
+     * Bootstrap confidence intervals for the difference between the means of two columns of a DataFile.
+     *
+     * The values are copied once out of the DataFile into flat buffers. Each replicate draws its resample's indices from a Philox4x32 counter-based
+     * generator and adds up the values at those indices as it goes, so no resampled data is ever stored - only one number per replicate. Replicate r
+     * always uses the random values for counter (r, group), so replicates can be computed in any order on any number of threads and the result depends
+     * only on the seed. Replicates are spread over threads with parallelFor().
+     *
+     * For paired tests the row-wise differences are resampled; for unpaired tests (of any type - the resampling is the same) each column is
+     * resampled independently, keeping its own size.
+     *
+     * @tparam T The underlying data type for the values. See TTest.
+     * @tparam Accumulator The policy used to accumulate sums. See TTest.
+     */
+    template<class T = long double, class Accumulator = NaiveSum<T>>
+    class MeanDifferenceBootstrap
+    {
+        public:
+            /**
+             * Alias for the single test type whose data types the bootstrap shares.
+             */
+            using TestType = TTest<T, Accumulator>;
+
+            /**
+             * Alias for the type in which the statistics are calculated.
+             */
+            using ResultType = typename TestType::ResultType;
+
+            /**
+             * Alias for the type of DataFile the bootstrap runs on.
+             */
+            using DataFileType = typename TestType::DataFileType;
+
+            /**
+             * Alias for the shared pointer to the DataFile.
+             */
+            using DataFilePtr = typename TestType::DataFilePtr;
+
+            /**
+             * Alias for the type of column indices.
+             */
+            using IndexType = typename DataFileType::IndexType;
+
+            /**
+             * Alias for the result type.
+             */
+            using Result = BootstrapResult<ResultType>;
+
+            /**
+             * The number of replicates in each unit of parallel work.
+             */
+            static constexpr std::uint64_t BlockSize = 64;
+
+            /**
+             * Initialise a new bootstrap.
+             *
+             * @param data The data to process. Shared with the caller.
+             * @param type The type of test; determines whether the columns are resampled as pairs.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit MeanDifferenceBootstrap(DataFilePtr data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   m_data(std::move(data)),
+                m_type(type),
+                m_first(first),
+                m_second(second)
+            {}
+
+            /**
+             * Initialise a new bootstrap.
+             *
+             * @param data The data to process. Moved into the bootstrap.
+             * @param type The type of test; determines whether the columns are resampled as pairs.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit MeanDifferenceBootstrap(DataFileType && data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   MeanDifferenceBootstrap(std::make_shared<DataFileType>(std::move(data)), type, first, second)
+            {}
+
+            /**
+             * Fetch the type of test.
+             */
+            [[nodiscard]] inline TTestType type() const
+            {
+                return m_type;
+            }
+
+            /**
+             * Set the type of test.
+             */
+            inline void setType(const TTestType & type)
+            {
+                m_type = type;
+            }
+
+            /**
+             * Run the bootstrap.
+             *
+             * If either column has fewer than two values (or, for paired tests, there are fewer than two complete pairs), or no replicates are requested,
+             * the intervals can't be calculated and all the statistics except the observed difference are NaN.
+             *
+             * @param options The options for the bootstrap.
+             * @return The outcome.
+             * @throws std::invalid_argument if either column is not in the data.
+             */
+            [[nodiscard]] Result run(const BootstrapOptions & options = {}) const
+            {
+                const auto groups = (TTestType::Paired == m_type ? pairedGroups() : unpairedGroups());
+                const auto observed = groups[0].mean - groups[1].mean;
+                const auto confidence = static_cast<ResultType>(options.confidence);
+
+                if (!isValid(groups) || 0 == options.replicates || !(0 < confidence && 1 > confidence)) {
+                    return {observed, NAN, NAN, {NAN, NAN}, {NAN, NAN}, options.replicates};
+                }
+
+                std::vector<ResultType> replicates(options.replicates);
+                const auto blocks = (options.replicates + BlockSize - 1) / BlockSize;
+
+                parallelFor(options.threads, blocks, [&groups, &replicates, &options](std::size_t block) {
+                    const auto end = std::min<std::uint64_t>(options.replicates, (block + 1) * BlockSize);
+
+                    for (auto replicate = block * BlockSize; replicate < end; ++replicate) {
+                        replicates[replicate] = resampledMean(groups[0], options.seed, replicate, 0)
+                            - (groups[1].values.empty() ? 0 : resampledMean(groups[1], options.seed, replicate, 1));
+                    }
+                });
+
+                Result result{observed, 0, 0, {}, {}, options.replicates};
+                ResultType mean = 0;
+                std::uint64_t below = 0;
+                std::uint64_t equal = 0;
+
+                for (const auto & replicate : replicates) {
+                    mean += replicate;
+                    below += (replicate < observed);
+                    equal += (replicate == observed);
+                }
+
+                mean /= static_cast<ResultType>(replicates.size());
+                ResultType sumSquaredDeviations = 0;
+
+                for (const auto & replicate : replicates) {
+                    sumSquaredDeviations += (replicate - mean) * (replicate - mean);
+                }
+
+                result.bias = mean - observed;
+                result.standardError = (1 < replicates.size() ? std::sqrt(sumSquaredDeviations / static_cast<ResultType>(replicates.size() - 1)) : NAN);
+                std::sort(replicates.begin(), replicates.end());
+                const auto alpha = (1 - confidence) / 2;
+                result.percentile = {quantile(replicates, alpha), quantile(replicates, 1 - alpha)};
+
+                // BCa: the bias correction z0 comes from the proportion of replicates below the observed value (ties count half), the acceleration
+                // from the skewness of the jackknife values
+                const auto z0 = standardNormalQuantile((static_cast<ResultType>(below) + static_cast<ResultType>(equal) / 2) / static_cast<ResultType>(replicates.size()));
+                const auto acceleration = jackknifeAcceleration(groups);
+
+                const auto adjusted = [z0, acceleration](const ResultType & probability) {
+                    const auto z = z0 + standardNormalQuantile(probability);
+                    return standardNormalCdf(z0 + z / (1 - acceleration * z));
+                };
+
+                if (std::isfinite(z0)) {
+                    result.bca = {quantile(replicates, adjusted(alpha)), quantile(replicates, adjusted(1 - alpha))};
+                } else {
+                    // every replicate is on one side of the observed value, so the bias correction is unbounded
+                    result.bca = {NAN, NAN};
+                }
+
+                return result;
+            }
+
+        private:
+            /**
+             * The values resampled for one condition (or, for paired tests, the differences).
+             */
+            struct Group
+            {
+                /**
+                 * The values.
+                 */
+                std::vector<ResultType> values;
+
+                /**
+                 * The mean of the values.
+                 */
+                ResultType mean = 0;
+            };
+
+            /**
+             * The two groups. For paired tests the second is empty, with mean 0.
+             */
+            using Groups = std::array<Group, 2>;
+
+            /**
+             * Helper to fill in the mean of a group.
+             */
+            static void calculateMean(Group & group)
+            {
+                if (group.values.empty()) {
+                    return;
+                }
+
+                Accumulator sum;
+
+                for (const auto & value : group.values) {
+                    sum.add(static_cast<typename Accumulator::ValueType>(value));
+                }
+
+                group.mean = static_cast<ResultType>(sum.value()) / static_cast<ResultType>(group.values.size());
+            }
+
+            /**
+             * Helper to extract the differences for a paired bootstrap.
+             */
+            Groups pairedGroups() const
+            {
+                const auto & first = m_data->column(m_first);
+                const auto & second = m_data->column(m_second);
+                Groups groups;
+                groups[0].values.reserve(first.size());
+
+                for (std::size_t row = 0; row < std::min(first.size(), second.size()); ++row) {
+                    if (first.isValid(row) && second.isValid(row)) {
+                        groups[0].values.push_back(static_cast<ResultType>(first[row]) - static_cast<ResultType>(second[row]));
+                    }
+                }
+
+                calculateMean(groups[0]);
+                return groups;
+            }
+
+            /**
+             * Helper to extract the values of each column for an unpaired bootstrap.
+             */
+            Groups unpairedGroups() const
+            {
+                Groups groups;
+                const IndexType columns[] = {m_first, m_second};
+
+                for (std::size_t idx = 0; idx < 2; ++idx) {
+                    const auto & column = m_data->column(columns[idx]);
+                    groups[idx].values.reserve(column.size());
+
+                    for (std::size_t row = 0; row < column.size(); ++row) {
+                        if (column.isValid(row)) {
+                            groups[idx].values.push_back(static_cast<ResultType>(column[row]));
+                        }
+                    }
+
+                    calculateMean(groups[idx]);
+                }
+
+                return groups;
+            }
+
+            /**
+             * Whether there are enough values to bootstrap.
+             */
+            bool isValid(const Groups & groups) const
+            {
+                return 2 <= groups[0].values.size() && (TTestType::Paired == m_type || 2 <= groups[1].values.size());
+            }
+
+            /**
+             * Calculate the mean of one group's resample for one replicate.
+             *
+             * Indices are generated a batch at a time with the vectorised Philox4x32::indices() so that the generator's arithmetic isn't interleaved
+             * with the scattered loads, which then overlap with each other.
+             *
+             * @param group The group to resample.
+             * @param seed The seed.
+             * @param replicate The replicate number.
+             * @param groupIndex The index of the group, which selects its random values.
+             */
+            static ResultType resampledMean(const Group & group, std::uint64_t seed, std::uint64_t replicate, std::uint32_t groupIndex)
+            {
+                static constexpr std::size_t IndexBatch = 256;
+                const auto & values = group.values;
+                const auto n = static_cast<std::uint64_t>(values.size());
+                const Philox4x32::Key key = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+                Philox4x32::Counter counter = {0, groupIndex, static_cast<std::uint32_t>(replicate), static_cast<std::uint32_t>(replicate >> 32)};
+                Accumulator sum;
+
+                if (n > std::numeric_limits<std::uint32_t>::max()) {
+                    // too many values for 32-bit indices: same mapping from random bits to index, done in 64 bits
+                    for (std::uint64_t drawn = 0; drawn < n; drawn += 2) {
+                        const auto random = Philox4x32::block(counter, key);
+                        ++counter[0];
+                        sum.add(static_cast<typename Accumulator::ValueType>(values[scaleToIndex(random[0], random[1], n)]));
+
+                        if (drawn + 1 < n) {
+                            sum.add(static_cast<typename Accumulator::ValueType>(values[scaleToIndex(random[2], random[3], n)]));
+                        }
+                    }
+                } else {
+                    std::uint32_t indices[IndexBatch];
+
+                    for (std::uint64_t drawn = 0; drawn < n; drawn += IndexBatch) {
+                        const auto batch = static_cast<std::size_t>(std::min<std::uint64_t>(IndexBatch, n - drawn));
+                        Philox4x32::indices(counter, key, static_cast<std::uint32_t>(n), indices, (batch + 1) & ~std::size_t{1});
+                        counter[0] += static_cast<std::uint32_t>(IndexBatch / 2);
+
+                        for (std::size_t idx = 0; idx < batch; ++idx) {
+                            sum.add(static_cast<typename Accumulator::ValueType>(values[indices[idx]]));
+                        }
+                    }
+                }
+
+                return static_cast<ResultType>(sum.value()) / static_cast<ResultType>(n);
+            }
+
+            /**
+             * Map 64 random bits, given as two halves, to an index in [0, n), as Philox4x32::indices() does.
+             */
+            static inline std::size_t scaleToIndex(std::uint32_t high, std::uint32_t low, std::uint64_t n)
+            {
+                const auto random = static_cast<std::uint64_t>(high) << 32 | low;
+#if defined(__SIZEOF_INT128__)
+                return static_cast<std::size_t>((static_cast<unsigned __int128>(random) * n) >> 64);
+#else
+                return static_cast<std::size_t>(static_cast<long double>(random) / 18446744073709551616.0L * static_cast<long double>(n));
+#endif
+            }
+
+            /**
+             * Calculate the BCa acceleration from the jackknife.
+             *
+             * Leaving out value i of a group of size n with mean m moves that group's mean by (m - x_i) / (n - 1), so every jackknife value is available in
+             * closed form from a single pass. Values left out of the second group move the difference the other way.
+             */
+            static ResultType jackknifeAcceleration(const Groups & groups)
+            {
+                ResultType sumSquares = 0;
+                ResultType sumCubes = 0;
+
+                for (std::size_t idx = 0; idx < 2; ++idx) {
+                    const auto & group = groups[idx];
+
+                    if (group.values.empty()) {
+                        continue;
+                    }
+
+                    const auto scale = (0 == idx ? 1 : -1) / static_cast<ResultType>(group.values.size() - 1);
+
+                    for (const auto & value : group.values) {
+                        // the jackknife values average to the observed difference, so this is their mean less value i's jackknife value
+                        const auto deviation = (value - group.mean) * scale;
+                        sumSquares += deviation * deviation;
+                        sumCubes += deviation * deviation * deviation;
+                    }
+                }
+
+                return 0 == sumSquares ? 0 : sumCubes / (6 * std::pow(sumSquares, static_cast<ResultType>(1.5)));
+            }
+
+            /**
+             * Calculate a quantile of sorted values, interpolating linearly between order statistics.
+             */
+            static ResultType quantile(const std::vector<ResultType> & sorted, const ResultType & probability)
+            {
+                if (std::isnan(probability)) {
+                    return NAN;
+                }
+
+                const auto position = std::clamp(probability, ResultType(0), ResultType(1)) * static_cast<ResultType>(sorted.size() - 1);
+                const auto lower = static_cast<std::size_t>(position);
+
+                if (lower + 1 >= sorted.size()) {
+                    return sorted.back();
+                }
+
+                const auto fraction = position - static_cast<ResultType>(lower);
+                return sorted[lower] + fraction * (sorted[lower + 1] - sorted[lower]);
+            }
+
+            /**
+             * The data.
+             */
+            DataFilePtr m_data;
+
+            /**
+             * The type of test.
+             */
+            TTestType m_type;
+
+            /**
+             * The column for the first condition.
+             */
+            IndexType m_first;
+
+            /**
+             * The column for the second condition.
+             */
+            IndexType m_second;
+    };
+}
+
+#endif
@@ -0,0 +1,468 @@
+#ifndef STATISTICS_CACHEFILE_H
+#define STATISTICS_CACHEFILE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace Statistics
+{
+    /**
+     * Identifies the version of a source file that a cache was built from.
+     *
+     * A cache is fresh only while its source has the same size and modification time as when the cache was built. A source rewritten within the
+     * filesystem's timestamp resolution without changing size would go unnoticed, which is the usual trade-off for not hashing the content.
+     */
+    struct SourceStamp
+    {
+        /**
+         * The size of the source file in bytes.
+         */
+        std::uint64_t size = 0;
+
+        /**
+         * The modification time of the source file, in the filesystem clock's ticks.
+         */
+        std::int64_t modified = 0;
+
+        /**
+         * Fetch the stamp of a file.
+         *
+         * @param path The path to the file.
+         * @return The stamp, or nothing if the file is not a regular file or can't be examined.
+         */
+        static std::optional<SourceStamp> of(const std::string & path)
+        {
+            std::error_code error;
+
+            if (!std::filesystem::is_regular_file(path, error)) {
+                return {};
+            }
+
+            const auto size = std::filesystem::file_size(path, error);
+
+            if (error) {
+                return {};
+            }
+
+            const auto modified = std::filesystem::last_write_time(path, error);
+
+            if (error) {
+                return {};
+            }
+
+            return SourceStamp{static_cast<std::uint64_t>(size), static_cast<std::int64_t>(modified.time_since_epoch().count())};
+        }
+
+        bool operator==(const SourceStamp & other) const
+        {
+            return size == other.size && modified == other.modified;
+        }
+
+        bool operator!=(const SourceStamp & other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Layout of the binary column cache that a DataFile can write alongside its CSV source.
+     *
+     * A cache file is a Header, followed by a ColumnEntry for each column, followed by each column's value block and validity bitmap. Every block starts
+     * on an Alignment boundary, so once the file is memory-mapped the blocks can be used in place as column buffers without being copied or parsed.
+     * Values and bitmaps are stored exactly as they are held in a Column, in the byte order of the machine that wrote them; a cache written on a machine
+     * with a different byte order, or for a different value type, is simply treated as stale.
+     */
+    namespace Cache
+    {
+        /**
+         * The bytes that start every cache file.
+         */
+        constexpr char Magic[8] = {'T', 'T', 'E', 'S', 'T', 'C', 'O', 'L'};
+
+        /**
+         * The version of the layout. Bump this whenever the layout changes so that old caches are rebuilt.
+         */
+        constexpr std::uint32_t Version = 2;
+
+        /**
+         * Written as-is so that a reader can detect a cache with the wrong byte order.
+         */
+        constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+        /**
+         * The alignment of each block in the file, in bytes. Matches Column::Alignment.
+         */
+        constexpr std::uint64_t Alignment = 64;
+
+        /**
+         * The extension appended to the source path (along with the value type) to make the default cache path.
+         */
+        constexpr const char * Extension = ".ttcache";
+
+        /**
+         * The fixed-size header at the start of a cache file.
+         */
+        struct Header
+        {
+            /**
+             * Must match Magic.
+             */
+            char magic[8];
+
+            /**
+             * Must match Version.
+             */
+            std::uint32_t version;
+
+            /**
+             * Must match ByteOrderMark.
+             */
+            std::uint32_t byteOrder;
+
+            /**
+             * Identifies the type of the values. See valueTypeTag().
+             */
+            std::uint32_t valueType;
+
+            /**
+             * The alignment of the blocks. Must match Alignment.
+             */
+            std::uint32_t alignment;
+
+            /**
+             * The size of the source file the cache was built from.
+             */
+            std::uint64_t sourceSize;
+
+            /**
+             * The modification time of the source file the cache was built from.
+             */
+            std::int64_t sourceModified;
+
+            /**
+             * The number of rows. Every column has this many cells.
+             */
+            std::uint64_t rowCount;
+
+            /**
+             * The number of columns, and of ColumnEntry records following the header.
+             */
+            std::uint64_t columnCount;
+
+            /**
+             * The offset in the source of the start of its final line, so that the data can still be refreshed when the source grows.
+             */
+            std::uint64_t lastLineOffset;
+
+            /**
+             * The number of columns there were before the final row.
+             */
+            std::uint64_t widthBeforeLastRow;
+
+            /**
+             * 1 if the first line of the source was read as a header rather than as data, 0 otherwise.
+             */
+            std::uint64_t headerLine;
+
+            /**
+             * The hash of the columns that the schema made Text. See textColumnsHash().
+             */
+            std::uint64_t textColumns;
+        };
+
+        /**
+         * Where one column's blocks are in the cache file.
+         */
+        struct ColumnEntry
+        {
+            /**
+             * The offset of the value block. It holds rowCount values.
+             */
+            std::uint64_t valuesOffset;
+
+            /**
+             * The offset of the validity bitmap. It holds one 64-bit word for every 64 rows (rounded up).
+             */
+            std::uint64_t validityOffset;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<ColumnEntry>, "Cache records must be trivially copyable.");
+
+        /**
+         * Round an offset up to the next block boundary.
+         */
+        constexpr std::uint64_t align(std::uint64_t offset)
+        {
+            return (offset + Alignment - 1) / Alignment * Alignment;
+        }
+
+        /**
+         * The offset of the first ColumnEntry.
+         */
+        constexpr std::uint64_t DirectoryOffset = align(sizeof(Header));
+
+        /**
+         * Where each block of a cache file goes, for given dimensions and value type.
+         *
+         * Blocks are laid out in column order: column 0's values, column 0's validity bitmap, column 1's values and so on, each on an Alignment
+         * boundary. Every column has the same number of cells, so the layout can be calculated before any data is written, and a writer can fill the
+         * blocks in any order.
+         */
+        struct Layout
+        {
+            /**
+             * Calculate the layout.
+             *
+             * @param rows The number of rows.
+             * @param columns The number of columns.
+             * @param valueSize The size of each value in bytes.
+             */
+            Layout(std::uint64_t rows, std::uint64_t columns, std::uint64_t valueSize)
+            :   rowCount(rows),
+                columnCount(columns),
+                valueBytes(rows * valueSize),
+                validityBytes((rows + 63) / 64 * sizeof(std::uint64_t)),
+                firstBlockOffset(align(DirectoryOffset + columns * sizeof(ColumnEntry))),
+                columnStride(align(align(valueBytes) + validityBytes))
+            {}
+
+            /**
+             * The directory entry for a column.
+             */
+            [[nodiscard]] ColumnEntry entry(std::uint64_t col) const
+            {
+                const auto valuesOffset = firstBlockOffset + col * columnStride;
+                return {valuesOffset, valuesOffset + align(valueBytes)};
+            }
+
+            /**
+             * The size of the whole cache file.
+             */
+            [[nodiscard]] std::uint64_t fileSize() const
+            {
+                return 0 == columnCount ? firstBlockOffset : entry(columnCount - 1).validityOffset + validityBytes;
+            }
+
+            /**
+             * The number of rows.
+             */
+            std::uint64_t rowCount;
+
+            /**
+             * The number of columns.
+             */
+            std::uint64_t columnCount;
+
+            /**
+             * The size of each column's value block.
+             */
+            std::uint64_t valueBytes;
+
+            /**
+             * The size of each column's validity bitmap.
+             */
+            std::uint64_t validityBytes;
+
+            /**
+             * The offset of the first column's value block.
+             */
+            std::uint64_t firstBlockOffset;
+
+            /**
+             * The distance between the value blocks of successive columns.
+             */
+            std::uint64_t columnStride;
+        };
+
+        /**
+         * Identify a value type by its size, kind and precision.
+         *
+         * @tparam T The value type.
+         */
+        template<class T>
+        constexpr std::uint32_t valueTypeTag()
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic value types can be cached.");
+            return static_cast<std::uint32_t>(sizeof(T))
+                | (std::is_floating_point_v<T> ? 0x100U : 0U)
+                | (std::is_signed_v<T> ? 0x200U : 0U)
+                | (static_cast<std::uint32_t>(std::numeric_limits<T>::digits) << 16);
+        }
+
+        /**
+         * Hash a string of bytes with FNV-1a.
+         */
+        inline std::uint64_t hash(std::string_view bytes)
+        {
+            std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+            for (const auto ch : bytes) {
+                hash = (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3ULL;
+            }
+
+            return hash;
+        }
+
+        /**
+         * Hash the columns of the data that the schema makes Text.
+         *
+         * Text is the only column type that changes what is loaded (the other types parse every cell to the same value), so it is all of the schema
+         * that a cache has to match.
+         *
+         * @param columns The indices of the Text columns, in ascending order.
+         */
+        inline std::uint64_t textColumnsHash(const std::vector<std::uint64_t> & columns)
+        {
+            std::string indices;
+
+            for (const auto col : columns) {
+                indices += std::to_string(col) + ",";
+            }
+
+            return hash(indices);
+        }
+
+        /**
+         * Fill in a header for a cache.
+         *
+         * @tparam T The value type.
+         * @param stamp The stamp of the source file.
+         * @param layout The layout of the cache.
+         * @param lastLineOffset The offset in the source of the start of its final line.
+         * @param widthBeforeLastRow The number of columns there were before the final row.
+         * @param headerLine Whether the first line of the source was read as a header.
+         * @param textColumns The hash of the columns the schema made Text.
+         */
+        template<class T>
+        Header header(const SourceStamp & stamp, const Layout & layout, std::uint64_t lastLineOffset, std::uint64_t widthBeforeLastRow, bool headerLine, std::uint64_t textColumns)
+        {
+            Header header{};
+            std::copy(std::begin(Magic), std::end(Magic), header.magic);
+            header.version = Version;
+            header.byteOrder = ByteOrderMark;
+            header.valueType = valueTypeTag<T>();
+            header.alignment = static_cast<std::uint32_t>(Alignment);
+            header.sourceSize = stamp.size;
+            header.sourceModified = stamp.modified;
+            header.rowCount = layout.rowCount;
+            header.columnCount = layout.columnCount;
+            header.lastLineOffset = lastLineOffset;
+            header.widthBeforeLastRow = widthBeforeLastRow;
+            header.headerLine = headerLine ? 1 : 0;
+            header.textColumns = textColumns;
+            return header;
+        }
+
+        /**
+         * A path to write a new cache to before it replaces the cache at a given path.
+         *
+         * Every call gives a different path, in this process or any other, so writers of the same cache never write to (or rename) one another's
+         * temporary file. The path is in the same directory as the cache so that the replacement is a rename within one filesystem.
+         *
+         * @param cachePath The path to the cache.
+         */
+        inline std::string temporaryPath(const std::string & cachePath)
+        {
+            static constexpr const char * HexDigits = "0123456789abcdef";
+            static const std::uint64_t processToken = (static_cast<std::uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+            static std::atomic<std::uint64_t> fileNumber(0);
+            std::string suffix;
+
+            for (auto bits = processToken; 0 != bits; bits >>= 4) {
+                suffix += HexDigits[bits & 0xfU];
+            }
+
+            return cachePath + ".tmp." + suffix + "-" + std::to_string(fileNumber++);
+        }
+
+        /**
+         * A short name for a value type, used in default cache paths so that caches for different storage types can sit side by side.
+         *
+         * @tparam T The value type.
+         */
+        template<class T>
+        std::string valueTypeName()
+        {
+            return (std::is_floating_point_v<T> ? "f" : (std::is_signed_v<T> ? "i" : "u")) + std::to_string(sizeof(T) * 8);
+        }
+
+        /**
+         * The default path of the cache for a source file.
+         *
+         * @tparam T The value type.
+         * @param sourcePath The path to the source file.
+         */
+        template<class T>
+        std::string defaultPath(const std::string & sourcePath)
+        {
+            return sourcePath + "." + valueTypeName<T>() + Extension;
+        }
+
+        /**
+         * The default path of the cache for a selection of the columns of a source file (see LoadOptions::columns), read with a given delimiter and
+         * quote character.
+         *
+         * A cache holds only the columns that were loaded, so each selection has its own cache: the selected column indices are added to the name (or, if
+         * there are too many to list, a hash of them). The same goes for a delimiter or quote other than the usual comma and double quote, which split
+         * the file differently: their character codes are added to the name in hex. An empty selection of a comma-separated file is the whole file and
+         * has the same path as defaultPath(sourcePath).
+         *
+         * @tparam T The value type.
+         * @param sourcePath The path to the source file.
+         * @param columns The indices of the selected columns in the source file, in the order they were selected.
+         * @param delimiter The field delimiter.
+         * @param quote The quote character, '\0' if quoting is off.
+         */
+        template<class T>
+        std::string defaultPath(const std::string & sourcePath, const std::vector<std::size_t> & columns, char delimiter = ',', char quote = '"')
+        {
+            static constexpr const char * HexDigits = "0123456789abcdef";
+            std::string dialect;
+
+            if (',' != delimiter || '"' != quote) {
+                dialect = ".d";
+
+                for (const auto ch : {delimiter, quote}) {
+                    dialect += HexDigits[static_cast<unsigned char>(ch) >> 4];
+                    dialect += HexDigits[static_cast<unsigned char>(ch) & 0xfU];
+                }
+            }
+
+            if (columns.empty()) {
+                return dialect.empty() ? defaultPath<T>(sourcePath) : sourcePath + dialect + "." + valueTypeName<T>() + Extension;
+            }
+
+            static constexpr std::string::size_type MaxSelectionLength = 64;
+            std::string selection;
+
+            for (const auto col : columns) {
+                selection += (selection.empty() ? "c" : "_") + std::to_string(col);
+            }
+
+            if (MaxSelectionLength < selection.size()) {
+                const auto selectionHash = hash(selection);
+                selection = "cx";
+
+                for (int shift = 60; 0 <= shift; shift -= 4) {
+                    selection += HexDigits[(selectionHash >> shift) & 0xfU];
+                }
+            }
+
+            return sourcePath + "." + selection + dialect + "." + valueTypeName<T>() + Extension;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,519 @@
+#ifndef STATISTICS_COLUMN_H
+#define STATISTICS_COLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AlignedAllocator.h"
+#include "Views.h"
+
+namespace Statistics
+{
+    /**
+     * Count the set bits in a bitmap word.
+     */
+    inline unsigned int popCount(std::uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+        unsigned int count = 0;
+
+        while (word) {
+            word &= word - 1;
+            ++count;
+        }
+
+        return count;
+#endif
+    }
+
+    /**
+     * Contiguous storage for a single column of a DataFile.
+     *
+     * Values are held in one aligned buffer, so walking down a column is a linear scan. Whether each cell holds a value is recorded in a separate validity
+     * bitmap (bit set = value present). Missing cells still occupy a slot in the value buffer; for floating-point types that slot holds NaN so that code
+     * reading values directly sees the same thing it always has.
+     *
+     * A column can also borrow its buffers from memory it doesn't own, such as a mapped cache file (see borrow()). A borrowed column is read-only until
+     * it is first modified, at which point its content is copied into buffers of its own.
+     *
+     * @tparam T The value type.
+     */
+    template<class T>
+    class Column
+    {
+        public:
+            /**
+             * Alias for the type of values in the column.
+             */
+            using ValueType = T;
+
+            /**
+             * Alias for the type used for cell indices.
+             */
+            using SizeType = std::size_t;
+
+            /**
+             * Alias for the type of each word in the validity bitmap.
+             */
+            using BitmapWord = std::uint64_t;
+
+            /**
+             * The number of cells tracked by each word in the validity bitmap.
+             */
+            static constexpr SizeType BitsPerWord = std::numeric_limits<BitmapWord>::digits;
+
+            /**
+             * The alignment of the value and validity buffers, in bytes.
+             */
+            static constexpr std::size_t Alignment = 64;
+
+            /**
+             * Type for storage of the column values.
+             */
+            using ValueStorage = std::vector<ValueType, AlignedAllocator<ValueType, Alignment>>;
+
+            /**
+             * Type for storage of the validity bitmap.
+             */
+            using ValidityStorage = std::vector<BitmapWord, AlignedAllocator<BitmapWord, Alignment>>;
+
+            /**
+             * The value stored in the buffer for missing cells.
+             */
+            static constexpr ValueType missingValue()
+            {
+                if constexpr (std::numeric_limits<ValueType>::has_quiet_NaN) {
+                    return std::numeric_limits<ValueType>::quiet_NaN();
+                } else {
+                    return ValueType{};
+                }
+            }
+
+            /**
+             * Create a column that borrows its buffers rather than owning them.
+             *
+             * The buffers must stay unmodified for as long as the column (or any copy of it) borrows them. The column keeps the owner alive until then.
+             *
+             * @param owner Whatever owns the buffers.
+             * @param values The cell values. Must hold size values, with missingValue() in empty cells.
+             * @param validity The validity bitmap. Must hold a word for every BitsPerWord cells, with the bits beyond size clear.
+             * @param size The number of cells.
+             * @return The column.
+             */
+            static Column borrow(std::shared_ptr<const void> owner, const ValueType * values, const BitmapWord * validity, SizeType size)
+            {
+                Column column;
+                column.m_owner = std::move(owner);
+                column.m_data = values;
+                column.m_validityData = validity;
+                column.m_size = size;
+                return column;
+            }
+
+            /**
+             * Initialise an empty column.
+             */
+            Column() = default;
+
+            /**
+             * Initialise a column as a copy of another.
+             *
+             * A copy of a borrowed column borrows the same buffers.
+             *
+             * @param other The column to copy.
+             */
+            Column(const Column & other)
+            :   m_values(other.m_values),
+                m_validity(other.m_validity),
+                m_owner(other.m_owner)
+            {
+                if (isBorrowed()) {
+                    m_data = other.m_data;
+                    m_validityData = other.m_validityData;
+                    m_size = other.m_size;
+                } else {
+                    sync();
+                }
+            }
+
+            /**
+             * Initialise a column by taking over the content of another.
+             *
+             * @param other The column to move. It is left empty.
+             */
+            Column(Column && other) noexcept
+            :   m_values(std::move(other.m_values)),
+                m_validity(std::move(other.m_validity)),
+                m_owner(std::move(other.m_owner)),
+                m_data(std::exchange(other.m_data, nullptr)),
+                m_validityData(std::exchange(other.m_validityData, nullptr)),
+                m_size(std::exchange(other.m_size, 0))
+            {
+                other.m_values.clear();
+                other.m_validity.clear();
+            }
+
+            /**
+             * Replace the content of the column with a copy of another's.
+             *
+             * @param other The column to copy.
+             */
+            Column & operator=(const Column & other)
+            {
+                if (this != &other) {
+                    *this = Column(other);
+                }
+
+                return *this;
+            }
+
+            /**
+             * Replace the content of the column with that of another.
+             *
+             * @param other The column to move. It is left empty.
+             */
+            Column & operator=(Column && other) noexcept
+            {
+                if (this != &other) {
+                    m_values = std::move(other.m_values);
+                    m_validity = std::move(other.m_validity);
+                    m_owner = std::move(other.m_owner);
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_validityData = std::exchange(other.m_validityData, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                    other.m_values.clear();
+                    other.m_validity.clear();
+                }
+
+                return *this;
+            }
+
+            /**
+             * Check whether the column's buffers are borrowed rather than owned.
+             */
+            [[nodiscard]] inline bool isBorrowed() const
+            {
+                return static_cast<bool>(m_owner);
+            }
+
+            /**
+             * The number of cells in the column, including missing cells.
+             */
+            [[nodiscard]] inline SizeType size() const
+            {
+                return m_size;
+            }
+
+            /**
+             * Check whether the column has no cells.
+             */
+            [[nodiscard]] inline bool isEmpty() const
+            {
+                return 0 == m_size;
+            }
+
+            /**
+             * Check whether a cell contains a value.
+             *
+             * @param idx The cell index. Not bounds-checked.
+             */
+            [[nodiscard]] inline bool isValid(SizeType idx) const
+            {
+                return (m_validityData[idx / BitsPerWord] >> (idx % BitsPerWord)) & 1U;
+            }
+
+            /**
+             * Fetch a cell value.
+             *
+             * @param idx The cell index. Not bounds-checked.
+             * @return The value. This is missingValue() if the cell is empty.
+             */
+            [[nodiscard]] inline const ValueType & operator[](SizeType idx) const
+            {
+                return m_data[idx];
+            }
+
+            /**
+             * Fetch a pointer to the start of the contiguous value buffer.
+             */
+            [[nodiscard]] inline const ValueType * data() const
+            {
+                return m_data;
+            }
+
+            /**
+             * Fetch a pointer to the start of the validity bitmap.
+             *
+             * Bit (idx % BitsPerWord) of word (idx / BitsPerWord) is set if cell idx holds a value. Bits beyond size() are always clear.
+             */
+            [[nodiscard]] inline const BitmapWord * validity() const
+            {
+                return m_validityData;
+            }
+
+            /**
+             * Fetch a view of the whole column.
+             *
+             * The view is valid until the column is modified or destroyed.
+             */
+            [[nodiscard]] inline ColumnView<ValueType> view() const
+            {
+                return {m_data, m_validityData, m_size};
+            }
+
+            /**
+             * Count the cells that contain values in a range of the column.
+             *
+             * @param first The first cell to include.
+             * @param count The number of cells to include. first + count must not exceed size().
+             */
+            [[nodiscard]] SizeType validCount(SizeType first, SizeType count) const
+            {
+                if (0 == count) {
+                    return 0;
+                }
+
+                const auto last = first + count - 1;
+                const auto firstWord = first / BitsPerWord;
+                const auto lastWord = last / BitsPerWord;
+                const auto headMask = ~BitmapWord{0} << (first % BitsPerWord);
+                const auto tailMask = ~BitmapWord{0} >> (BitsPerWord - 1 - (last % BitsPerWord));
+
+                if (firstWord == lastWord) {
+                    return popCount(m_validityData[firstWord] & headMask & tailMask);
+                }
+
+                SizeType valid = popCount(m_validityData[firstWord] & headMask);
+
+                for (auto word = firstWord + 1; word < lastWord; ++word) {
+                    valid += popCount(m_validityData[word]);
+                }
+
+                return valid + popCount(m_validityData[lastWord] & tailMask);
+            }
+
+            /**
+             * Count the cells that contain values in the whole column.
+             */
+            [[nodiscard]] inline SizeType validCount() const
+            {
+                return validCount(0, size());
+            }
+
+            /**
+             * Append a value to the column.
+             *
+             * NaN values are recorded as missing so that counts and aggregates treat them the same way as empty cells.
+             *
+             * @param value The value to append.
+             */
+            void append(const ValueType & value)
+            {
+                if constexpr (std::numeric_limits<ValueType>::has_quiet_NaN) {
+                    if (std::isnan(value)) {
+                        appendMissing();
+                        return;
+                    }
+                }
+
+                own();
+                const auto idx = m_values.size();
+                m_values.push_back(value);
+                growValidity();
+                m_validity[idx / BitsPerWord] |= BitmapWord{1} << (idx % BitsPerWord);
+                sync();
+            }
+
+            /**
+             * Append one or more empty cells to the column.
+             *
+             * @param count The number of empty cells to append.
+             */
+            void appendMissing(SizeType count = 1)
+            {
+                own();
+                m_values.resize(m_values.size() + count, missingValue());
+                growValidity();
+                sync();
+            }
+
+            /**
+             * Append all the cells of another column to this one.
+             *
+             * @param other The column whose cells should be appended.
+             */
+            void append(const Column & other)
+            {
+                own();
+                const auto offset = m_values.size();
+                const auto otherWords = other.validityWordCount();
+                m_values.insert(m_values.end(), other.m_data, other.m_data + other.m_size);
+                const auto shift = offset % BitsPerWord;
+
+                if (0 == shift) {
+                    // word-aligned: the other column's bitmap can be copied as-is
+                    m_validity.resize(offset / BitsPerWord);
+                    m_validity.insert(m_validity.end(), other.m_validityData, other.m_validityData + otherWords);
+                    sync();
+                    return;
+                }
+
+                growValidity();
+                auto word = offset / BitsPerWord;
+
+                for (SizeType otherWord = 0; otherWord < otherWords; ++otherWord) {
+                    m_validity[word] |= other.m_validityData[otherWord] << shift;
+
+                    if (++word < m_validity.size()) {
+                        m_validity[word] |= other.m_validityData[otherWord] >> (BitsPerWord - shift);
+                    }
+                }
+
+                sync();
+            }
+
+            /**
+             * Remove the cells from a given index to the end of the column.
+             *
+             * @param count The number of cells to keep. Does nothing if this is not less than size().
+             */
+            void truncate(SizeType count)
+            {
+                if (count >= m_size) {
+                    return;
+                }
+
+                own();
+                m_values.resize(count);
+                m_validity.resize((count + BitsPerWord - 1) / BitsPerWord);
+
+                // keep the bits beyond size() clear
+                if (0 != count % BitsPerWord) {
+                    m_validity.back() &= ~(~BitmapWord{0} << (count % BitsPerWord));
+                }
+
+                sync();
+            }
+
+            /**
+             * Reserve capacity for a number of cells.
+             */
+            void reserve(SizeType count)
+            {
+                own();
+                m_values.reserve(count);
+                m_validity.reserve((count + BitsPerWord - 1) / BitsPerWord);
+                sync();
+            }
+
+            /**
+             * Release any unused capacity.
+             */
+            void shrinkToFit()
+            {
+                if (isBorrowed()) {
+                    return;
+                }
+
+                m_values.shrink_to_fit();
+                m_validity.shrink_to_fit();
+                sync();
+            }
+
+            /**
+             * Remove all cells from the column.
+             */
+            void clear()
+            {
+                m_owner.reset();
+                m_values.clear();
+                m_validity.clear();
+                sync();
+            }
+
+        private:
+            /**
+             * Helper to fetch the number of words in the validity bitmap.
+             */
+            [[nodiscard]] inline SizeType validityWordCount() const
+            {
+                return (m_size + BitsPerWord - 1) / BitsPerWord;
+            }
+
+            /**
+             * Helper to copy borrowed buffers into owned ones before the column is modified.
+             */
+            void own()
+            {
+                if (!isBorrowed()) {
+                    return;
+                }
+
+                m_values.assign(m_data, m_data + m_size);
+                m_validity.assign(m_validityData, m_validityData + validityWordCount());
+                m_owner.reset();
+                sync();
+            }
+
+            /**
+             * Helper to point the accessors at the owned buffers after they have been modified.
+             */
+            inline void sync()
+            {
+                m_data = m_values.data();
+                m_validityData = m_validity.data();
+                m_size = m_values.size();
+            }
+
+            /**
+             * Helper to make sure the validity bitmap has a word for every cell in the value buffer.
+             */
+            inline void growValidity()
+            {
+                const auto words = (m_values.size() + BitsPerWord - 1) / BitsPerWord;
+
+                if (words > m_validity.size()) {
+                    m_validity.resize(words, 0);
+                }
+            }
+
+            /**
+             * The cell values.
+             */
+            ValueStorage m_values;
+
+            /**
+             * The validity bitmap.
+             */
+            ValidityStorage m_validity;
+
+            /**
+             * Whatever owns the buffers, if they are borrowed. Empty if the column owns its buffers.
+             */
+            std::shared_ptr<const void> m_owner;
+
+            /**
+             * The cell values: either the owned buffer or the borrowed one.
+             */
+            const ValueType * m_data = nullptr;
+
+            /**
+             * The validity bitmap: either the owned buffer or the borrowed one.
+             */
+            const BitmapWord * m_validityData = nullptr;
+
+            /**
+             * The number of cells.
+             */
+            SizeType m_size = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,430 @@
+#ifndef STATISTICS_CSVTOKENIZER_H
+#define STATISTICS_CSVTOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "Kernels.h"
+
+namespace Statistics::Csv
+{
+    /**
+     * The characters that give CSV its structure.
+     */
+    struct Dialect
+    {
+        /**
+         * The character that separates the fields of a record. Usually a comma, tab or semicolon.
+         */
+        char delimiter = ',';
+
+        /**
+         * The character that encloses a field containing delimiters or line ends. A doubled quote inside a quoted field stands for a quote. '\0' turns
+         * quoting off.
+         */
+        char quote = '"';
+    };
+
+    /**
+     * Pass a structural character to a scan callback.
+     *
+     * @return What the callback returns, if it returns a bool: true to skip the rest of the record. false otherwise.
+     */
+    template<class Callback>
+    inline bool notify(Callback & callback, std::size_t pos, bool isLineEnd)
+    {
+        if constexpr (std::is_same_v<bool, std::invoke_result_t<Callback &, std::size_t, bool>>) {
+            return callback(pos, isLineEnd);
+        } else {
+            callback(pos, isLineEnd);
+            return false;
+        }
+    }
+
+    /**
+     * Check whether the CPU (and OS) support an instruction set well enough to scan with it.
+     *
+     * Scanning works on bytes, so the AVX-512 scanner needs AVX512BW as well as the AVX512F that the reduction kernels need.
+     */
+    [[nodiscard]] inline bool isSupported(Kernels::InstructionSet set)
+    {
+        switch (set) {
+            case Kernels::InstructionSet::Scalar:
+                return true;
+
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case Kernels::InstructionSet::Avx2:
+                return __builtin_cpu_supports("avx2");
+
+            case Kernels::InstructionSet::Avx512:
+                return __builtin_cpu_supports("avx512bw");
+#endif
+
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * The best instruction set the CPU supports for scanning. Determined once, on first use.
+     */
+    [[nodiscard]] inline Kernels::InstructionSet bestInstructionSet()
+    {
+        static const Kernels::InstructionSet best = []() {
+            if (Csv::isSupported(Kernels::InstructionSet::Avx512)) {
+                return Kernels::InstructionSet::Avx512;
+            }
+
+            if (Csv::isSupported(Kernels::InstructionSet::Avx2)) {
+                return Kernels::InstructionSet::Avx2;
+            }
+
+            return Kernels::InstructionSet::Scalar;
+        }();
+
+        return best;
+    }
+
+    /**
+     * Portable reference scanner.
+     *
+     * Walks the content a byte at a time. The vectorised scanners produce exactly the same structural characters, and use this for whatever is left
+     * over after their last whole block.
+     */
+    namespace Scalar
+    {
+        /**
+         * Scan part of some content for structural characters.
+         *
+         * @param content The content.
+         * @param from The position to start at.
+         * @param dialect The dialect.
+         * @param quoted Whether the position is inside a quoted field. Updated to the state at the end of the content.
+         * @param skipping Whether the rest of the record is being skipped. Updated to the state at the end of the content.
+         * @param callback Called with the position of each structural character and whether it is a line end.
+         */
+        template<class Callback>
+        void scan(std::string_view content, std::size_t from, const Dialect & dialect, bool & quoted, bool & skipping, Callback & callback)
+        {
+            for (auto idx = from; idx < content.size(); ++idx) {
+                const auto ch = content[idx];
+
+                if ('\0' != dialect.quote && dialect.quote == ch) {
+                    quoted = !quoted;
+                } else if (quoted) {
+                    continue;
+                } else if ('\n' == ch) {
+                    skipping = notify(callback, idx, true);
+                } else if (dialect.delimiter == ch && !skipping) {
+                    skipping = notify(callback, idx, false);
+                }
+            }
+        }
+    }
+
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+    /**
+     * Helpers for the vectorised scanners, which classify 64 bytes at a time into bitmasks with one bit per byte.
+     */
+    namespace Blocks
+    {
+        /**
+         * The number of bytes classified at once.
+         */
+        constexpr std::size_t Size = 64;
+
+        /**
+         * Mark every byte inside quotes, given the positions of the quotes.
+         *
+         * Each bit of the result is the parity of the quotes up to and including its byte, so an opening quote and the bytes after it are marked and a
+         * closing quote and the bytes after it are not. A doubled quote closes and immediately reopens the field, which marks nothing in between.
+         *
+         * @param quotes The positions of the quote characters in the block.
+         * @param quoted Whether the block starts inside quotes. Updated to the state at the end of the block.
+         * @return The bytes inside quotes.
+         */
+        inline std::uint64_t insideQuotes(std::uint64_t quotes, bool & quoted)
+        {
+            // prefix xor
+            quotes ^= quotes << 1;
+            quotes ^= quotes << 2;
+            quotes ^= quotes << 4;
+            quotes ^= quotes << 8;
+            quotes ^= quotes << 16;
+            quotes ^= quotes << 32;
+
+            if (quoted) {
+                quotes = ~quotes;
+            }
+
+            quoted = (0 != (quotes >> 63));
+            return quotes;
+        }
+
+        /**
+         * Report each structural character in a classified block.
+         *
+         * While the rest of a record is being skipped only line ends are reported, so a record's trailing fields cost nothing once its callback has
+         * seen all it needs.
+         *
+         * @param base The position of the block in the content.
+         * @param structurals The positions of the structural characters in the block.
+         * @param lineEnds The positions of the line ends in the block (structural or not).
+         * @param skipping Whether the rest of the record is being skipped. Updated to the state at the end of the block.
+         * @param callback Called with the position of each structural character and whether it is a line end.
+         */
+        template<class Callback>
+        inline void report(std::size_t base, std::uint64_t structurals, std::uint64_t lineEnds, bool & skipping, Callback & callback)
+        {
+            while (true) {
+                const auto candidates = (skipping ? structurals & lineEnds : structurals);
+
+                if (0 == candidates) {
+                    return;
+                }
+
+                const auto bit = static_cast<std::size_t>(__builtin_ctzll(candidates));
+                skipping = notify(callback, base + bit, 0 != ((lineEnds >> bit) & 1U));
+
+                // everything up to and including the character just reported is done with
+                structurals = (63 == bit ? 0 : structurals & (~std::uint64_t{0} << (bit + 1)));
+            }
+        }
+    }
+
+    /**
+     * AVX2 scanner. Classifies each 64-byte block with two 32-byte compares per character.
+     */
+    namespace Avx2
+    {
+        __attribute__((target("avx2"))) inline std::uint64_t matches(__m256i low, __m256i high, char ch)
+        {
+            const auto needle = _mm256_set1_epi8(ch);
+            const auto lowBits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)));
+            const auto highBits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)));
+            return lowBits | (static_cast<std::uint64_t>(highBits) << 32);
+        }
+
+        template<class Callback>
+        __attribute__((target("avx2"))) void scan(std::string_view content, const Dialect & dialect, Callback & callback)
+        {
+            bool quoted = false;
+            bool skipping = false;
+            std::size_t idx = 0;
+
+            for (; idx + Blocks::Size <= content.size(); idx += Blocks::Size) {
+                const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(content.data() + idx));
+                const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(content.data() + idx + 32));
+                const auto lineEnds = matches(low, high, '\n');
+                auto structurals = matches(low, high, dialect.delimiter) | lineEnds;
+
+                if ('\0' != dialect.quote) {
+                    structurals &= ~Blocks::insideQuotes(matches(low, high, dialect.quote), quoted);
+                }
+
+                Blocks::report(idx, structurals, lineEnds, skipping, callback);
+            }
+
+            Scalar::scan(content, idx, dialect, quoted, skipping, callback);
+        }
+    }
+
+    /**
+     * AVX-512 scanner. Classifies each 64-byte block with a single compare per character.
+     */
+    namespace Avx512
+    {
+        template<class Callback>
+        __attribute__((target("avx512f,avx512bw"))) void scan(std::string_view content, const Dialect & dialect, Callback & callback)
+        {
+            const auto delimiter = _mm512_set1_epi8(dialect.delimiter);
+            const auto quote = _mm512_set1_epi8(dialect.quote);
+            const auto lineEnd = _mm512_set1_epi8('\n');
+            bool quoted = false;
+            bool skipping = false;
+            std::size_t idx = 0;
+
+            for (; idx + Blocks::Size <= content.size(); idx += Blocks::Size) {
+                const auto block = _mm512_loadu_si512(content.data() + idx);
+                const std::uint64_t lineEnds = _mm512_cmpeq_epi8_mask(block, lineEnd);
+                std::uint64_t structurals = _mm512_cmpeq_epi8_mask(block, delimiter) | lineEnds;
+
+                if ('\0' != dialect.quote) {
+                    structurals &= ~Blocks::insideQuotes(_mm512_cmpeq_epi8_mask(block, quote), quoted);
+                }
+
+                Blocks::report(idx, structurals, lineEnds, skipping, callback);
+            }
+
+            Scalar::scan(content, idx, dialect, quoted, skipping, callback);
+        }
+    }
+#endif
+
+    /**
+     * Find the structural characters in some CSV: the delimiters and line ends that aren't inside quoted fields.
+     *
+     * The content must start outside quotes, at the start of a field. Positions are reported in order, whatever the instruction set, and the output is
+     * identical for every instruction set. The delimiter must not be a line end.
+     *
+     * @param content The content.
+     * @param dialect The dialect.
+     * @param callback Called with the position of each structural character and true if it is a line end, false if it is a delimiter. If it returns
+     * a bool, true means the rest of the record isn't needed: its delimiters aren't reported, and the next position reported is its line end.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class Callback>
+    void scan(std::string_view content, const Dialect & dialect, Callback && callback, Kernels::InstructionSet set = bestInstructionSet())
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case Kernels::InstructionSet::Avx512:
+                Avx512::scan(content, dialect, callback);
+                return;
+
+            case Kernels::InstructionSet::Avx2:
+                Avx2::scan(content, dialect, callback);
+                return;
+#endif
+
+            default:
+                bool quoted = false;
+                bool skipping = false;
+                Scalar::scan(content, 0, dialect, quoted, skipping, callback);
+        }
+    }
+
+    /**
+     * Call a function with each field of a single record.
+     *
+     * Line ends outside quotes are treated as delimiters. Fields are passed as they are in the content, quotes and all (see unquote()).
+     *
+     * @param record The record.
+     * @param dialect The dialect.
+     * @param callback Called with each field, in order. A record always has at least one (possibly empty) field.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class Callback>
+    void forEachField(std::string_view record, const Dialect & dialect, Callback && callback, Kernels::InstructionSet set = bestInstructionSet())
+    {
+        std::size_t fieldStart = 0;
+
+        scan(record, dialect, [&record, &callback, &fieldStart](std::size_t pos, bool) {
+            callback(record.substr(fieldStart, pos - fieldStart));
+            fieldStart = pos + 1;
+        }, set);
+
+        callback(record.substr(fieldStart));
+    }
+
+    /**
+     * Check whether some content ends inside a quoted field, i.e. it has an odd number of quote characters.
+     *
+     * @param content The content. Must start outside quotes.
+     * @param dialect The dialect.
+     */
+    [[nodiscard]] inline bool endsInsideQuotes(std::string_view content, const Dialect & dialect)
+    {
+        bool quoted = false;
+
+        if ('\0' != dialect.quote) {
+            for (auto pos = content.find(dialect.quote); std::string_view::npos != pos; pos = content.find(dialect.quote, pos + 1)) {
+                quoted = !quoted;
+            }
+        }
+
+        return quoted;
+    }
+
+    /**
+     * Find the first line end that isn't inside a quoted field.
+     *
+     * @param content The content.
+     * @param dialect The dialect.
+     * @param from The position to start looking from.
+     * @param quoted Whether that position is inside a quoted field.
+     * @return The position of the line end, or npos if there isn't one.
+     */
+    [[nodiscard]] inline std::string_view::size_type findLineEnd(std::string_view content, const Dialect & dialect, std::string_view::size_type from = 0, bool quoted = false)
+    {
+        while (true) {
+            const auto lineEndPos = content.find('\n', from);
+
+            if (std::string_view::npos == lineEndPos) {
+                return lineEndPos;
+            }
+
+            quoted = (quoted != endsInsideQuotes(content.substr(from, lineEndPos - from), dialect));
+
+            if (!quoted) {
+                return lineEndPos;
+            }
+
+            from = lineEndPos + 1;
+        }
+    }
+
+    /**
+     * Read a record from a stream: a line, and as many more as it takes to close a quoted field left open.
+     *
+     * @param in The stream to read.
+     * @param dialect The dialect.
+     * @param record Receives the record, without its final line terminator.
+     * @return The number of bytes read.
+     */
+    inline std::uint64_t readRecord(std::istream & in, const Dialect & dialect, std::string & record)
+    {
+        std::getline(in, record);
+        std::uint64_t byteCount = record.size() + (in.eof() ? 0 : 1);
+
+        // a line end inside a quoted field is part of the field, so the record carries on into the next line
+        if (!in.eof() && endsInsideQuotes(record, dialect)) {
+            std::string line;
+            bool quoted = true;
+
+            while (quoted && !in.eof()) {
+                std::getline(in, line);
+                byteCount += line.size() + (in.eof() ? 0 : 1);
+                quoted = (quoted != endsInsideQuotes(line, dialect));
+                record += '\n';
+                record += line;
+            }
+        }
+
+        return byteCount;
+    }
+
+    /**
+     * Extract the content of a quoted field.
+     *
+     * If the field, without surrounding whitespace, is enclosed in quotes, the content between them is returned. Doubled quotes inside are left as
+     * they are, since they can't be part of a number. Any other field is returned unchanged.
+     *
+     * @param field The field.
+     * @param dialect The dialect.
+     * @return The content of the field.
+     */
+    [[nodiscard]] inline std::string_view unquote(std::string_view field, const Dialect & dialect)
+    {
+        // the common case: an unquoted field that doesn't start with whitespace
+        const auto first = (field.empty() ? '\0' : field.front());
+
+        if ('\0' == dialect.quote || (dialect.quote != first && ' ' != first && ('\t' > first || '\r' < first))) {
+            return field;
+        }
+
+        auto begin = field.find_first_not_of(" \t\r\n\v\f");
+        auto end = field.find_last_not_of(" \t\r\n\v\f");
+
+        if (std::string_view::npos == begin || begin == end || dialect.quote != field[begin] || dialect.quote != field[end]) {
+            return field;
+        }
+
+        return field.substr(begin + 1, end - begin - 1);
+    }
+}
+
+#endif
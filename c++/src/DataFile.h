@@ -7,11 +7,32 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <cctype>
 #include <cmath>
 #include <cctype>
 #include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include "CacheFile.h"
+#include "Column.h"
+#include "CsvTokenizer.h"
+#include "FloatParser.h"
+#include "Instrumentation.h"
+#include "Kernels.h"
+#include "Accumulators.h"
+#include "MappedFile.h"
+#include "Parallel.h"
 
 namespace Statistics
 {
@@ -22,46 +43,206 @@ namespace Statistics
     using DataItemParser = T(const std::string_view &);
 
     /**
-     * Default value parser for DataFiles with integer value types.
+     * The outcome of parsing a data item.
+     */
+    enum class DataItemStatus
+    {
+        /**
+         * The item was parsed.
+         */
+        Ok = 0,
+
+        /**
+         * The item is empty or contains only whitespace. This is how missing values are written, so it is not an error.
+         */
+        Empty,
+
+        /**
+         * The item does not start with a number.
+         */
+        Invalid,
+
+        /**
+         * The item starts with a number but has other characters after it.
+         */
+        TrailingCharacters,
+
+        /**
+         * The item is a number that can't be represented in the value type.
+         */
+        OutOfRange,
+    };
+
+    /**
+     * Describe the outcome of parsing a data item.
      *
-     * The implementation uses std::from_chars() for all numeric types for which it is defined. To use other types as the underlying value type for DataFile
-     * objects, you will need to provide your own implementation.
+     * @param status The outcome.
+     * @return A short description.
+     */
+    constexpr const char * describe(DataItemStatus status)
+    {
+        switch (status) {
+            case DataItemStatus::Ok:
+                return "ok";
+
+            case DataItemStatus::Empty:
+                return "empty value";
+
+            case DataItemStatus::Invalid:
+                return "invalid numeric value";
+
+            case DataItemStatus::TrailingCharacters:
+                return "unexpected non-numeric characters at end";
+
+            default:
+                return "numeric value out of range";
+        }
+    }
+
+    /**
+     * Helper to strip leading and trailing whitespace from a data item.
      *
-     * @param str The string to parse. Leading and trailing whitespace is ignored.
-     * @return The parsed value.
-     * @throws std::invalid_argument if str cannot be parsed to the required value.
+     * Whitespace is what std::isspace() matches in the "C" locale: space, \t, \n, \v, \f and \r. It is matched inline rather than with std::isspace(),
+     * which costs a call (and a locale lookup) per character.
+     *
+     * @param str The item.
+     * @return The item without surrounding whitespace.
      */
-    template<typename IntType, int base = 10, std::enable_if_t<std::is_integral_v<IntType>, bool> = true>
-    IntType defaultDataItemParser(const std::string_view & str)
+    inline std::string_view trimDataItem(std::string_view str)
     {
+        const auto isSpace = [](char ch) {
+            return ' ' == ch || ('\t' <= ch && '\r' >= ch);
+        };
+
         auto * begin = str.data();
         auto * end = begin + str.size();
 
-        while (begin < end && std::isspace(*begin)) {
+        while (begin < end && isSpace(*begin)) {
             ++begin;
         }
 
-        while (end > begin && std::isspace(*end)) {
+        while (end > begin && isSpace(*(end - 1))) {
             --end;
         }
 
+        return {begin, static_cast<std::string_view::size_type>(end - begin)};
+    }
+
+    /**
+     * Helper to translate the result of std::from_chars() into the outcome of parsing a data item.
+     *
+     * @param str The (trimmed) item that was parsed.
+     * @param result The result of parsing it.
+     * @return The outcome.
+     */
+    inline DataItemStatus dataItemStatus(std::string_view str, const std::from_chars_result & result)
+    {
+        if (std::errc::invalid_argument == result.ec) {
+            return DataItemStatus::Invalid;
+        } else if (std::errc::result_out_of_range == result.ec) {
+            return DataItemStatus::OutOfRange;
+        } else if (result.ptr != str.data() + str.size()) {
+            return DataItemStatus::TrailingCharacters;
+        }
+
+        return DataItemStatus::Ok;
+    }
+
+    /**
+     * Default exception-free value parser for DataFiles with integer value types.
+     *
+     * The implementation uses std::from_chars() and reports its result directly, so a missing or malformed item costs no more than a valid one.
+     *
+     * @param str The string to parse. Leading and trailing whitespace is ignored.
+     * @param value Receives the parsed value. Unchanged unless the item is parsed.
+     * @return The outcome.
+     */
+    template<typename IntType, int base = 10, std::enable_if_t<std::is_integral_v<IntType>, bool> = true>
+    DataItemStatus tryParseDataItem(const std::string_view & str, IntType & value)
+    {
+        const auto item = trimDataItem(str);
+
+        if (item.empty()) {
+            return DataItemStatus::Empty;
+        }
+
+        IntType parsed;
+        const auto status = dataItemStatus(item, std::from_chars(item.data(), item.data() + item.size(), parsed, base));
+
+        if (DataItemStatus::Ok == status) {
+            value = parsed;
+        }
+
+        return status;
+    }
+
+    /**
+     * Default exception-free value parser for DataFiles with floating-point value types.
+     *
+     * Short decimal items in the general format are converted by FloatParser::tryParse(); anything it leaves is converted by std::from_chars(), whose
+     * result is reported directly, so a missing or malformed item costs no more than a valid one. Either way the value is exactly what std::from_chars()
+     * produces.
+     *
+     * @param str The string to parse. Leading and trailing whitespace is ignored.
+     * @param value Receives the parsed value. Unchanged unless the item is parsed.
+     * @return The outcome.
+     */
+    template<typename FloatType, std::chars_format format = std::chars_format::general, std::enable_if_t<std::is_floating_point_v<FloatType>, bool> = true>
+    DataItemStatus tryParseDataItem(const std::string_view & str, FloatType & value)
+    {
+        const auto item = trimDataItem(str);
+
+        if (item.empty()) {
+            return DataItemStatus::Empty;
+        }
+
+        FloatType parsed;
+
+        if constexpr (std::chars_format::general == format) {
+            if (FloatParser::tryParse(item, parsed)) {
+                value = parsed;
+                return DataItemStatus::Ok;
+            }
+        }
+
+        const auto status = dataItemStatus(item, std::from_chars(item.data(), item.data() + item.size(), parsed, format));
+
+        if (DataItemStatus::Ok == status) {
+            value = parsed;
+        }
+
+        return status;
+    }
+
+    /**
+     * Default value parser for DataFiles with integer value types.
+     *
+     * The implementation uses std::from_chars() for all numeric types for which it is defined. To use other types as the underlying value type for DataFile
+     * objects, you will need to provide your own implementation. DataFile itself recognises this parser and calls tryParseDataItem() instead, so that
+     * missing and malformed items don't throw.
+     *
+     * @param str The string to parse. Leading and trailing whitespace is ignored.
+     * @return The parsed value.
+     * @throws std::invalid_argument if str cannot be parsed to the required value.
+     */
+    template<typename IntType, int base = 10, std::enable_if_t<std::is_integral_v<IntType>, bool> = true>
+    IntType defaultDataItemParser(const std::string_view & str)
+    {
         IntType ret;
-        auto [firstUnusedChar, exitCode] = std::from_chars(begin, end, ret, base);
 
-        if (exitCode != std::errc()) {
-            throw std::invalid_argument("invalid numeric value");
-        } else if (firstUnusedChar != end) {
-            throw std::invalid_argument("unexpected non-numeric characters at end");
+        if (const auto status = tryParseDataItem<IntType, base>(str, ret); DataItemStatus::Ok != status) {
+            throw std::invalid_argument(describe(status));
         }
 
         return ret;
     }
 
     /**
-     * Default value parser for DataFiles with integer value types.
+     * Default value parser for DataFiles with floating-point value types.
      *
      * The implementation uses std::from_chars() for all numeric types for which it is defined. To use other types as the underlying value type for DataFile
-     * objects, you will need to provide your own implementation.
+     * objects, you will need to provide your own implementation. DataFile itself recognises this parser and calls tryParseDataItem() instead, so that
+     * missing and malformed items don't throw.
      *
      * @param str The string to parse. Leading and trailing whitespace is ignored.
      * @return The parsed value.
@@ -70,45 +251,393 @@ namespace Statistics
     template<typename FloatType, std::chars_format format = std::chars_format::general, std::enable_if_t<std::is_floating_point_v<FloatType>, bool> = true>
     FloatType defaultDataItemParser(const std::string_view & str)
     {
-        auto * begin = str.data();
-        auto * end = begin + str.size();
+        FloatType ret;
 
-        // ignore leading whitespace
-        while (begin < end && std::isspace(*begin)) {
-            ++begin;
+        if (const auto status = tryParseDataItem<FloatType, format>(str, ret); DataItemStatus::Ok != status) {
+            throw std::invalid_argument(describe(status));
         }
 
-        // ignore trailing whitespace: note we decrement end before the loop and increment it after because it points to one-past-the-last-char not actually the
-        // last char
-        --end;
+        return ret;
+    }
 
-        while (end > begin && std::isspace(*end)) {
-            --end;
+    /**
+     * Parse a data item with a DataFile's parser, without exceptions wherever possible.
+     *
+     * The default parser is bypassed in favour of tryParseDataItem(). A custom parser is called as-is, and any exception it throws is reported as an
+     * Empty item if the item is blank or an Invalid one otherwise.
+     *
+     * @tparam T The value type.
+     * @tparam parser The DataFile's parser.
+     * @param str The string to parse.
+     * @param value Receives the parsed value. Unchanged unless the item is parsed.
+     * @return The outcome.
+     */
+    template<class T, DataItemParser<T> parser>
+    DataItemStatus parseDataItem(const std::string_view & str, T & value)
+    {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if constexpr (parser == static_cast<DataItemParser<T> *>(defaultDataItemParser<T>)) {
+                return tryParseDataItem<T>(str, value);
+            }
         }
 
-        ++end;
+        try {
+            value = parser(str);
+            return DataItemStatus::Ok;
+        } catch (const std::exception &) {
+            return trimDataItem(str).empty() ? DataItemStatus::Empty : DataItemStatus::Invalid;
+        }
+    }
 
-        FloatType ret;
-        auto [firstUnusedChar, exitCode] = std::from_chars(begin, end, ret, format);
+    /**
+     * How the values in a column of a data file are written.
+     *
+     * Every column is stored in the DataFile's value type. The column type tells the loader which parser suits the column's cells best.
+     */
+    enum class ColumnType
+    {
+        /**
+         * Decided by the column's first non-empty cell: Integer if it is a whole number, Real otherwise.
+         */
+        Infer = 0,
+
+        /**
+         * Numbers in any format the DataFile's parser accepts.
+         */
+        Real,
+
+        /**
+         * Whole numbers. Cells are read as 64-bit integers and converted to the value type, which for floating-point value types is much cheaper than
+         * parsing them as real numbers; any cell that isn't a whole number is handed to the DataFile's parser instead, so the values are the same
+         * either way. Makes no difference to integer value types or custom parsers.
+         */
+        Integer,
+
+        /**
+         * Not numeric data (e.g. labels or identifiers). Cells are not parsed: they are empty in the data and are not reported as parse errors.
+         */
+        Text,
+    };
+
+    /**
+     * Check whether a data item is a whole number in decimal, with at most 18 digits so that it always fits a 64-bit integer.
+     *
+     * @param str The item. Leading and trailing whitespace is ignored.
+     */
+    inline bool isWholeNumber(std::string_view str)
+    {
+        auto item = trimDataItem(str);
 
-        if (exitCode != std::errc()) {
-            throw std::invalid_argument("invalid numeric value");
-        } else if (firstUnusedChar != end) {
-            throw std::invalid_argument("unexpected non-numeric characters at end");
+        if (!item.empty() && '-' == item.front()) {
+            item.remove_prefix(1);
         }
 
-        return ret;
+        return !item.empty() && 18 >= item.size() && std::all_of(item.cbegin(), item.cend(), [](char ch) {
+            return '0' <= ch && '9' >= ch;
+        });
+    }
+
+    /**
+     * Parse a data item from an Integer column with a DataFile's parser.
+     *
+     * With the default parser and a floating-point value type, an item that is a whole number is read as a 64-bit integer and converted; anything else
+     * (including -0, whose sign would be lost) goes to parseDataItem(). The conversion rounds exactly as parsing the item as a real number does, so the
+     * result is always identical to parseDataItem().
+     *
+     * @tparam T The value type.
+     * @tparam parser The DataFile's parser.
+     * @param str The string to parse.
+     * @param value Receives the parsed value. Unchanged unless the item is parsed.
+     * @return The outcome.
+     */
+    template<class T, DataItemParser<T> parser>
+    DataItemStatus parseIntegerDataItem(const std::string_view & str, T & value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            if constexpr (parser == static_cast<DataItemParser<T> *>(defaultDataItemParser<T>)) {
+                const auto item = trimDataItem(str);
+                std::int64_t integer;
+                const auto result = std::from_chars(item.data(), item.data() + item.size(), integer);
+
+                if (std::errc() == result.ec && result.ptr == item.data() + item.size() && (0 != integer || '-' != item.front())) {
+                    value = static_cast<T>(integer);
+                    return DataItemStatus::Ok;
+                }
+            }
+        }
+
+        return parseDataItem<T, parser>(str, value);
+    }
+
+    /**
+     * Check whether a line of CSV is a header rather than a row of data.
+     *
+     * A line is a header if at least one of its cells has content and none of them can be parsed as a value. Quoted cells are parsed by their content.
+     *
+     * @tparam T The value type.
+     * @tparam parser The parser for values.
+     * @param line The line, without its line terminator.
+     * @param dialect The delimiter and quote character the line is written with.
+     */
+    template<class T, DataItemParser<T> parser>
+    bool isHeaderLine(std::string_view line, const Csv::Dialect & dialect = {})
+    {
+        bool hasContent = false;
+        bool hasValue = false;
+
+        Csv::forEachField(line, dialect, [&dialect, &hasContent, &hasValue](std::string_view cell) {
+            T value{};
+            const auto status = parseDataItem<T, parser>(Csv::unquote(cell, dialect), value);
+            hasValue = hasValue || DataItemStatus::Ok == status;
+            hasContent = hasContent || DataItemStatus::Empty != status;
+        });
+
+        return hasContent && !hasValue;
+    }
+
+    /**
+     * Extract a column name from a cell of a header line.
+     *
+     * Surrounding whitespace is removed, and then a pair of quotes around the name.
+     *
+     * @param cell The cell.
+     * @param quote The quote character, '\0' if quoting is off.
+     * @return The name.
+     */
+    inline std::string_view headerName(std::string_view cell, char quote = '"')
+    {
+        cell = trimDataItem(cell);
+
+        if ('\0' != quote && 2 <= cell.size() && quote == cell.front() && quote == cell.back()) {
+            cell = cell.substr(1, cell.size() - 2);
+        }
+
+        return cell;
     }
 
+    /**
+     * A data item that could not be parsed.
+     */
+    struct ParseError
+    {
+        /**
+         * The (0-based) row of the item.
+         */
+        std::uint64_t row = 0;
+
+        /**
+         * The (0-based) column of the item.
+         */
+        std::uint64_t column = 0;
+
+        /**
+         * Why it could not be parsed.
+         */
+        DataItemStatus status = DataItemStatus::Invalid;
+
+        /**
+         * The item, truncated to MaxTextLength characters.
+         */
+        std::string text;
+
+        /**
+         * The longest item text kept in the log.
+         */
+        static constexpr std::string_view::size_type MaxTextLength = 32;
+    };
+
+    /**
+     * Statistics about the items that could not be parsed when data was read.
+     */
+    struct ParseReport
+    {
+        /**
+         * The number of empty items. These are missing values, not errors.
+         */
+        std::uint64_t emptyCount = 0;
+
+        /**
+         * The number of items that were not empty but could not be parsed.
+         */
+        std::uint64_t errorCount = 0;
+
+        /**
+         * The first of the errors, in the order they occur in the data, up to the limit set by LoadOptions::errorLogLimit.
+         */
+        std::vector<ParseError> errors;
+
+        /**
+         * Write the logged errors to a stream, one per line, followed by a line saying how many more there were if the log is incomplete.
+         *
+         * Nothing is written if the log is empty.
+         *
+         * @param out The stream.
+         */
+        void write(std::ostream & out) const
+        {
+            if (errors.empty()) {
+                return;
+            }
+
+            std::string message;
+
+            for (const auto & error : errors) {
+                message.append("ERR ").append(describe(error.status)).append(" \"").append(error.text).append("\" at row ").append(std::to_string(error.row))
+                    .append(", column ").append(std::to_string(error.column)).append("\n");
+            }
+
+            if (errorCount > errors.size()) {
+                message.append("ERR ").append(std::to_string(errorCount - errors.size())).append(" more values could not be parsed\n");
+            }
+
+            out << message;
+        }
+    };
+
+    /**
+     * How a DataFile reads its source file.
+     */
+    enum class LoadMode
+    {
+        /**
+         * Memory-map the file and parse it in place, without copying lines or cells. Falls back to Stream for stdin and for anything that can't be
+         * mapped (pipes, FIFOs, devices).
+         */
+        Mapped = 0,
+
+        /**
+         * Read the file line-by-line through an input stream.
+         */
+        Stream,
+    };
+
+    /**
+     * Whether the first line of a data file is a header naming its columns.
+     */
+    enum class HeaderMode
+    {
+        /**
+         * The first line is a header if none of its cells can be parsed as a value (see isHeaderLine()).
+         */
+        Detect = 0,
+
+        /**
+         * The first line is always a header.
+         */
+        Present,
+
+        /**
+         * There is no header; the first line is data.
+         */
+        Absent,
+    };
+
+    /**
+     * Whether a DataFile uses a binary column cache of its source file.
+     */
+    enum class CacheMode
+    {
+        /**
+         * Always parse the source file.
+         */
+        Off = 0,
+
+        /**
+         * Map the cache instead of parsing the source file if the cache is fresh, but never write it.
+         */
+        Read,
+
+        /**
+         * Map the cache if it is fresh; otherwise parse the source file and write a new cache for next time.
+         */
+        Update,
+    };
+
+    /**
+     * Options controlling how a DataFile is loaded.
+     */
+    struct LoadOptions
+    {
+        /**
+         * How to read the file.
+         */
+        LoadMode mode = LoadMode::Mapped;
+
+        /**
+         * The number of threads to parse with. 0 means one per hardware thread.
+         *
+         * Only mapped files are parsed in parallel; the result is identical to a single-threaded load.
+         */
+        unsigned int threads = 1;
+
+        /**
+         * Whether to use a binary column cache of the file. See DataFile::writeCache().
+         */
+        CacheMode cache = CacheMode::Off;
+
+        /**
+         * The path to the cache. Empty means the default: the source path with the column selection and dialect (if either isn't the default), the value
+         * type and ".ttcache" appended.
+         * The cache holds only the selected columns, so a cache given here must only ever be used with the same selection and dialect. With the default
+         * path, a selection that has no cache of its own is picked out of the cache of the whole file if that is fresh. The cache
+         * records whether the first line was read as a header and which columns are Text, and is not used if either differs.
+         */
+        std::string cachePath = {};
+
+        /**
+         * The largest number of parse errors to log (see ParseReport). Errors beyond this are only counted. Logged errors are written to stderr once
+         * the data has been read; 0 logs nothing.
+         */
+        std::size_t errorLogLimit = 10;
+
+        /**
+         * The columns of the file to load, by index, in the order they are to appear in the data. Empty loads every column.
+         *
+         * The data has exactly these columns, whatever the width of the file: a selected column that a row (or the whole file) doesn't reach is
+         * empty for that row. Fields that aren't selected are skipped without being converted, and the rest of each line is never looked at once its
+         * last selected field has been found, so the cost of parsing follows the number of columns selected rather than the width of the file. A
+         * column may be selected more than once. Parse errors are reported with the column's index in the file.
+         */
+        std::vector<std::size_t> columns = {};
+
+        /**
+         * More columns to load, by the name the header gives them, selected after those in columns. A name the header doesn't have (or any name, if
+         * the file has no header) selects a column with no cells, and a message is written to stderr. A name the header gives to more than one
+         * column selects the first.
+         */
+        std::vector<std::string> columnNames = {};
+
+        /**
+         * Whether the first line of the file is a header.
+         */
+        HeaderMode header = HeaderMode::Detect;
+
+        /**
+         * How the values in each column are written, in the order of the columns in the data. Columns beyond the end are Infer.
+         */
+        std::vector<ColumnType> schema = {};
+
+        /**
+         * The field delimiter and quote character. Delimiters and line ends inside quoted fields are part of the field, so a quoted field can span
+         * lines; a quoted cell is parsed by its content.
+         */
+        Csv::Dialect dialect = {};
+    };
+
     /**
      * A data file for use with a statistical test.
      *
+     * Data is stored column-major: each column is a single contiguous, aligned buffer of values with a validity bitmap recording which cells are present
+     * (see Column). Scanning a column is therefore a linear walk through memory regardless of how many rows the file has.
+     *
      * @tparam T The data type for the data file. Items in the data file are parsed to values of this type. Defaults to long double.
      * @tparam parser A function that will be used to parse string content read from the file into values of the data type. Each built-in floating-point type
      * and each built-in integral type, including unsigned variants, are compatible with the default parser template function. For custom types (e.g. big
      * integer implementations) or if you want to support bases greater than 36 you can provide a custom implementation.
+     * @tparam Accumulator The policy used to accumulate sums and means (see Accumulators.h). Its ValueType is the type in which sums are accumulated and
+     * returned, which can be wider than T so that values can be stored compactly without losing precision in aggregates. Defaults to a naive sum in T.
      */
-	template<class T = long double, DataItemParser<T> parser = defaultDataItemParser<T>>
+	template<class T = long double, DataItemParser<T> parser = defaultDataItemParser<T>, class Accumulator = NaiveSum<T>>
 	class DataFile
 	{
 		public:
@@ -122,6 +651,47 @@ namespace Statistics
              */
             using ValueType = T;
 
+            /**
+             * Alias for the accumulation policy.
+             */
+            using AccumulatorType = Accumulator;
+
+            /**
+             * Alias for the type in which sums and means are accumulated and returned.
+             */
+            using SumType = typename Accumulator::ValueType;
+
+            /**
+             * Aggregates over the values in a single column.
+             */
+            struct ColumnSummary
+            {
+                /**
+                 * The number of values in the column.
+                 */
+                IndexType count = 0;
+
+                /**
+                 * The sum of the values.
+                 */
+                SumType sum = 0;
+
+                /**
+                 * The sum of the squares of the values.
+                 */
+                SumType sumSquares = 0;
+
+                /**
+                 * The smallest value. NaN (or the type's missing value) if the column has no values.
+                 */
+                ValueType min = Column<ValueType>::missingValue();
+
+                /**
+                 * The largest value. NaN (or the type's missing value) if the column has no values.
+                 */
+                ValueType max = Column<ValueType>::missingValue();
+            };
+
             static_assert(std::is_integral_v<IndexType>, "DataFile::IndexType must be an integral numeric type.");
             static_assert(!std::is_unsigned_v<IndexType>, "DataFile::IndexType should not be unsigned because it makes looping over rows and columns error prone.");
 
@@ -130,12 +700,14 @@ namespace Statistics
              *
              * The CSV parser is very simple. It loads successive lines from the provided file and splits it at each comma (,). Each element in the resulting
              * array of strings is parsed to the ValueType. If this fails, the value for that cell is considered missing (NaN); otherwise, the parsed value is
-             * used for the cell.
+             * used for the cell. The first line can be a header naming the columns (see LoadOptions::header), in which case it is not part of the data.
              *
-             * @param path The path to a local CSV file to load.
+             * @param path The path to a local CSV file to load. Use "-" to read from stdin.
+             * @param options Options controlling how the file is loaded.
              */
-			explicit DataFile(std::string path = {})
-			:	m_file(std::move(path))
+			explicit DataFile(std::string path = {}, LoadOptions options = {})
+			:	m_file(std::move(path)),
+                m_options(std::move(options))
 			{
 				reload();
 			}
@@ -181,22 +753,18 @@ namespace Statistics
              */
 			[[nodiscard]] inline IndexType rowCount() const
             {
-				return m_data.size();
+				return m_rowCount;
 			}
 
             /**
              * The number of columns in the DataFile.
              *
-             * Currently the count naively assumes the first row contains all the columns that exist in the data.
+             * This is the width of the widest row in the data. Cells beyond the end of shorter rows are empty.
              * @return The column count.
              */
 			[[nodiscard]] inline IndexType columnCount() const
             {
-				if(!m_data.empty()) {
-					return m_data[0].size();
-				}
-
-				return 0;
+				return static_cast<IndexType>(m_columns.size());
 			}
 
 			/**
@@ -206,7 +774,7 @@ namespace Statistics
 			 */
 			[[nodiscard]] inline bool isEmpty() const
 			{
-				return m_data.empty();
+				return 0 == m_rowCount;
 			}
 
 			/**
@@ -241,7 +809,7 @@ namespace Statistics
              * @return The number of values.
              */
 			[[nodiscard]] inline IndexType columnItemCount(const IndexType & col = 0) const {
-				return itemCount(0, col, rowCount() - 1, col);
+				return columnSummary(col).count;
 			}
 
             /**
@@ -249,7 +817,7 @@ namespace Statistics
              *
              * @return The mean.
              */
-			inline ValueType mean(double meanNumber = 1.0L) const
+			inline SumType mean(double meanNumber = 1.0L) const
             {
 				return mean(0, 0, rowCount() - 1, columnCount() - 1, meanNumber);
 			}
@@ -259,19 +827,26 @@ namespace Statistics
              *
              * @return The mean.
              */
-			inline ValueType rowMean(const IndexType & row, double meanNumber = 1.0L) const
+			inline SumType rowMean(const IndexType & row, double meanNumber = 1.0L) const
             {
-				return meanNumber(row, 0, row, columnCount() - 1, meanNumber);
+				return mean(row, 0, row, columnCount() - 1, meanNumber);
 			}
 
             /**
              * Calculate the mean of the values in a column in the DataFile.
              *
+             * The arithmetic mean is calculated from the column's cached summary.
+             *
              * @return The mean.
              */
-			inline ValueType columnMean(const IndexType & col, double meanNumber = 1.0L) const
+			inline SumType columnMean(const IndexType & col, double meanNumber = 1.0L) const
             {
-				return meanNumber(0, col, rowCount() - 1, col, meanNumber);
+                if (1.0 == meanNumber) {
+                    const auto summary = columnSummary(col);
+                    return summary.sum / static_cast<SumType>(summary.count);
+                }
+
+				return mean(0, col, rowCount() - 1, col, meanNumber);
 			}
 
             /**
@@ -279,7 +854,7 @@ namespace Statistics
              *
              * @return The sum.
              */
-			inline ValueType sum(double pow = 1.0L) const
+			inline SumType sum(double pow = 1.0L) const
             {
 				return sum(0, 0, rowCount() - 1, columnCount() - 1, pow);
 			}
@@ -289,7 +864,7 @@ namespace Statistics
              *
              * @return The sum.
              */
-			inline ValueType rowSum(const IndexType & row, double pow = 1.0L) const
+			inline SumType rowSum(const IndexType & row, double pow = 1.0L) const
             {
 				return sum(row, 0, row, columnCount() - 1, pow);
 			}
@@ -297,214 +872,1703 @@ namespace Statistics
             /**
              * Calculate the sum of the values in a column in the DataFile.
              *
+             * Sums of the values and of their squares come from the column's cached summary.
+             *
              * @return The sum.
              */
-			inline ValueType columnSum(const IndexType & col, double pow = 1.0L) const
+			inline SumType columnSum(const IndexType & col, double pow = 1.0L) const
             {
+                if (1.0 == pow) {
+                    return columnSummary(col).sum;
+                } else if (2.0 == pow) {
+                    return columnSummary(col).sumSquares;
+                }
+
 				return sum(0, col, rowCount() - 1, col, pow);
 			}
 
             /**
-             * Fetch an item from the DataFile.
-             *
-             * @param row The index of the row from which the value is sought.
-             * @param col The index of the column from which the value is sought.
+             * Fetch the smallest value in a column in the DataFile.
              *
-             * @return The value. This will be NaN if the cell is empty.
-             * @throws std::invalid_argument if row or col is OOB
+             * @return The minimum, or NaN if the column has no values.
              */
-			inline const ValueType & item(const IndexType & row, const IndexType & col) const
+            [[nodiscard]] inline ValueType columnMin(const IndexType & col) const
             {
-				if(0 > row || rowCount() <= row) {
-					throw std::invalid_argument("row out of bounds");
-				}
+                return columnSummary(col).min;
+            }
 
-				if(0 > col || columnCount() <= col) {
-					throw std::invalid_argument("column out of bounds");
-				}
-
-				return m_data[row][col];
-			}
+            /**
+             * Fetch the largest value in a column in the DataFile.
+             *
+             * @return The maximum, or NaN if the column has no values.
+             */
+            [[nodiscard]] inline ValueType columnMax(const IndexType & col) const
+            {
+                return columnSummary(col).max;
+            }
 
             /**
-             * Fetch an item from the DataFile.
+             * Fetch the summary aggregates for a column.
              *
-             * @param row The index of the row from which the value is sought.
-             * @param col The index of the column from which the value is sought.
+             * The summary is calculated in one go the first time any of a column's aggregates is asked for, and cached until the data changes. After that,
+             * columnItemCount(), columnSum() (for powers 1 and 2), columnMean() (for the arithmetic mean), columnMin() and columnMax() for the column are
+             * O(1). It is safe to ask for summaries from several threads at once.
              *
-             * @return The value. This will be NaN if the cell is empty.
+             * @param col The index of the column.
+             *
+             * @return The summary.
+             * @throws std::invalid_argument if col is OOB
              */
-			inline ValueType item( const IndexType & row, const IndexType & col )
+            [[nodiscard]] ColumnSummary columnSummary(const IndexType & col) const
             {
-				// force this to be const so that overload resolution of the (apparent)
-                //recursive call results in the above const ValueType & item() const method
-                //being called instead of this one again.
-                return const_cast<const DataFile<T, parser> *>(this)->item(row, col);
-			}
+                if(0 > col || columnCount() <= col) {
+                    throw std::invalid_argument("column out of bounds");
+                }
+
+                if (auto summary = m_summaries.find(col)) {
+                    return *summary;
+                }
+
+                // calculated outside the cache's lock so that summaries of different columns can be calculated concurrently
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Summary);
+                Instrumentation::add(Instrumentation::Counter::SummariesCalculated);
+                const auto & column = m_columns[col];
+                ColumnSummary summary;
+                summary.count = itemCount(0, col, rowCount() - 1, col);
+                summary.sum = sum(0, col, rowCount() - 1, col, 1.0);
+                summary.sumSquares = sum(0, col, rowCount() - 1, col, 2.0);
+
+                for (std::size_t row = 0; row < column.size(); ++row) {
+                    if (!column.isValid(row)) {
+                        continue;
+                    }
+
+                    const auto & value = column[row];
+
+                    if (!(summary.min <= value)) {
+                        summary.min = value;
+                    }
+
+                    if (!(summary.max >= value)) {
+                        summary.max = value;
+                    }
+                }
+
+                m_summaries.store(col, summary);
+                return summary;
+            }
 
-		protected:
             /**
-             * Count the number of items in a given range in the data file.
+             * Fetch the storage for a column.
              *
-             * Note that some cells in the data file can be empty, so the count is not simply the product of the range dimensions.
+             * The column's values are contiguous, which makes this the way to run bulk calculations over a column.
              *
-             * @param r1 The topmost row to include in the count.
-             * @param c1 The leftmost column to include in the count.
-             * @param r2 The bottom-most row to include in the count.
-             * @param c2 The rightmost column to include in the count.
+             * @param col The index of the column.
              *
-             * @return The number of data items in the range.
+             * @return The column.
+             * @throws std::invalid_argument if col is OOB
              */
-			[[nodiscard]] IndexType itemCount(IndexType r1, IndexType c1, IndexType r2, IndexType c2) const
+            [[nodiscard]] inline const Column<ValueType> & column(const IndexType & col) const
             {
-				IndexType count = 0;
-
-                // TODO use std::count_if()?
-				for(IndexType r = r1; r <= r2; ++r) {
-					for(IndexType c = c1; c <= c2; ++c) {
-						if(!std::isnan(m_data[r][c])) {
-							++count;
-						}
-					}
-				}
+                if(0 > col || columnCount() <= col) {
+                    throw std::invalid_argument("column out of bounds");
+                }
 
-				return count;
-			}
+                return m_columns[col];
+            }
 
             /**
-             * Sum the items in a given range.
+             * Fetch the report on the cells that could not be parsed when the data was last read, refreshed or appended to with appendLine().
              *
-             * @param r1 The topmost row to include in the sum.
-             * @param c1 The leftmost column to include in the sum.
-             * @param r2 The bottom-most row to include in the sum.
-             * @param c2 The rightmost column to include in the sum.
-             * @param pow An optional power to which to raise each value before it is added to the sum.
-             *
-             * @return
+             * Empty cells are counted separately from cells with content that isn't a number; the first few errors are logged (see
+             * LoadOptions::errorLogLimit) with their row and column. Data mapped from a cache has an empty report.
              */
-            ValueType sum(IndexType r1, IndexType c1, IndexType r2, IndexType c2, double pow = 1.0L ) const
+            [[nodiscard]] inline const ParseReport & parseReport() const
             {
-                ValueType sum = 0.0L;
-
-				for(IndexType r = r1; r <= r2; ++r) {
-					for(IndexType c = c1; c <= c2; ++c) {
-                        ValueType itemValue = m_data[r][c];
+                return m_parseReport;
+            }
 
-						if(!std::isnan(itemValue)) {
-							sum += std::pow(itemValue, pow);
-						}
-					}
-				}
+            /**
+             * Check whether the data was mapped from a binary cache rather than parsed from its source file.
+             */
+            [[nodiscard]] inline bool isFromCache() const
+            {
+                return m_fromCache;
+            }
 
-				return sum;
-			}
+            /**
+             * The path to the binary cache for the data's source file, as set in the load options or the default.
+             */
+            [[nodiscard]] std::string cachePath() const
+            {
+                return m_options.cachePath.empty() ? Cache::defaultPath<ValueType>(m_file, std::vector<std::size_t>(m_selection.cbegin(), m_selection.cend()), m_options.dialect.delimiter, m_options.dialect.quote) : m_options.cachePath;
+            }
 
             /**
-             * Calculate the mean of the items in a given range.
-             *
-             * The arithmetic mean, which is often referred to as the average, is meanNumber 1; the quadratic is 2; the geometric is -1.
+             * Fetch the index in the source file of a column of the data.
              *
-             * @param r1 The topmost row to include in the sum.
-             * @param c1 The leftmost column to include in the sum.
-             * @param r2 The bottom-most row to include in the sum.
-             * @param c2 The rightmost column to include in the sum.
-             * @param meanNumber Which mean to calculate. Defaults to 1.0 for the arithmetic mean.
+             * This is the column itself unless the data was loaded from a selection of the file's columns (see LoadOptions::columns).
              *
-             * @return
+             * @param col The index of the column in the data.
+             * @return The index of the column in the file, or -1 if it was selected by a name the file's header doesn't have.
+             * @throws std::invalid_argument if col is OOB
              */
-            ValueType mean(IndexType r1, IndexType c1, IndexType r2, IndexType c2, double meanNumber = 1.0L) const
+            [[nodiscard]] inline IndexType sourceColumn(const IndexType & col) const
             {
-                ValueType mean = 0.0L;
-				IndexType n = 0;
-
-				for(IndexType r = r1; r <= r2; ++r) {
-					for(IndexType c = c1; c <= c2; ++c) {
-                        ValueType itemValue = m_data[r][c];
-
-						if(!std::isnan(itemValue)) {
-							++n;
-							mean += std::pow(itemValue, meanNumber);
-						}
-					}
-				}
+                if(0 > col || columnCount() <= col) {
+                    throw std::invalid_argument("column out of bounds");
+                }
 
-				return std::pow(mean / static_cast<ValueType>(n), 1.0L / meanNumber);
-			}
+                return m_selection.empty() ? col : m_selection[static_cast<std::size_t>(col)];
+            }
 
-		private:
             /**
-             * Type for storage of row data.
+             * Check whether the first line of the file was read as a header (see LoadOptions::header).
              */
-			using RowStorage = std::vector<ValueType>;
+            [[nodiscard]] inline bool hasHeader() const
+            {
+                return m_hasHeader;
+            }
 
             /**
-             * Type for storage of the rows in the DataFile.
+             * Fetch the name the file's header gives a column.
+             *
+             * @param col The index of the column in the data.
+             * @return The name. This is empty if the file has no header or the header has no name for the column.
+             * @throws std::invalid_argument if col is OOB
              */
-            using DataStorage = std::vector<RowStorage>;
+            [[nodiscard]] inline std::string_view columnName(const IndexType & col) const
+            {
+                const auto source = sourceColumn(col);
+                return (0 <= source && static_cast<std::size_t>(source) < m_columnNames.size()) ? std::string_view(m_columnNames[static_cast<std::size_t>(source)]) : std::string_view();
+            }
 
             /**
-             * Helper to reload the data from the file.
+             * Look up a column by the name the file's header gives it.
+             *
+             * @param name The name.
+             * @return The index of the column in the data, or nothing if the header has no such name or that column wasn't loaded. If the header gives
+             * the name to more than one column, this is the first of them.
+             */
+            [[nodiscard]] std::optional<IndexType> columnIndex(std::string_view name) const
+            {
+                const auto source = m_columnIndex.find(std::string(name));
+
+                if (m_columnIndex.cend() == source) {
+                    return {};
+                }
+
+                if (m_selection.empty()) {
+                    return (source->second < columnCount() ? std::optional<IndexType>(source->second) : std::nullopt);
+                }
+
+                const auto selected = std::find(m_selection.cbegin(), m_selection.cend(), source->second);
+
+                if (m_selection.cend() == selected) {
+                    return {};
+                }
+
+                return static_cast<IndexType>(selected - m_selection.cbegin());
+            }
+
+            /**
+             * Write the data to a binary column cache.
+             *
+             * The cache (see Cache) records the size and modification time of the source file as it was when read, and a DataFile whose options ask for
+             * the cache maps it in place of parsing the source for as long as those still match. Mapping is close to instant however large the data:
+             * columns borrow their buffers straight from the mapping, and only a column that is later modified is copied. Messages about cells that
+             * could not be parsed are only output when the source is parsed.
+             *
+             * The cache is written to a temporary file of its own (see Cache::temporaryPath()) that then replaces the cache, so a concurrent reader never
+             * sees a partial cache and concurrent writers don't interleave theirs; the last to finish wins. Data read from stdin or modified with
+             * appendRow() or appendLine() no longer matches a source file, so it can't be cached.
+             *
+             * @param path Where to write the cache. Empty for cachePath().
+             * @return true if the cache was written, false otherwise.
+             */
+            bool writeCache(const std::string & path = {}) const
+            {
+                if (!m_sourceStamp) {
+                    return false;
+                }
+
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::CacheWrite);
+                const auto cacheFile = path.empty() ? cachePath() : path;
+                const Cache::Layout layout(static_cast<std::uint64_t>(m_rowCount), m_columns.size(), sizeof(ValueType));
+                std::vector<Cache::ColumnEntry> directory;
+
+                for (std::size_t col = 0; col < m_columns.size(); ++col) {
+                    directory.push_back(layout.entry(col));
+                }
+
+                const auto header = Cache::header<ValueType>(*m_sourceStamp, layout, m_tail ? m_tail->lineOffset : 0, m_tail ? m_tail->widthBeforeRow : 0, m_hasHeader, Cache::textColumnsHash(textColumns(m_columns.size())));
+                const auto temporaryFile = Cache::temporaryPath(cacheFile);
+                std::ofstream out(temporaryFile, std::ios::binary | std::ios::trunc);
+
+                if (!out.is_open()) {
+                    return false;
+                }
+
+                std::uint64_t position = 0;
+
+                // pads with zeros up to an offset, then writes a block
+                const auto writeBlock = [&out, &position](std::uint64_t blockOffset, const void * data, std::uint64_t size) {
+                    static constexpr char padding[Cache::Alignment] = {};
+                    out.write(padding, static_cast<std::streamsize>(blockOffset - position));
+                    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+                    position = blockOffset + size;
+                };
+
+                writeBlock(0, &header, sizeof(header));
+                writeBlock(Cache::DirectoryOffset, directory.data(), directory.size() * sizeof(Cache::ColumnEntry));
+
+                for (std::size_t col = 0; col < m_columns.size(); ++col) {
+                    writeBlock(directory[col].valuesOffset, m_columns[col].data(), layout.valueBytes);
+                    writeBlock(directory[col].validityOffset, m_columns[col].validity(), layout.validityBytes);
+                }
+
+                out.close();
+                std::error_code error;
+
+                if (out) {
+                    std::filesystem::rename(temporaryFile, cacheFile, error);
+
+                    if (!error) {
+                        return true;
+                    }
+                }
+
+                std::filesystem::remove(temporaryFile, error);
+                return false;
+            }
+
+            /**
+             * Append a row of values.
+             *
+             * The row is added in memory only; the file is not modified. Cells for columns beyond the end of the row are empty; if the row is wider than
+             * the data, new columns are added with empty cells for all the existing rows. NaN values are stored as empty cells.
+             *
+             * Only the summaries of the columns that receive a value are discarded, so the cost is proportional to the width of the row, not the size of
+             * the data.
+             *
+             * @param values The values for the row, one per column.
+             */
+            void appendRow(const std::vector<ValueType> & values)
+            {
+                const auto previousWidth = m_columns.size();
+                m_sourceStamp.reset();
+
+                for (std::size_t col = 0; col < values.size(); ++col) {
+                    if (col == m_columns.size()) {
+                        m_columns.emplace_back().appendMissing(static_cast<typename ColumnStorage::SizeType>(m_rowCount));
+                    }
+
+                    m_columns[col].append(values[col]);
+                }
+
+                for (auto col = values.size(); col < m_columns.size(); ++col) {
+                    m_columns[col].appendMissing();
+                }
+
+                ++m_rowCount;
+
+                if (m_columns.size() != previousWidth) {
+                    invalidateSummaries();
+                    return;
+                }
+
+                for (std::size_t col = 0; col < values.size(); ++col) {
+                    invalidateSummary(static_cast<IndexType>(col));
+                }
+            }
+
+            /**
+             * Parse a line of CSV and append it as a row.
+             *
+             * The line is parsed exactly as a line of the file would be, including any column selection. Like appendRow(), this does not modify the file.
+             *
+             * @param line The line, without its line terminator. Line ends are only allowed inside quoted fields.
+             */
+            void appendLine(std::string_view line)
+            {
+                auto rows = parsedRows();
+                loadLines(line, true, rows);
+                finishParse(rows, line.size(), m_rowCount);
+                appendParsed(rows);
+                m_sourceStamp.reset();
+            }
+
+            /**
+             * Load whatever has been appended to the file since it was last read.
+             *
+             * Only the new bytes are read, together with the final line as it was when the file was last read: that line may have been only partly
+             * written, so the row parsed from it is discarded and the line parsed again. The result is identical to loading the whole file again. If the
+             * file has shrunk (e.g. it has been truncated or replaced) it is reloaded from scratch.
+             *
+             * Rows added with appendRow() or appendLine() since the file was last read are discarded. Nothing happens if the data was read from stdin or
+             * the file can't be opened.
+             *
+             * @return The index of the first row that may have changed. Rows before it are untouched. This is rowCount() if nothing changed.
+             */
+            IndexType refresh()
+            {
+                if (!m_tail) {
+                    return m_rowCount;
+                }
+
+                // taken before the file is read so that a cache written later can't claim to match content that was appended in the meantime
+                const auto stamp = SourceStamp::of(m_file);
+                std::ifstream in(m_file, std::ios::binary | std::ios::ate);
+
+                if (!in.is_open()) {
+                    return m_rowCount;
+                }
+
+                const auto size = static_cast<std::uint64_t>(std::max<std::streamoff>(0, in.tellg()));
+
+                if (size < m_tail->fileSize) {
+                    reload();
+                    return 0;
+                }
+
+                if (size == m_tail->fileSize) {
+                    return m_rowCount;
+                }
+
+                m_sourceStamp = stamp;
+
+                std::string content(static_cast<std::string::size_type>(size - m_tail->lineOffset), '\0');
+                in.seekg(static_cast<std::streamoff>(m_tail->lineOffset));
+                in.read(content.data(), static_cast<std::streamsize>(content.size()));
+                content.resize(static_cast<std::string::size_type>(std::max<std::streamsize>(0, in.gcount())));
+
+                // discard the row parsed from the old final line, and any columns that only it had cells in
+                const auto firstChanged = m_tail->row;
+
+                for (auto & column : m_columns) {
+                    column.truncate(static_cast<typename ColumnStorage::SizeType>(firstChanged));
+                }
+
+                m_columns.resize(std::min(m_columns.size(), m_tail->widthBeforeRow));
+                m_rowCount = firstChanged;
+
+                auto rows = parsedRows();
+
+                {
+                    const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Parse);
+                    loadLines(content, true, rows);
+                }
+
+                finishParse(rows, content.size(), firstChanged);
+                const auto lineOffset = m_tail->lineOffset + rows.lastLineOffset;
+                const auto widthBeforeRow = appendParsed(rows);
+                m_tail = Tail{m_tail->lineOffset + content.size(), lineOffset, m_rowCount - 1, widthBeforeRow};
+                return firstChanged;
+            }
+
+            /**
+             * Fetch an item from the DataFile.
+             *
+             * @param row The index of the row from which the value is sought.
+             * @param col The index of the column from which the value is sought.
+             *
+             * @return The value. This will be NaN if the cell is empty.
+             * @throws std::invalid_argument if row or col is OOB
+             */
+			inline const ValueType & item(const IndexType & row, const IndexType & col) const
+            {
+				if(0 > row || rowCount() <= row) {
+					throw std::invalid_argument("row out of bounds");
+				}
+
+				if(0 > col || columnCount() <= col) {
+					throw std::invalid_argument("column out of bounds");
+				}
+
+				return m_columns[col][row];
+			}
+
+            /**
+             * Fetch an item from the DataFile without checking the indices.
+             *
+             * For loops over many items, prefer columnView() or rowView(), which check their index once.
+             *
+             * @param row The index of the row from which the value is sought. Must be in [0, rowCount()).
+             * @param col The index of the column from which the value is sought. Must be in [0, columnCount()).
+             *
+             * @return The value. This will be NaN if the cell is empty.
+             */
+            [[nodiscard]] inline const ValueType & uncheckedItem(const IndexType & row, const IndexType & col) const noexcept
+            {
+                return m_columns[static_cast<std::size_t>(col)].data()[row];
+            }
+
+            /**
+             * Fetch a view of a column's values and validity.
+             *
+             * The view exposes the contiguous value buffer, so once it's taken the column can be scanned with no further checks. It is valid until the
+             * DataFile is modified, reloaded or destroyed.
+             *
+             * @param col The index of the column.
+             *
+             * @return The view.
+             * @throws std::invalid_argument if col is OOB
+             */
+            [[nodiscard]] inline ColumnView<ValueType> columnView(const IndexType & col) const
+            {
+                return column(col).view();
+            }
+
+            /**
+             * Fetch a view of a row's cells.
+             *
+             * The cells of a row are spread across the columns' buffers, so a row view is best suited to examining individual rows; scan columns
+             * with columnView() instead. The view is valid until the DataFile is modified, reloaded or destroyed.
+             *
+             * @param row The index of the row.
+             *
+             * @return The view. It has columnCount() cells.
+             * @throws std::invalid_argument if row is OOB
+             */
+            [[nodiscard]] inline RowView<Column<ValueType>> rowView(const IndexType & row) const
+            {
+                if(0 > row || rowCount() <= row) {
+                    throw std::invalid_argument("row out of bounds");
+                }
+
+                return {m_columns.data(), m_columns.size(), static_cast<std::size_t>(row)};
+            }
+
+		protected:
+            /**
+             * Discard the cached summaries of all columns.
+             *
+             * Subclasses that modify the data must call this (or invalidateSummary()) so that the aggregates are recalculated.
+             */
+            inline void invalidateSummaries()
+            {
+                m_summaries.reset(m_columns.size());
+            }
+
+            /**
+             * Discard the cached summary of one column.
+             *
+             * @param col The index of the column whose data has changed. Not bounds-checked.
+             */
+            inline void invalidateSummary(const IndexType & col)
+            {
+                m_summaries.invalidate(col);
+            }
+
+            /**
+             * Count the number of items in a given range in the data file.
+             *
+             * Note that some cells in the data file can be empty, so the count is not simply the product of the range dimensions.
+             *
+             * @param r1 The topmost row to include in the count.
+             * @param c1 The leftmost column to include in the count.
+             * @param r2 The bottom-most row to include in the count.
+             * @param c2 The rightmost column to include in the count.
+             *
+             * @return The number of data items in the range.
+             */
+			[[nodiscard]] IndexType itemCount(IndexType r1, IndexType c1, IndexType r2, IndexType c2) const
+            {
+				IndexType count = 0;
+
+                if (r2 < r1) {
+                    return count;
+                }
+
+				for(IndexType c = c1; c <= c2; ++c) {
+                    count += static_cast<IndexType>(m_columns[c].validCount(r1, r2 - r1 + 1));
+				}
+
+				return count;
+			}
+
+            /**
+             * Sum the items in a given range.
+             *
+             * @param r1 The topmost row to include in the sum.
+             * @param c1 The leftmost column to include in the sum.
+             * @param r2 The bottom-most row to include in the sum.
+             * @param c2 The rightmost column to include in the sum.
+             * @param pow An optional power to which to raise each value before it is added to the sum.
+             *
+             * @return
+             */
+            SumType sum(IndexType r1, IndexType c1, IndexType r2, IndexType c2, double pow = 1.0L ) const
+            {
+                Accumulator sum;
+
+                if (r2 < r1) {
+                    return sum.value();
+                }
+
+				for(IndexType c = c1; c <= c2; ++c) {
+                    const auto & column = m_columns[c];
+                    const auto * values = column.data();
+
+                    // for naive and pairwise float and double sums the common powers use the vectorised kernels; missing cells hold NaN, which the
+                    // kernels skip
+                    if constexpr (Kernels::HasKernels<ValueType> && AccumulatesWithKernels<ValueType, Accumulator>) {
+                        if (1.0 == pow || 2.0 == pow) {
+                            forEachPartial<Accumulator>(static_cast<std::size_t>(r2 - r1 + 1), [&sum, values = values + r1, pow](std::size_t offset, std::size_t size) {
+                                sum.addPartial(1.0 == pow ? Kernels::sum(values + offset, size) : Kernels::sumSquares(values + offset, size));
+                            });
+
+                            continue;
+                        }
+                    }
+
+                    // the common powers are special-cased so that the inner loop is a plain walk through the column buffer
+                    if (1.0 == pow) {
+                        for (IndexType r = r1; r <= r2; ++r) {
+                            if (column.isValid(r)) {
+                                sum.add(static_cast<SumType>(values[r]));
+                            }
+                        }
+                    } else if (2.0 == pow) {
+                        for (IndexType r = r1; r <= r2; ++r) {
+                            if (column.isValid(r)) {
+                                const auto value = static_cast<SumType>(values[r]);
+                                sum.add(value * value);
+                            }
+                        }
+                    } else {
+                        for (IndexType r = r1; r <= r2; ++r) {
+                            if (column.isValid(r)) {
+                                sum.add(std::pow(static_cast<SumType>(values[r]), pow));
+                            }
+                        }
+                    }
+				}
+
+				return sum.value();
+			}
+
+            /**
+             * Calculate the mean of the items in a given range.
+             *
+             * The arithmetic mean, which is often referred to as the average, is meanNumber 1; the quadratic is 2; the geometric is -1.
+             *
+             * @param r1 The topmost row to include in the sum.
+             * @param c1 The leftmost column to include in the sum.
+             * @param r2 The bottom-most row to include in the sum.
+             * @param c2 The rightmost column to include in the sum.
+             * @param meanNumber Which mean to calculate. Defaults to 1.0 for the arithmetic mean.
+             *
+             * @return
+             */
+            SumType mean(IndexType r1, IndexType c1, IndexType r2, IndexType c2, double meanNumber = 1.0L) const
+            {
+                Accumulator mean;
+				IndexType n = 0;
+
+				for(IndexType c = c1; c <= c2; ++c) {
+                    const auto & column = m_columns[c];
+
+                    for(IndexType r = r1; r <= r2; ++r) {
+						if(column.isValid(r)) {
+							++n;
+							mean.add(std::pow(static_cast<SumType>(column[r]), meanNumber));
+						}
+					}
+				}
+
+				return std::pow(mean.value() / static_cast<SumType>(n), 1.0L / meanNumber);
+			}
+
+		private:
+            /**
+             * Type for storage of a single column.
+             */
+			using ColumnStorage = Column<ValueType>;
+
+            /**
+             * Type for storage of the columns in the DataFile.
+             */
+            using DataStorage = std::vector<ColumnStorage>;
+
+            /**
+             * A column selected for loading (see LoadOptions::columns).
+             */
+            struct SelectedColumn
+            {
+                /**
+                 * The index of the column in the file.
+                 */
+                IndexType source;
+
+                /**
+                 * The index of the column in the data.
+                 */
+                IndexType column;
+            };
+
+            /**
+             * The selected columns, in the order they occur in the file. Empty when every column is loaded.
+             */
+            using Projection = std::vector<SelectedColumn>;
+
+            /**
+             * Rows parsed from a contiguous run of lines.
+             *
+             * The loader parses into one of these per chunk of input so that chunks can be parsed independently (and concurrently) and then stitched
+             * back together in order.
+             */
+            struct ParsedRows
+            {
+                /**
+                 * The parsed data, one entry per column.
+                 */
+                DataStorage columns;
+
+                /**
+                 * The number of rows parsed.
+                 */
+                IndexType rowCount = 0;
+
+                /**
+                 * The cells that could not be parsed. Rows in the log are counted from the first of these rows.
+                 */
+                ParseReport report;
+
+                /**
+                 * The largest number of errors to log in the report.
+                 */
+                std::size_t errorLogLimit = 0;
+
+                /**
+                 * The columns to parse, if only some are selected. Not owned.
+                 */
+                const Projection * projection = nullptr;
+
+                /**
+                 * The column types given in the load options, in data column order. Not owned.
+                 */
+                const std::vector<ColumnType> * schema = nullptr;
+
+                /**
+                 * The type each column's cells are parsed as. Inferred types are settled by the first non-empty cell each column has in these rows.
+                 */
+                std::vector<ColumnType> types;
+
+                /**
+                 * The delimiter and quote character.
+                 */
+                Csv::Dialect dialect;
+
+                /**
+                 * The number of fields of the row being parsed seen so far.
+                 */
+                IndexType rowWidth = 0;
+
+                /**
+                 * The first selection in the projection that the row being parsed hasn't yet reached.
+                 */
+                std::size_t nextSelected = 0;
+
+                /**
+                 * The number of cells of the row being parsed that have been parsed, including empty ones.
+                 */
+                std::uint64_t rowCellCount = 0;
+
+                /**
+                 * The number of columns there were before the last row was parsed.
+                 */
+                std::size_t widthBeforeLastRow = 0;
+
+                /**
+                 * The number of cells parsed, including empty ones.
+                 */
+                std::uint64_t cellCount = 0;
+
+                /**
+                 * The number of bytes of input the rows were parsed from.
+                 */
+                std::uint64_t byteCount = 0;
+
+                /**
+                 * The offset in the input of the start of the last record.
+                 */
+                std::uint64_t lastLineOffset = 0;
+
+                /**
+                 * Fetch the column to which the next cell of the row being parsed should be appended.
+                 *
+                 * If the row is wider than any seen so far, a new column is created and back-filled with empty cells for all the preceding rows.
+                 *
+                 * @param col The index of the column.
+                 * @return The column.
+                 */
+                ColumnStorage & columnForAppend(IndexType col)
+                {
+                    if (col == static_cast<IndexType>(columns.size())) {
+                        columns.emplace_back().appendMissing(rowCount);
+                    }
+
+                    return columns[col];
+                }
+
+                /**
+                 * Complete the row being parsed once all of its fields have been seen.
+                 *
+                 * Columns the row didn't reach are padded with an empty cell so that every column has one cell per row.
+                 */
+                void finishRow()
+                {
+                    if (projection) {
+                        for (; nextSelected < projection->size(); ++nextSelected) {
+                            columns[(*projection)[nextSelected].column].appendMissing();
+                        }
+                    } else {
+                        for (auto col = rowWidth; col < static_cast<IndexType>(columns.size()); ++col) {
+                            columns[col].appendMissing();
+                        }
+                    }
+
+                    ++rowCount;
+                    cellCount += rowCellCount;
+                    rowWidth = 0;
+                    nextSelected = 0;
+                    rowCellCount = 0;
+                }
+
+                /**
+                 * Fetch the type of a column, for parsing one of its cells.
+                 *
+                 * If the column's type is to be inferred and the cell has content, the cell settles it.
+                 *
+                 * @param col The index of the column in the data.
+                 * @param item The content of the cell.
+                 * @return The type.
+                 */
+                ColumnType typeOf(IndexType col, std::string_view item)
+                {
+                    const auto idx = static_cast<std::size_t>(col);
+
+                    while (types.size() <= idx) {
+                        types.push_back(schema && types.size() < schema->size() ? (*schema)[types.size()] : ColumnType::Infer);
+                    }
+
+                    if (ColumnType::Infer == types[idx] && !trimDataItem(item).empty()) {
+                        types[idx] = (isWholeNumber(item) ? ColumnType::Integer : ColumnType::Real);
+                    }
+
+                    return types[idx];
+                }
+
+                /**
+                 * Record a cell of the row being parsed that could not be parsed.
+                 *
+                 * @param status Why it could not be parsed.
+                 * @param col The index of the cell's column.
+                 * @param item The content of the cell.
+                 */
+                void recordFailure(DataItemStatus status, IndexType col, std::string_view item)
+                {
+                    if (DataItemStatus::Empty == status) {
+                        ++report.emptyCount;
+                        return;
+                    }
+
+                    ++report.errorCount;
+
+                    if (report.errors.size() < errorLogLimit) {
+                        report.errors.push_back({static_cast<std::uint64_t>(rowCount), static_cast<std::uint64_t>(col), status, std::string(item.substr(0, ParseError::MaxTextLength))});
+                    }
+                }
+
+                /**
+                 * Append rows parsed from the chunk of input that follows this one.
+                 *
+                 * @param other The rows to append.
+                 */
+                void append(const ParsedRows & other)
+                {
+                    const auto width = std::max(columns.size(), other.columns.size());
+
+                    if (0 < other.rowCount) {
+                        widthBeforeLastRow = std::max(columns.size(), other.widthBeforeLastRow);
+                    }
+
+                    for (std::size_t col = 0; col < width; ++col) {
+                        if (col == columns.size()) {
+                            columns.emplace_back().appendMissing(rowCount);
+                        }
+
+                        if (col < other.columns.size()) {
+                            columns[col].append(other.columns[col]);
+                        } else {
+                            columns[col].appendMissing(other.rowCount);
+                        }
+                    }
+
+                    for (auto error = other.report.errors.cbegin(); error != other.report.errors.cend() && report.errors.size() < errorLogLimit; ++error) {
+                        report.errors.push_back(*error);
+                        report.errors.back().row += static_cast<std::uint64_t>(rowCount);
+                    }
+
+                    report.emptyCount += other.report.emptyCount;
+                    report.errorCount += other.report.errorCount;
+                    rowCount += other.rowCount;
+                    cellCount += other.cellCount;
+                }
+            };
+
+            /**
+             * Cache of the summary for each column.
+             *
+             * The cache is guarded by its own mutex so that const DataFiles shared between threads can fill it safely. Copies take a copy of the cached
+             * summaries but have their own mutex.
+             */
+            class SummaryCache
+            {
+                public:
+                    SummaryCache() = default;
+
+                    SummaryCache(const SummaryCache & other)
+                    :   m_summaries(other.copySummaries())
+                    {}
+
+                    SummaryCache(SummaryCache && other) noexcept
+                    :   m_summaries(std::move(other.m_summaries))
+                    {}
+
+                    SummaryCache & operator=(const SummaryCache & other)
+                    {
+                        if (this != &other) {
+                            auto summaries = other.copySummaries();
+                            std::lock_guard lock(*m_mutex);
+                            m_summaries = std::move(summaries);
+                        }
+
+                        return *this;
+                    }
+
+                    SummaryCache & operator=(SummaryCache && other) noexcept
+                    {
+                        m_summaries = std::move(other.m_summaries);
+                        return *this;
+                    }
+
+                    /**
+                     * Fetch the cached summary for a column, if there is one.
+                     */
+                    std::optional<ColumnSummary> find(const IndexType & col) const
+                    {
+                        std::lock_guard lock(*m_mutex);
+                        return m_summaries[col];
+                    }
+
+                    /**
+                     * Cache the summary for a column.
+                     */
+                    void store(const IndexType & col, const ColumnSummary & summary)
+                    {
+                        std::lock_guard lock(*m_mutex);
+                        m_summaries[col] = summary;
+                    }
+
+                    /**
+                     * Discard the cached summary for a column.
+                     */
+                    void invalidate(const IndexType & col)
+                    {
+                        std::lock_guard lock(*m_mutex);
+                        m_summaries[col].reset();
+                    }
+
+                    /**
+                     * Discard all cached summaries and size the cache for a number of columns.
+                     */
+                    void reset(std::size_t columnCount)
+                    {
+                        std::lock_guard lock(*m_mutex);
+                        m_summaries.assign(columnCount, std::nullopt);
+                    }
+
+                private:
+                    /**
+                     * Helper to take a copy of the summaries under the lock.
+                     */
+                    std::vector<std::optional<ColumnSummary>> copySummaries() const
+                    {
+                        std::lock_guard lock(*m_mutex);
+                        return m_summaries;
+                    }
+
+                    /**
+                     * The summaries, one per column. Sized when the data is loaded so that filling in an entry never allocates.
+                     */
+                    std::vector<std::optional<ColumnSummary>> m_summaries;
+
+                    /**
+                     * Guards m_summaries.
+                     */
+                    std::unique_ptr<std::mutex> m_mutex = std::make_unique<std::mutex>();
+            };
+
+            /**
+             * Where the final line of the file is, so that refresh() can pick up from it.
+             */
+            struct Tail
+            {
+                /**
+                 * The size of the file when it was last read.
+                 */
+                std::uint64_t fileSize;
+
+                /**
+                 * The offset in the file of the start of the final line.
+                 */
+                std::uint64_t lineOffset;
+
+                /**
+                 * The index of the row parsed from the final line.
+                 */
+                IndexType row;
+
+                /**
+                 * The number of columns there were before the row was parsed.
+                 */
+                std::size_t widthBeforeRow;
+            };
+
+            /**
+             * The smallest chunk of input worth handing to a separate thread when loading in parallel.
+             */
+            static constexpr std::string_view::size_type MinimumChunkSize = 64 * 1024;
+
+            /**
+             * Helper to reload the data from the file.
              * @return true on success, false on failure.
              */
 			bool reload() 
             {
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Load);
+                m_tail.reset();
+                m_parseReport = {};
+                m_sourceStamp.reset();
+                m_fromCache = false;
+
+                readHeader({});
+
 				if(m_file.empty()) {
 					std::cerr << "no file to load\n";
 					return false;
 				}
 
-				std::ifstream in(m_file);
+                if ("-" != m_file) {
+                    // taken before the file is read, so that if it changes while it's being read the cache written from it is stale
+                    m_sourceStamp = SourceStamp::of(m_file);
 
-				if(!in.is_open()) {
-					std::cerr << "could not open file\n";
-					return false;
-				}
+                    // the header names the columns, and so decides which are selected and which cache holds them
+                    std::ifstream firstLineIn(m_file, std::ios::binary);
+                    std::string firstLine;
 
-				m_data.clear();
+                    if (firstLineIn.is_open() && firstLineIn.peek() != std::ifstream::traits_type::eof()) {
+                        Csv::readRecord(firstLineIn, m_options.dialect, firstLine);
+                        readHeader(firstLine);
+                    }
 
-				// read buffer
-				std::string line;
+                    // a selection can also be picked out of a cache of the whole file, such as the one t-test-generate writes
+                    if (m_sourceStamp && CacheMode::Off != m_options.cache && (loadCache(cachePath(), *m_sourceStamp)
+                        || (m_options.cachePath.empty() && !m_selection.empty() && loadCache(Cache::defaultPath<ValueType>(m_file, {}, m_options.dialect.delimiter, m_options.dialect.quote), *m_sourceStamp, true)))) {
+                        m_fromCache = true;
+                        Instrumentation::add(Instrumentation::Counter::CacheLoads);
+                        reportUnknownColumnNames();
+                        return true;
+                    }
+                }
 
-				while(!in.eof()) {
-					std::getline(in, line);
-					std::string::size_type valueStartPos = 0;
-					RowStorage row;
+                auto rows = parsedRows();
 
-					while(true) {
-						std::string::size_type valueEndPos = line.find(',', valueStartPos);
+                {
+                    const Instrumentation::ScopedTimer parseTimer(Instrumentation::Phase::Parse);
 
-						try {
-							row.push_back(parser(line.substr(valueStartPos, valueEndPos)));
-						}
-						catch( const std::exception & e ) {
-							std::cerr << "ERR exception parsing data: " << e.what() << "\n";
-							row.push_back(NAN);
-						}
+                    if ("-" == m_file) {
+                        loadStream(std::cin, rows);
+                    } else if (LoadMode::Mapped != m_options.mode || !loadMapped(rows)) {
+                        std::ifstream in(m_file);
 
-						if(std::string::npos == valueEndPos) {
-							row.shrink_to_fit();
-							break;
-						}
+                        if(!in.is_open()) {
+                            std::cerr << "could not open file\n";
+                            return false;
+                        }
 
-                        valueStartPos = valueEndPos + 1;
-					}
+                        loadStream(in, rows);
+                    }
+                }
 
-					m_data.push_back(std::move(row));
-				}
+                finishParse(rows, rows.byteCount, 0);
+                reportUnknownColumnNames();
+
+                m_columns = std::move(rows.columns);
+                m_rowCount = rows.rowCount;
+
+                for (auto & column : m_columns) {
+                    column.shrinkToFit();
+                }
+
+				m_columns.shrink_to_fit();
+                invalidateSummaries();
+
+                if ("-" != m_file && 0 < m_rowCount) {
+                    m_tail = Tail{rows.byteCount, rows.lastLineOffset, m_rowCount - 1, rows.widthBeforeLastRow};
+                }
+
+                if (CacheMode::Update == m_options.cache) {
+                    writeCache();
+                }
 
-				m_data.shrink_to_fit();
 				return true;
 			}
 
             /**
-             * The parsed data.
+             * Helper to load the data from a binary column cache.
+             *
+             * The cache is mapped and its columns borrow their buffers from the mapping. Anything wrong with the cache (it's missing, stale, for another
+             * value type, truncated or otherwise malformed, or it was loaded with a different header mode or Text columns) just means it isn't used.
+             *
+             * A cache of every column of the file can serve any selection of its columns: each selected column borrows the buffers of its column in the
+             * cache, and a selected column the file doesn't have is empty.
+             *
+             * @param path The path to the cache.
+             * @param stamp The stamp of the source file as it is now.
+             * @param wholeFile Whether the cache holds every column of the file, rather than just the selected ones.
+             * @return true if the data was loaded from the cache, false if the source must be parsed instead.
+             */
+            bool loadCache(const std::string & path, const SourceStamp & stamp, bool wholeFile = false)
+            {
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::CacheRead);
+                auto file = std::make_shared<const MappedFile>(path);
+
+                if (!file->isOpen() || file->size() < Cache::DirectoryOffset) {
+                    return false;
+                }
+
+                const auto * base = file->content().data();
+                Cache::Header header{};
+                std::copy(base, base + sizeof(header), reinterpret_cast<char *>(&header));
+
+                if (!std::equal(std::begin(Cache::Magic), std::end(Cache::Magic), header.magic)
+                    || Cache::Version != header.version
+                    || Cache::ByteOrderMark != header.byteOrder
+                    || Cache::valueTypeTag<ValueType>() != header.valueType
+                    || Cache::Alignment != header.alignment
+                    || stamp != SourceStamp{header.sourceSize, header.sourceModified}
+                    || (m_hasHeader ? 1U : 0U) != header.headerLine
+                    || header.rowCount > static_cast<std::uint64_t>(std::numeric_limits<IndexType>::max()) / sizeof(ValueType)
+                    || header.columnCount > (file->size() - Cache::DirectoryOffset) / sizeof(Cache::ColumnEntry)
+                    || (!wholeFile && !m_projection.empty() && header.columnCount != m_projection.size())) {
+                    return false;
+                }
+
+                const auto expectedTextColumns = (wholeFile ? sourceTextColumns(header.columnCount) : std::optional(textColumns(header.columnCount)));
+
+                if (!expectedTextColumns || Cache::textColumnsHash(*expectedTextColumns) != header.textColumns) {
+                    return false;
+                }
+
+                const auto valueBytes = header.rowCount * sizeof(ValueType);
+                const auto validityBytes = (header.rowCount + ColumnStorage::BitsPerWord - 1) / ColumnStorage::BitsPerWord * sizeof(typename ColumnStorage::BitmapWord);
+
+                // true if a block lies on a boundary and within the file
+                const auto isValidBlock = [&file](std::uint64_t offset, std::uint64_t size) {
+                    return 0 == offset % Cache::Alignment && offset <= file->size() && size <= file->size() - offset;
+                };
+
+                DataStorage columns;
+                columns.reserve(static_cast<std::size_t>(header.columnCount));
+
+                for (std::uint64_t col = 0; col < header.columnCount; ++col) {
+                    Cache::ColumnEntry entry{};
+                    const auto * entryData = base + Cache::DirectoryOffset + col * sizeof(entry);
+                    std::copy(entryData, entryData + sizeof(entry), reinterpret_cast<char *>(&entry));
+
+                    if (!isValidBlock(entry.valuesOffset, valueBytes) || !isValidBlock(entry.validityOffset, validityBytes)) {
+                        return false;
+                    }
+
+                    columns.push_back(ColumnStorage::borrow(
+                        file,
+                        reinterpret_cast<const ValueType *>(base + entry.valuesOffset),
+                        reinterpret_cast<const typename ColumnStorage::BitmapWord *>(base + entry.validityOffset),
+                        static_cast<typename ColumnStorage::SizeType>(header.rowCount)
+                    ));
+                }
+
+                auto widthBeforeLastRow = static_cast<std::size_t>(header.widthBeforeLastRow);
+
+                if (wholeFile) {
+                    DataStorage selected;
+                    selected.reserve(m_selection.size());
+
+                    for (const auto source : m_selection) {
+                        if (0 <= source && static_cast<std::uint64_t>(source) < header.columnCount) {
+                            selected.push_back(columns[static_cast<std::size_t>(source)]);
+                        } else {
+                            selected.emplace_back().appendMissing(static_cast<typename ColumnStorage::SizeType>(header.rowCount));
+                        }
+                    }
+
+                    columns = std::move(selected);
+
+                    // a selection always has all its columns, as it would if it had been parsed
+                    widthBeforeLastRow = columns.size();
+                }
+
+                m_columns = std::move(columns);
+                m_rowCount = static_cast<IndexType>(header.rowCount);
+                invalidateSummaries();
+
+                if (0 < m_rowCount) {
+                    m_tail = Tail{header.sourceSize, header.lastLineOffset, m_rowCount - 1, widthBeforeLastRow};
+                }
+
+                return true;
+            }
+
+            /**
+             * Helper to list the columns of the data that the schema makes Text.
+             *
+             * @param width The number of columns in the data.
+             * @return The indices of the Text columns below width, in ascending order.
+             */
+            [[nodiscard]] std::vector<std::uint64_t> textColumns(std::uint64_t width) const
+            {
+                std::vector<std::uint64_t> columns;
+
+                for (std::uint64_t col = 0; col < width && col < m_options.schema.size(); ++col) {
+                    if (ColumnType::Text == m_options.schema[static_cast<std::size_t>(col)]) {
+                        columns.push_back(col);
+                    }
+                }
+
+                return columns;
+            }
+
+            /**
+             * Helper to list the columns of the file that the schema makes Text in the selection.
+             *
+             * @param width The number of columns in the file.
+             * @return The indices in the file of the Text columns below width, in ascending order. Nothing if a column is selected both as Text and
+             * as another type, in which case no cache of the whole file can hold both.
+             */
+            [[nodiscard]] std::optional<std::vector<std::uint64_t>> sourceTextColumns(std::uint64_t width) const
+            {
+                std::vector<std::uint64_t> text;
+                std::vector<std::uint64_t> parsed;
+
+                for (std::size_t col = 0; col < m_selection.size(); ++col) {
+                    const auto source = m_selection[col];
+
+                    if (0 > source || width <= static_cast<std::uint64_t>(source)) {
+                        continue;
+                    }
+
+                    const auto isText = col < m_options.schema.size() && ColumnType::Text == m_options.schema[col];
+                    (isText ? text : parsed).push_back(static_cast<std::uint64_t>(source));
+                }
+
+                std::sort(text.begin(), text.end());
+                text.erase(std::unique(text.begin(), text.end()), text.end());
+
+                for (const auto source : parsed) {
+                    if (std::binary_search(text.cbegin(), text.cend(), source)) {
+                        return {};
+                    }
+                }
+
+                return text;
+            }
+
+            /**
+             * Helper to read the header from the first line of the file, if it is one, and resolve the column selection against it.
+             *
+             * @param firstLine The first line of the file, without its line terminator. Nothing if it hasn't been read (the selection is then resolved
+             * as if the file has no header).
+             * @return true if the line is a header, false if it is data.
+             */
+            bool readHeader(std::optional<std::string_view> firstLine)
+            {
+                const auto & dialect = m_options.dialect;
+                m_hasHeader = firstLine && (HeaderMode::Present == m_options.header || (HeaderMode::Detect == m_options.header && isHeaderLine<ValueType, parser>(*firstLine, dialect)));
+                m_columnNames.clear();
+                m_columnIndex.clear();
+
+                if (m_hasHeader) {
+                    Csv::forEachField(*firstLine, dialect, [this, &dialect](std::string_view cell) {
+                        m_columnNames.emplace_back(headerName(cell, dialect.quote));
+
+                        // emplace() leaves an existing entry alone, so a repeated name refers to its first column
+                        m_columnIndex.emplace(m_columnNames.back(), static_cast<IndexType>(m_columnNames.size() - 1));
+                    });
+                }
+
+                m_selection.clear();
+
+                for (const auto col : m_options.columns) {
+                    m_selection.push_back(static_cast<IndexType>(col));
+                }
+
+                for (const auto & name : m_options.columnNames) {
+                    const auto source = m_columnIndex.find(name);
+                    m_selection.push_back(m_columnIndex.cend() == source ? -1 : source->second);
+                }
+
+                m_projection = projectionOf(m_selection);
+                return m_hasHeader;
+            }
+
+            /**
+             * Helper to write a message to stderr for each column selected by a name that the header doesn't have.
              */
-            DataStorage m_data;
+            void reportUnknownColumnNames() const
+            {
+                for (const auto & name : m_options.columnNames) {
+                    if (m_columnIndex.cend() == m_columnIndex.find(name)) {
+                        std::cerr << "ERR no column named \"" << name << "\"\n";
+                    }
+                }
+            }
+
+            /**
+             * Helper to put together the column projection from a column selection.
+             *
+             * @param columns The selected columns of the file, in the order they are to appear in the data. A column that isn't in the file is -1.
+             * @return The selection sorted into file order, with columns that aren't in the file last.
+             */
+            static Projection projectionOf(const std::vector<IndexType> & columns)
+            {
+                Projection projection;
+
+                for (std::size_t col = 0; col < columns.size(); ++col) {
+                    // a column that isn't in the file is never reached, so all its cells are empty
+                    const auto source = (0 > columns[col] ? std::numeric_limits<IndexType>::max() : columns[col]);
+                    projection.push_back({source, static_cast<IndexType>(col)});
+                }
+
+                std::stable_sort(projection.begin(), projection.end(), [](const SelectedColumn & lhs, const SelectedColumn & rhs) {
+                    return lhs.source < rhs.source;
+                });
+
+                return projection;
+            }
+
+            /**
+             * Helper to set up an empty set of parsed rows to parse into.
+             *
+             * When only some columns are selected, every selected column is created up front so that cells can be appended to them in file order.
+             */
+            ParsedRows parsedRows() const
+            {
+                ParsedRows rows;
+                rows.errorLogLimit = m_options.errorLogLimit;
+                rows.dialect = m_options.dialect;
+
+                if (!m_options.schema.empty()) {
+                    rows.schema = &m_options.schema;
+                }
+
+                if (!m_projection.empty()) {
+                    rows.projection = &m_projection;
+                    rows.columns.resize(m_projection.size());
+                }
+
+                return rows;
+            }
+
+            /**
+             * Helper to take the parse report from newly parsed rows, write its log to stderr and add the rows to the instrumentation counters.
+             *
+             * @param rows The rows. Their report is moved out.
+             * @param byteCount The number of bytes they were parsed from.
+             * @param firstRow The index in the data that the first of the rows has (or will have once appended).
+             */
+            void finishParse(ParsedRows & rows, std::uint64_t byteCount, IndexType firstRow)
+            {
+                Instrumentation::add(Instrumentation::Counter::BytesRead, byteCount);
+                Instrumentation::add(Instrumentation::Counter::RowsParsed, static_cast<std::uint64_t>(rows.rowCount));
+                Instrumentation::add(Instrumentation::Counter::CellsParsed, rows.cellCount);
+                Instrumentation::add(Instrumentation::Counter::EmptyCells, rows.report.emptyCount);
+                Instrumentation::add(Instrumentation::Counter::ParseErrors, rows.report.errorCount);
+                m_parseReport = std::move(rows.report);
+                rows.report = {};
+
+                for (auto & error : m_parseReport.errors) {
+                    error.row += static_cast<std::uint64_t>(firstRow);
+                }
+
+                m_parseReport.write(std::cerr);
+            }
+
+            /**
+             * Helper to append parsed rows to the data.
+             *
+             * @param rows The rows to append.
+             * @return The number of columns there were before the last of the rows.
+             */
+            std::size_t appendParsed(const ParsedRows & rows)
+            {
+                ParsedRows existing;
+                existing.columns = std::move(m_columns);
+                existing.rowCount = m_rowCount;
+                existing.append(rows);
+                m_columns = std::move(existing.columns);
+                m_rowCount = existing.rowCount;
+                invalidateSummaries();
+                return existing.widthBeforeLastRow;
+            }
+
+            /**
+             * Helper to load the data by memory-mapping the file.
+             *
+             * If the options ask for more than one thread and the file is large enough, the content is split into chunks at line boundaries, the chunks are
+             * parsed concurrently and the results are stitched back together in file order. Each cell is parsed exactly as it would be by a single thread,
+             * so the loaded data is identical whatever the thread count.
+             *
+             * @param rows The rows to load into.
+             * @return true if the file was mapped and parsed, false if it can't be mapped and must be streamed instead.
+             */
+            bool loadMapped(ParsedRows & rows)
+            {
+                const MappedFile file(m_file);
+
+                if (!file.isOpen()) {
+                    return false;
+                }
+
+                const auto content = file.content();
+                const auto firstLineEndPos = Csv::findLineEnd(content, m_options.dialect);
+                const auto isHeader = readHeader(content.substr(0, firstLineEndPos));
+                rows = parsedRows();
+                rows.byteCount = file.size();
+
+                if (isHeader && std::string_view::npos == firstLineEndPos) {
+                    return true;
+                }
+
+                const auto chunks = splitIntoChunks(content.substr(isHeader ? firstLineEndPos + 1 : 0), 0 == m_options.threads ? defaultThreadCount() : m_options.threads, m_options.dialect);
+
+                // the offset of the last record in the file, from its offset in the last chunk
+                const auto lastChunkOffset = static_cast<std::uint64_t>(chunks.back().data() - content.data());
+
+                if (1 == chunks.size()) {
+                    loadLines(chunks.front(), true, rows);
+                    rows.lastLineOffset += lastChunkOffset;
+                    return true;
+                }
+
+                std::vector<ParsedRows> parsed(chunks.size());
+
+                for (auto & chunk : parsed) {
+                    chunk = parsedRows();
+                }
+
+                parallelFor(static_cast<unsigned int>(chunks.size()), chunks.size(), [&chunks, &parsed](std::size_t idx) {
+                    loadLines(chunks[idx], idx + 1 == chunks.size(), parsed[idx]);
+                });
+
+                IndexType totalRows = 0;
+
+                for (const auto & chunk : parsed) {
+                    totalRows += chunk.rowCount;
+                }
+
+                const auto byteCount = rows.byteCount;
+                const auto lastLineOffset = lastChunkOffset + parsed.back().lastLineOffset;
+                rows = std::move(parsed.front());
+                rows.byteCount = byteCount;
+                rows.lastLineOffset = lastLineOffset;
+
+                for (auto & column : rows.columns) {
+                    column.reserve(totalRows);
+                }
+
+                for (auto chunk = parsed.begin() + 1; chunk != parsed.end(); ++chunk) {
+                    rows.append(*chunk);
+                    *chunk = {};
+                }
+
+                return true;
+            }
+
+            /**
+             * Helper to split content into roughly equal chunks that each end at a record boundary.
+             *
+             * Every chunk but the last ends with a '\n' that isn't inside a quoted field. No chunk is made smaller than MinimumChunkSize (except the last).
+             *
+             * @param content The content to split.
+             * @param chunkCount The desired number of chunks.
+             * @param dialect The delimiter and quote character.
+             * @return The chunks, in order.
+             */
+            static std::vector<std::string_view> splitIntoChunks(std::string_view content, std::string_view::size_type chunkCount, const Csv::Dialect & dialect)
+            {
+                chunkCount = std::min(chunkCount, content.size() / MinimumChunkSize);
+                std::vector<std::string_view> chunks;
+                std::string_view::size_type chunkStartPos = 0;
+
+                for (std::string_view::size_type idx = 1; idx < chunkCount; ++idx) {
+                    const auto target = content.size() / chunkCount * idx;
+
+                    if (target < chunkStartPos) {
+                        continue;
+                    }
+
+                    // the quotes between the start of the chunk and the target say whether the target is inside a quoted field
+                    const auto isQuoted = Csv::endsInsideQuotes(content.substr(chunkStartPos, target - chunkStartPos), dialect);
+                    const auto lineEndPos = Csv::findLineEnd(content, dialect, target, isQuoted);
+
+                    if (std::string_view::npos == lineEndPos) {
+                        break;
+                    }
+
+                    chunks.push_back(content.substr(chunkStartPos, lineEndPos + 1 - chunkStartPos));
+                    chunkStartPos = lineEndPos + 1;
+                }
+
+                chunks.push_back(content.substr(chunkStartPos));
+                return chunks;
+            }
+
+            /**
+             * Helper to parse a run of records.
+             *
+             * The structural characters (the delimiters and line ends outside quoted fields) are found in bulk by the CSV scanner, which classifies the
+             * content a block at a time with the widest instruction set the CPU supports, and the fields between them are then parsed in order. Records
+             * are split exactly as loadStream() splits them: every line end outside quotes ends a record and, for the final chunk of a file, whatever
+             * follows the last one (even if empty) is the final record. If only some columns are selected, the scanner skips the rest of each record once
+             * its last selected field has been found.
+             *
+             * @param content The content to parse. Must start at the start of a record and, unless it is final, end with a line end.
+             * @param isFinal Whether the content runs to the end of the file.
+             * @param rows The rows to load into. Their lastLineOffset is set to the offset in the content of the start of the last record.
+             */
+            static void loadLines(std::string_view content, bool isFinal, ParsedRows & rows)
+            {
+                std::string_view::size_type fieldStartPos = 0;
+                std::string_view::size_type lineStartPos = 0;
+
+                Csv::scan(content, rows.dialect, [&content, &rows, &fieldStartPos, &lineStartPos](std::size_t pos, bool isLineEnd) -> bool {
+                    loadCell(content.substr(fieldStartPos, pos - fieldStartPos), rows);
+                    fieldStartPos = pos + 1;
+
+                    if (isLineEnd) {
+                        rows.finishRow();
+                        lineStartPos = fieldStartPos;
+                        return false;
+                    }
+
+                    // once a row's last selected field has been parsed, the scanner can skip straight to its line end
+                    return rows.projection && rows.projection->size() == rows.nextSelected;
+                });
+
+                if (isFinal) {
+                    loadCell(content.substr(fieldStartPos), rows);
+                    rows.finishRow();
+                }
+
+                rows.lastLineOffset = lineStartPos;
+            }
+
+            /**
+             * Helper to load the data record-by-record from a stream.
+             *
+             * The first record is checked for a header before the rest are parsed.
+             *
+             * @param in The stream to read.
+             * @param rows The rows to load into.
+             */
+            void loadStream(std::istream & in, ParsedRows & rows)
+            {
+				// read buffer
+				std::string line;
+                bool isFirstLine = true;
+
+				while(!in.eof()) {
+                    rows.lastLineOffset = rows.byteCount;
+                    rows.byteCount += Csv::readRecord(in, m_options.dialect, line);
+
+                    if (isFirstLine) {
+                        // the header can change the column selection, so the rows are only set up once it has been read
+                        isFirstLine = false;
+                        const auto byteCount = rows.byteCount;
+                        const auto isHeader = readHeader(line);
+                        rows = parsedRows();
+                        rows.byteCount = byteCount;
+
+                        if (isHeader) {
+                            continue;
+                        }
+                    }
+
+                    const auto lastLineOffset = rows.lastLineOffset;
+                    loadLines(line, true, rows);
+                    rows.lastLineOffset = lastLineOffset;
+				}
+            }
+
+            /**
+             * Helper to parse a cell with the parser for its column's type.
+             *
+             * @param type The type of the cell's column. Must not be Text.
+             * @param item The content of the cell.
+             * @param value Receives the parsed value. Unchanged unless the item is parsed.
+             * @return The outcome.
+             */
+            static DataItemStatus parseCell(ColumnType type, std::string_view item, ValueType & value)
+            {
+                if (ColumnType::Integer == type) {
+                    return parseIntegerDataItem<ValueType, parser>(item, value);
+                }
+
+                return parseDataItem<ValueType, parser>(item, value);
+            }
+
+            /**
+             * Helper to parse the next field of the row being parsed.
+             *
+             * The content of the field (without its quotes, if it is quoted) is handed to the parser as a view, so no per-cell strings are created. If only
+             * some columns are selected, fields that aren't are stepped over without being converted, as is everything after the last selected field.
+             *
+             * @param field The field, as it is in the content.
+             * @param rows The rows to load into. If they have a projection they must have one column per selected column.
+             */
+            static void loadCell(std::string_view field, ParsedRows & rows)
+            {
+                const auto source = rows.rowWidth++;
+
+                if (0 == source) {
+                    rows.widthBeforeLastRow = rows.columns.size();
+                }
+
+                if (rows.projection) {
+                    const auto & projection = *rows.projection;
+
+                    if (projection.size() == rows.nextSelected || projection[rows.nextSelected].source != source) {
+                        return;
+                    }
+
+                    const auto item = Csv::unquote(field, rows.dialect);
+
+                    // a column selected more than once is parsed as the type of its first selection
+                    const auto type = rows.typeOf(projection[rows.nextSelected].column, item);
+                    ValueType value{};
+                    auto status = DataItemStatus::Empty;
+
+                    if (ColumnType::Text != type) {
+                        status = parseCell(type, item, value);
+
+                        if (DataItemStatus::Ok != status) {
+                            rows.recordFailure(status, source, item);
+                        }
+                    }
+
+                    // the same file column can be selected more than once
+                    for (; projection.size() != rows.nextSelected && projection[rows.nextSelected].source == source; ++rows.nextSelected) {
+                        if (DataItemStatus::Ok == status) {
+                            rows.columns[projection[rows.nextSelected].column].append(value);
+                        } else {
+                            rows.columns[projection[rows.nextSelected].column].appendMissing();
+                        }
+                    }
+
+                    ++rows.rowCellCount;
+                    return;
+                }
+
+                auto & column = rows.columnForAppend(source);
+                const auto item = Csv::unquote(field, rows.dialect);
+                const auto type = rows.typeOf(source, item);
+                ValueType value{};
+
+                if (ColumnType::Text == type) {
+                    column.appendMissing();
+                } else if (const auto status = parseCell(type, item, value); DataItemStatus::Ok == status) {
+                    column.append(value);
+                } else {
+                    rows.recordFailure(status, source, item);
+                    column.appendMissing();
+                }
+
+                ++rows.rowCellCount;
+            }
+
+            /**
+             * The parsed data, one entry per column.
+             */
+            DataStorage m_columns;
+
+            /**
+             * The number of rows in the data.
+             */
+            IndexType m_rowCount = 0;
 
             /**
              * The path to the file containing the data.
              */
 			std::string m_file;
+
+            /**
+             * The options controlling how the file is loaded.
+             */
+            LoadOptions m_options;
+
+            /**
+             * The columns selected in the options, by their index in the file, in the order they appear in the data. Columns selected by a name that
+             * the header doesn't have are -1. Empty when every column is loaded.
+             */
+            std::vector<IndexType> m_selection;
+
+            /**
+             * The selected columns, in file order. Empty when every column is loaded.
+             */
+            Projection m_projection;
+
+            /**
+             * Whether the first line of the file is a header.
+             */
+            bool m_hasHeader = false;
+
+            /**
+             * The names the header gives the file's columns, in file order.
+             */
+            std::vector<std::string> m_columnNames;
+
+            /**
+             * The index in the file of the first column with each name in the header.
+             */
+            std::unordered_map<std::string, IndexType> m_columnIndex;
+
+            /**
+             * The position of the final line of the file. Empty if the data didn't come from a file.
+             */
+            std::optional<Tail> m_tail;
+
+            /**
+             * The stamp of the source file as it was when the data was read. Empty if the data doesn't match a source file.
+             */
+            std::optional<SourceStamp> m_sourceStamp;
+
+            /**
+             * Whether the data was mapped from a binary cache.
+             */
+            bool m_fromCache = false;
+
+            /**
+             * The cells that could not be parsed when the data was last read (or rows were last appended to it).
+             */
+            ParseReport m_parseReport;
+
+            /**
+             * The cached column summaries.
+             */
+            mutable SummaryCache m_summaries;
 	};
 }
 
@@ -0,0 +1,186 @@
+#ifndef STATISTICS_DATAFILEWRITER_H
+#define STATISTICS_DATAFILEWRITER_H
+
+#include <charconv>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "DataFile.h"
+
+namespace Statistics
+{
+    /**
+     * Writes the content of a DataFile as text, one line per row.
+     *
+     * Each cell is written in fixed notation with a given number of digits after the decimal point, followed by two spaces; empty cells are written as
+     * "nan". The output is byte-for-byte what writing each item to a stream with std::fixed and std::setprecision() produces, but cells are formatted
+     * with std::to_chars() into a reusable buffer that is handed to the stream in large blocks, which avoids the stream's per-item locale and formatting
+     * overhead.
+     *
+     * A writer can be reused for any number of DataFiles; its buffer is allocated once.
+     */
+    class DataFileWriter
+    {
+        public:
+            /**
+             * The size of the output buffer used by default.
+             */
+            static constexpr std::size_t DefaultBufferSize = 1024 * 1024;
+
+            /**
+             * The separator written after each cell.
+             */
+            static constexpr std::string_view Separator = "  ";
+
+            /**
+             * Initialise a new writer.
+             *
+             * @param precision The number of digits after the decimal point.
+             * @param bufferSize The size of the output buffer. It is never smaller than MinimumBufferSize.
+             */
+            explicit DataFileWriter(int precision = 3, std::size_t bufferSize = DefaultBufferSize)
+            :   m_precision(precision),
+                m_buffer(std::max(bufferSize, MinimumBufferSize))
+            {}
+
+            /**
+             * Fetch the number of digits written after the decimal point.
+             */
+            [[nodiscard]] inline int precision() const
+            {
+                return m_precision;
+            }
+
+            /**
+             * Write a DataFile to a stream.
+             *
+             * @tparam ValueType The (inferred) value type for the data file.
+             * @tparam parser The (inferred) parser for the data file.
+             * @tparam Accumulator The (inferred) accumulation policy for the data file.
+             * @param out The stream to write to.
+             * @param data The DataFile to write.
+             * @return true if everything was written, false if the stream failed.
+             */
+            template<class ValueType, DataItemParser<ValueType> parser, class Accumulator>
+            bool write(std::ostream & out, const DataFile<ValueType, parser, Accumulator> & data)
+            {
+                using IndexType = typename DataFile<ValueType, parser, Accumulator>::IndexType;
+                std::vector<const ValueType *> columns;
+
+                for (IndexType col = 0; col < data.columnCount(); ++col) {
+                    columns.push_back(data.columnView(col).data());
+                }
+
+                m_used = 0;
+
+                for (IndexType row = 0; row < data.rowCount(); ++row) {
+                    for (const auto * column : columns) {
+                        writeCell(out, column[row]);
+                    }
+
+                    if (m_used == m_buffer.size()) {
+                        flush(out);
+                    }
+
+                    m_buffer[m_used++] = '\n';
+                }
+
+                flush(out);
+                return static_cast<bool>(out);
+            }
+
+        private:
+            /**
+             * The smallest buffer that can hold any single cell.
+             *
+             * The longest fixed-notation value is the largest finite long double, which has 4933 digits before the decimal point.
+             */
+            static constexpr std::size_t MinimumBufferSize = 8192;
+
+            /**
+             * Write one cell (and its separator) to the buffer, flushing it first if it's full.
+             *
+             * @param out The stream the buffer is flushed to.
+             * @param value The value of the cell.
+             */
+            template<class ValueType>
+            void writeCell(std::ostream & out, const ValueType & value)
+            {
+                if (!appendCell(value)) {
+                    flush(out);
+                    appendCell(value);
+                }
+            }
+
+            /**
+             * Format one cell (and its separator) into the free space in the buffer.
+             *
+             * @param value The value of the cell.
+             * @return true if the cell was written, false if there wasn't enough space.
+             */
+            template<class ValueType>
+            bool appendCell(const ValueType & value)
+            {
+                auto * begin = m_buffer.data() + m_used;
+                auto * end = m_buffer.data() + m_buffer.size();
+                std::to_chars_result result{};
+
+                if constexpr (std::is_floating_point_v<ValueType>) {
+                    result = std::to_chars(begin, end, value, std::chars_format::fixed, m_precision);
+                } else if constexpr (std::is_integral_v<ValueType>) {
+                    result = std::to_chars(begin, end, value);
+                } else {
+                    // anything else is formatted by its own stream insertion operator
+                    std::ostringstream cell;
+                    cell << std::fixed << std::setprecision(m_precision) << value;
+                    const auto text = cell.str();
+
+                    if (text.size() > static_cast<std::size_t>(end - begin)) {
+                        return false;
+                    }
+
+                    result = {std::copy(text.cbegin(), text.cend(), begin), std::errc()};
+                }
+
+                if (std::errc() != result.ec || Separator.size() > static_cast<std::size_t>(end - result.ptr)) {
+                    return false;
+                }
+
+                m_used = static_cast<std::size_t>(std::copy(Separator.cbegin(), Separator.cend(), result.ptr) - m_buffer.data());
+                return true;
+            }
+
+            /**
+             * Hand the content of the buffer to the stream and empty it.
+             *
+             * @param out The stream.
+             */
+            void flush(std::ostream & out)
+            {
+                out.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+                m_used = 0;
+            }
+
+            /**
+             * The number of digits written after the decimal point.
+             */
+            int m_precision;
+
+            /**
+             * The output buffer.
+             */
+            std::vector<char> m_buffer;
+
+            /**
+             * The number of bytes of the buffer in use.
+             */
+            std::size_t m_used = 0;
+    };
+}
+
+#endif
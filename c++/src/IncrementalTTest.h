@@ -0,0 +1,255 @@
+#ifndef STATISTICS_INCREMENTALTTEST_H
+#define STATISTICS_INCREMENTALTTEST_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "TTest.h"
+
+namespace Statistics
+{
+    /**
+     * A t-test on a DataFile that grows, updated as rows are appended rather than recalculated.
+     *
+     * The test keeps running moments for its two columns and their paired differences (see StreamingTTest), so adding a row costs O(1) however many
+     * rows the data already has. Rows can be appended through the test with appendRow(), appended to the data directly and picked up with update(), or
+     * read from the end of a growing file with refresh(). When refresh() re-reads the file's final line (because it may have been only partly written
+     * when last read) the row parsed from it is taken back out of the moments before its replacement is added.
+     *
+     * Moments for every type of test are maintained, so the type can be changed at any point.
+     *
+     * @tparam T The underlying data type for the values to be tested. See TTest.
+     * @tparam Accumulator The policy used to accumulate sums. See TTest. Its ValueType is the type in which the moments are accumulated.
+     */
+    template<class T = long double, class Accumulator = NaiveSum<T>>
+    class IncrementalTTest
+    {
+        public:
+            /**
+             * Alias for the single test type whose data types the incremental test shares.
+             */
+            using TestType = TTest<T, Accumulator>;
+
+            /**
+             * Alias for the type of numeric data.
+             */
+            using ValueType = typename TestType::ValueType;
+
+            /**
+             * Alias for the type in which the statistic is calculated.
+             */
+            using ResultType = typename TestType::ResultType;
+
+            /**
+             * Alias for the type of DataFile the test runs on.
+             */
+            using DataFileType = typename TestType::DataFileType;
+
+            /**
+             * Alias for the shared pointer to the DataFile.
+             */
+            using DataFilePtr = typename TestType::DataFilePtr;
+
+            /**
+             * Alias for the type of row and column indices.
+             */
+            using IndexType = typename DataFileType::IndexType;
+
+            /**
+             * Initialise a new incremental t-test.
+             *
+             * The rows already in the data are added to the moments, which costs O(rows) once.
+             *
+             * @param data The data to process. Shared with the caller.
+             * @param type The type of test.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit IncrementalTTest(DataFilePtr data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   m_data(std::move(data)),
+                m_first(first),
+                m_second(second),
+                m_moments(type)
+            {
+                update();
+            }
+
+            /**
+             * Initialise a new incremental t-test.
+             *
+             * @param data The data to process. Moved into the test.
+             * @param type The type of test.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit IncrementalTTest(DataFileType && data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   IncrementalTTest(std::make_shared<DataFileType>(std::move(data)), type, first, second)
+            {}
+
+            /**
+             * Fetch a reference to the data.
+             */
+            [[nodiscard]] inline const DataFileType & data() const
+            {
+                return *m_data;
+            }
+
+            /**
+             * Fetch the shared pointer to the data.
+             */
+            [[nodiscard]] inline DataFilePtr dataPtr() const
+            {
+                return m_data;
+            }
+
+            /**
+             * Fetch the type of test.
+             */
+            [[nodiscard]] inline TTestType type() const
+            {
+                return m_moments.type();
+            }
+
+            /**
+             * Set the type of test.
+             */
+            inline void setType(const TTestType & type)
+            {
+                m_moments.setType(type);
+            }
+
+            /**
+             * The number of rows of the data that the moments cover.
+             */
+            [[nodiscard]] inline IndexType rowCount() const
+            {
+                return m_rowCount;
+            }
+
+            /**
+             * Append a row to the data and add it to the test.
+             *
+             * The row has a cell for each column up to the later of the test's two columns; the others are empty.
+             *
+             * @param x1 The value for the first condition. NaN if missing.
+             * @param x2 The value for the second condition. NaN if missing.
+             */
+            void appendRow(const ValueType & x1, const ValueType & x2)
+            {
+                update();
+                std::vector<ValueType> row(static_cast<std::size_t>(std::max(m_first, m_second) + 1), Column<ValueType>::missingValue());
+                row[static_cast<std::size_t>(m_first)] = x1;
+                row[static_cast<std::size_t>(m_second)] = x2;
+                m_data->appendRow(row);
+                update();
+            }
+
+            /**
+             * Add to the test any rows that have been appended to the data since it was last updated.
+             *
+             * @return The number of rows added.
+             */
+            IndexType update()
+            {
+                const auto previousRowCount = m_rowCount;
+
+                for (; m_rowCount < m_data->rowCount(); ++m_rowCount) {
+                    m_moments.addRow(cell(m_rowCount, m_first), cell(m_rowCount, m_second));
+                }
+
+                return m_rowCount - previousRowCount;
+            }
+
+            /**
+             * Read whatever has been appended to the data's file and update the test.
+             *
+             * See DataFile::refresh(). Normally only the row from the file's previous final line is replaced, which is taken back out of the moments in
+             * O(1); if the file has been replaced the moments are rebuilt from scratch.
+             *
+             * @return The index of the first row that may have changed. This is the row count from before the refresh if nothing changed.
+             */
+            IndexType refresh()
+            {
+                update();
+                const auto previousRowCount = m_rowCount;
+                const auto lastRow = previousRowCount - 1;
+                const auto lastRowValues = (0 < previousRowCount ? std::make_pair(cell(lastRow, m_first), cell(lastRow, m_second)) : std::make_pair(ResultType(NAN), ResultType(NAN)));
+                const auto firstChanged = m_data->refresh();
+
+                if (firstChanged >= previousRowCount) {
+                    return previousRowCount;
+                }
+
+                if (firstChanged == lastRow) {
+                    m_moments.removeRow(lastRowValues.first, lastRowValues.second);
+                    m_rowCount = lastRow;
+                } else {
+                    m_moments.reset();
+                    m_rowCount = 0;
+                }
+
+                update();
+                return firstChanged;
+            }
+
+            /**
+             * Calculate t for the rows added so far.
+             *
+             * Matches TTest::t() for the same data: paired t is signed, unpaired t is always positive.
+             */
+            [[nodiscard]] inline ResultType t() const
+            {
+                return m_moments.t();
+            }
+
+            /**
+             * Calculate t, its degrees of freedom and the p-values for the rows added so far.
+             */
+            [[nodiscard]] inline TTestResult<ResultType> result() const
+            {
+                return m_moments.result();
+            }
+
+        private:
+            /**
+             * Helper to fetch a cell of the data as the moments' type, NaN if it is empty or beyond the width of the data.
+             */
+            ResultType cell(const IndexType & row, const IndexType & col) const
+            {
+                if (col >= m_data->columnCount()) {
+                    return NAN;
+                }
+
+                const auto & column = m_data->column(col);
+                return column.isValid(static_cast<std::size_t>(row)) ? static_cast<ResultType>(column[static_cast<std::size_t>(row)]) : ResultType(NAN);
+            }
+
+            /**
+             * The data.
+             */
+            DataFilePtr m_data;
+
+            /**
+             * The column for the first condition.
+             */
+            IndexType m_first;
+
+            /**
+             * The column for the second condition.
+             */
+            IndexType m_second;
+
+            /**
+             * The number of rows of the data added to the moments.
+             */
+            IndexType m_rowCount = 0;
+
+            /**
+             * The running moments.
+             */
+            StreamingTTest<ResultType> m_moments;
+    };
+}
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef STATISTICS_INSTRUMENTATION_H
+#define STATISTICS_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+/**
+ * Define STATISTICS_INSTRUMENTATION to 1 to compile the timers and counters into the library. When it is 0 (the default) every timer and counter is an
+ * empty inline function that the compiler removes entirely.
+ */
+#if !defined(STATISTICS_INSTRUMENTATION)
+#define STATISTICS_INSTRUMENTATION 0
+#endif
+
+namespace Statistics::Instrumentation
+{
+    /**
+     * Whether the timers and counters are compiled in.
+     */
+    constexpr bool Enabled = (0 != STATISTICS_INSTRUMENTATION);
+
+    /**
+     * The things that are counted.
+     */
+    enum class Counter : std::size_t
+    {
+        BytesRead = 0,
+        RowsParsed,
+        CellsParsed,
+        EmptyCells,
+        ParseErrors,
+        CacheLoads,
+        SummariesCalculated,
+        Allocations,
+        AllocatedBytes,
+    };
+
+    /**
+     * The number of counters.
+     */
+    constexpr std::size_t CounterCount = static_cast<std::size_t>(Counter::AllocatedBytes) + 1;
+
+    /**
+     * The phases that are timed.
+     *
+     * Phases can nest: Load includes Parse or CacheRead, and Statistic includes any Summary calculated for it.
+     */
+    enum class Phase : std::size_t
+    {
+        Load = 0,
+        Parse,
+        CacheRead,
+        CacheWrite,
+        Output,
+        Summary,
+        Statistic,
+    };
+
+    /**
+     * The number of phases.
+     */
+    constexpr std::size_t PhaseCount = static_cast<std::size_t>(Phase::Statistic) + 1;
+
+    /**
+     * The running totals of the counters and timers.
+     *
+     * Totals are process-wide and updated with relaxed atomics, so they can be updated from several threads at once. Instrumentation is placed around
+     * whole phases and batches of work, never inside per-cell loops, so the totals are updated only a handful of times per load or test.
+     */
+    struct Totals
+    {
+        std::array<std::atomic<std::uint64_t>, CounterCount> counters{};
+        std::array<std::atomic<std::uint64_t>, PhaseCount> nanoseconds{};
+        std::array<std::atomic<std::uint64_t>, PhaseCount> calls{};
+    };
+
+    /**
+     * The process-wide totals.
+     */
+    inline Totals totals;
+
+    /**
+     * Add to a counter.
+     *
+     * @param counter The counter.
+     * @param amount The amount to add.
+     */
+    inline void add(Counter counter, std::uint64_t amount = 1) noexcept
+    {
+        if constexpr (Enabled) {
+            totals.counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Fetch the value of a counter.
+     *
+     * @param counter The counter.
+     * @return The value. Always 0 if instrumentation is not compiled in.
+     */
+    [[nodiscard]] inline std::uint64_t value(Counter counter) noexcept
+    {
+        return totals.counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Fetch the total time spent in a phase.
+     *
+     * @param phase The phase.
+     * @return The time. Always 0 if instrumentation is not compiled in.
+     */
+    [[nodiscard]] inline std::chrono::nanoseconds elapsed(Phase phase) noexcept
+    {
+        return std::chrono::nanoseconds(totals.nanoseconds[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed));
+    }
+
+    /**
+     * Fetch the number of times a phase has been entered.
+     *
+     * @param phase The phase.
+     * @return The count. Always 0 if instrumentation is not compiled in.
+     */
+    [[nodiscard]] inline std::uint64_t calls(Phase phase) noexcept
+    {
+        return totals.calls[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Set all counters and timers back to 0.
+     */
+    inline void reset() noexcept
+    {
+        for (auto & counter : totals.counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        for (std::size_t phase = 0; phase < PhaseCount; ++phase) {
+            totals.nanoseconds[phase].store(0, std::memory_order_relaxed);
+            totals.calls[phase].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Adds the wall time between its construction and destruction to a phase.
+     *
+     * When instrumentation is not compiled in, constructing and destroying a timer does nothing and the clock is never read.
+     */
+    class ScopedTimer
+    {
+        public:
+            /**
+             * The clock used for timing.
+             */
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * Start timing a phase.
+             *
+             * @param phase The phase.
+             */
+            explicit ScopedTimer(Phase phase) noexcept
+            :   m_phase(phase)
+            {
+                if constexpr (Enabled) {
+                    m_start = Clock::now();
+                }
+            }
+
+            ScopedTimer(const ScopedTimer &) = delete;
+            ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+            /**
+             * Stop timing and add the time to the phase.
+             */
+            ~ScopedTimer()
+            {
+                if constexpr (Enabled) {
+                    const auto idx = static_cast<std::size_t>(m_phase);
+                    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+                    totals.nanoseconds[idx].fetch_add(static_cast<std::uint64_t>(nanoseconds), std::memory_order_relaxed);
+                    totals.calls[idx].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            /**
+             * The phase being timed.
+             */
+            Phase m_phase;
+
+            /**
+             * When timing started.
+             */
+            Clock::time_point m_start;
+    };
+
+    /**
+     * The name of a counter, for reports.
+     */
+    [[nodiscard]] constexpr const char * name(Counter counter) noexcept
+    {
+        constexpr const char * names[CounterCount] = {"bytes read", "rows parsed", "cells parsed", "empty cells", "parse errors", "cache loads", "summaries calculated", "allocations", "allocated bytes"};
+        return names[static_cast<std::size_t>(counter)];
+    }
+
+    /**
+     * The name of a phase, for reports.
+     */
+    [[nodiscard]] constexpr const char * name(Phase phase) noexcept
+    {
+        constexpr const char * names[PhaseCount] = {"load", "parse", "cache read", "cache write", "output", "summary", "statistic"};
+        return names[static_cast<std::size_t>(phase)];
+    }
+
+    /**
+     * Write a report of the counters and timers.
+     *
+     * Each counter is written on its own line, followed by each phase that was entered with its total wall time in milliseconds and the number of
+     * times it was entered.
+     *
+     * @param out The stream to write to.
+     */
+    inline void report(std::ostream & out)
+    {
+        if constexpr (!Enabled) {
+            out << "stats: instrumentation was not compiled in (build with STATISTICS_INSTRUMENTATION=1)\n";
+            return;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::left;
+
+        for (std::size_t idx = 0; idx < CounterCount; ++idx) {
+            const auto counter = static_cast<Counter>(idx);
+            out << "stats: " << std::setw(22) << name(counter) << value(counter) << "\n";
+        }
+
+        out << std::fixed << std::setprecision(3);
+
+        for (std::size_t idx = 0; idx < PhaseCount; ++idx) {
+            const auto phase = static_cast<Phase>(idx);
+
+            if (0 == calls(phase)) {
+                continue;
+            }
+
+            out << "stats: " << std::setw(22) << (std::string(name(phase)) + " time") << std::chrono::duration<double, std::milli>(elapsed(phase)).count()
+                << " ms (" << calls(phase) << (1 == calls(phase) ? " call" : " calls") << ")\n";
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
+
+#endif
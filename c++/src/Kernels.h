@@ -0,0 +1,570 @@
+#ifndef STATISTICS_KERNELS_H
+#define STATISTICS_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STATISTICS_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace Statistics::Kernels
+{
+    /**
+     * The instruction sets for which reduction kernels are available.
+     */
+    enum class InstructionSet
+    {
+        Scalar = 0,
+        Avx2,
+        Avx512,
+    };
+
+    /**
+     * Whether vectorised kernels exist for a value type.
+     *
+     * long double can't be vectorised on x86, so it always uses the generic scalar code in DataFile and TTest.
+     */
+    template<class T>
+    constexpr bool HasKernels = std::is_same_v<T, double> || std::is_same_v<T, float>;
+
+    /**
+     * Check whether the CPU (and OS) support an instruction set.
+     */
+    [[nodiscard]] inline bool isSupported(InstructionSet set)
+    {
+        switch (set) {
+            case InstructionSet::Scalar:
+                return true;
+
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case InstructionSet::Avx2:
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+            case InstructionSet::Avx512:
+                return __builtin_cpu_supports("avx512f");
+#endif
+
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * The best instruction set supported by the CPU. Determined once, on first use.
+     */
+    [[nodiscard]] inline InstructionSet bestInstructionSet()
+    {
+        static const InstructionSet best = []() {
+            if (isSupported(InstructionSet::Avx512)) {
+                return InstructionSet::Avx512;
+            }
+
+            if (isSupported(InstructionSet::Avx2)) {
+                return InstructionSet::Avx2;
+            }
+
+            return InstructionSet::Scalar;
+        }();
+
+        return best;
+    }
+
+    /**
+     * Sums of paired differences.
+     */
+    template<class T>
+    struct DifferenceSums
+    {
+        /**
+         * The number of complete pairs.
+         */
+        std::size_t count = 0;
+
+        /**
+         * sum(a[i] - b[i])
+         */
+        T sum = 0;
+
+        /**
+         * sum((a[i] - b[i]) ^ 2)
+         */
+        T sumSquares = 0;
+    };
+
+    /**
+     * Portable reference kernels.
+     *
+     * These are plain loops, in the same order as the generic code in DataFile and TTest, and produce identical results to it. NaN values (missing cells)
+     * are skipped; the paired kernel skips every pair with a value missing from either side.
+     */
+    namespace Scalar
+    {
+        template<class T>
+        T sum(const T * values, std::size_t count)
+        {
+            T sum = 0;
+
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                if (!std::isnan(values[idx])) {
+                    sum += values[idx];
+                }
+            }
+
+            return sum;
+        }
+
+        template<class T>
+        T sumSquares(const T * values, std::size_t count)
+        {
+            T sum = 0;
+
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                if (!std::isnan(values[idx])) {
+                    sum += values[idx] * values[idx];
+                }
+            }
+
+            return sum;
+        }
+
+        template<class T>
+        T sumSquaredDeviations(const T * values, std::size_t count, T mean)
+        {
+            T sum = 0;
+
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                if (!std::isnan(values[idx])) {
+                    const T deviation = values[idx] - mean;
+                    sum += deviation * deviation;
+                }
+            }
+
+            return sum;
+        }
+
+        template<class T>
+        DifferenceSums<T> differenceSums(const T * first, const T * second, std::size_t count)
+        {
+            DifferenceSums<T> sums;
+
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                const T diff = first[idx] - second[idx];
+
+                if (!std::isnan(diff)) {
+                    ++sums.count;
+                    sums.sum += diff;
+                    sums.sumSquares += diff * diff;
+                }
+            }
+
+            return sums;
+        }
+    }
+
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+    /**
+     * AVX2 kernels.
+     *
+     * Each kernel runs two independent vector accumulators to hide the add latency, then reduces them and finishes the tail with scalar code. Missing
+     * cells are excluded by masking with an ordered (not-NaN) comparison. Because the additions happen in a different order from the scalar kernels, the
+     * results may differ from them in the last few bits.
+     */
+    namespace Avx2
+    {
+        /**
+         * Per-type wrappers for the AVX2 intrinsics used by the kernels.
+         */
+        template<class T>
+        struct Ops;
+
+        template<>
+        struct Ops<double>
+        {
+            using Vector = __m256d;
+            static constexpr std::size_t Width = 4;
+
+            __attribute__((target("avx2,fma"))) static inline Vector zero() { return _mm256_setzero_pd(); }
+            __attribute__((target("avx2,fma"))) static inline Vector broadcast(double value) { return _mm256_set1_pd(value); }
+            __attribute__((target("avx2,fma"))) static inline Vector load(const double * ptr) { return _mm256_loadu_pd(ptr); }
+            __attribute__((target("avx2,fma"))) static inline Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+            __attribute__((target("avx2,fma"))) static inline Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+            __attribute__((target("avx2,fma"))) static inline Vector fmadd(Vector a, Vector b, Vector c) { return _mm256_fmadd_pd(a, b, c); }
+            __attribute__((target("avx2,fma"))) static inline Vector present(Vector a) { return _mm256_and_pd(a, _mm256_cmp_pd(a, a, _CMP_ORD_Q)); }
+            __attribute__((target("avx2,fma"))) static inline std::size_t presentCount(Vector a) { return static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(a, a, _CMP_ORD_Q))))); }
+
+            __attribute__((target("avx2,fma"))) static inline double reduce(Vector a)
+            {
+                const auto pair = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+            }
+        };
+
+        template<>
+        struct Ops<float>
+        {
+            using Vector = __m256;
+            static constexpr std::size_t Width = 8;
+
+            __attribute__((target("avx2,fma"))) static inline Vector zero() { return _mm256_setzero_ps(); }
+            __attribute__((target("avx2,fma"))) static inline Vector broadcast(float value) { return _mm256_set1_ps(value); }
+            __attribute__((target("avx2,fma"))) static inline Vector load(const float * ptr) { return _mm256_loadu_ps(ptr); }
+            __attribute__((target("avx2,fma"))) static inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+            __attribute__((target("avx2,fma"))) static inline Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+            __attribute__((target("avx2,fma"))) static inline Vector fmadd(Vector a, Vector b, Vector c) { return _mm256_fmadd_ps(a, b, c); }
+            __attribute__((target("avx2,fma"))) static inline Vector present(Vector a) { return _mm256_and_ps(a, _mm256_cmp_ps(a, a, _CMP_ORD_Q)); }
+            __attribute__((target("avx2,fma"))) static inline std::size_t presentCount(Vector a) { return static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(a, a, _CMP_ORD_Q))))); }
+
+            __attribute__((target("avx2,fma"))) static inline float reduce(Vector a)
+            {
+                auto quad = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+                quad = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+                return _mm_cvtss_f32(_mm_add_ss(quad, _mm_movehdup_ps(quad)));
+            }
+        };
+
+        template<class T>
+        __attribute__((target("avx2,fma"))) T sum(const T * values, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                acc0 = O::add(acc0, O::present(O::load(values + idx)));
+                acc1 = O::add(acc1, O::present(O::load(values + idx + O::Width)));
+            }
+
+            return O::reduce(O::add(acc0, acc1)) + Scalar::sum(values + idx, count - idx);
+        }
+
+        template<class T>
+        __attribute__((target("avx2,fma"))) T sumSquares(const T * values, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                const auto x0 = O::present(O::load(values + idx));
+                const auto x1 = O::present(O::load(values + idx + O::Width));
+                acc0 = O::fmadd(x0, x0, acc0);
+                acc1 = O::fmadd(x1, x1, acc1);
+            }
+
+            return O::reduce(O::add(acc0, acc1)) + Scalar::sumSquares(values + idx, count - idx);
+        }
+
+        template<class T>
+        __attribute__((target("avx2,fma"))) T sumSquaredDeviations(const T * values, std::size_t count, T mean)
+        {
+            using O = Ops<T>;
+            const auto vMean = O::broadcast(mean);
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            // NaN - mean is still NaN, so masking after the subtraction drops missing cells
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                const auto d0 = O::present(O::sub(O::load(values + idx), vMean));
+                const auto d1 = O::present(O::sub(O::load(values + idx + O::Width), vMean));
+                acc0 = O::fmadd(d0, d0, acc0);
+                acc1 = O::fmadd(d1, d1, acc1);
+            }
+
+            return O::reduce(O::add(acc0, acc1)) + Scalar::sumSquaredDeviations(values + idx, count - idx, mean);
+        }
+
+        template<class T>
+        __attribute__((target("avx2,fma"))) DifferenceSums<T> differenceSums(const T * first, const T * second, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto sum = O::zero();
+            auto sumSquares = O::zero();
+            std::size_t pairs = 0;
+            std::size_t idx = 0;
+
+            // a missing value on either side makes the difference NaN, so masking the difference drops incomplete pairs
+            for (; idx + O::Width <= count; idx += O::Width) {
+                const auto rawDiff = O::sub(O::load(first + idx), O::load(second + idx));
+                const auto diff = O::present(rawDiff);
+                pairs += O::presentCount(rawDiff);
+                sum = O::add(sum, diff);
+                sumSquares = O::fmadd(diff, diff, sumSquares);
+            }
+
+            auto tail = Scalar::differenceSums(first + idx, second + idx, count - idx);
+            return {pairs + tail.count, O::reduce(sum) + tail.sum, O::reduce(sumSquares) + tail.sumSquares};
+        }
+    }
+
+    /**
+     * AVX-512 kernels.
+     *
+     * As for the AVX2 kernels, but missing cells are excluded using mask registers and the tail is handled with a masked load rather than scalar code.
+     */
+    namespace Avx512
+    {
+        /**
+         * Per-type wrappers for the AVX-512 intrinsics used by the kernels.
+         */
+        template<class T>
+        struct Ops;
+
+        template<>
+        struct Ops<double>
+        {
+            using Vector = __m512d;
+            using Mask = __mmask8;
+            static constexpr std::size_t Width = 8;
+
+            __attribute__((target("avx512f"))) static inline Vector zero() { return _mm512_setzero_pd(); }
+            __attribute__((target("avx512f"))) static inline Vector broadcast(double value) { return _mm512_set1_pd(value); }
+            __attribute__((target("avx512f"))) static inline Vector load(const double * ptr) { return _mm512_loadu_pd(ptr); }
+            __attribute__((target("avx512f"))) static inline Mask first(std::size_t count) { return static_cast<Mask>((1U << count) - 1); }
+            __attribute__((target("avx512f"))) static inline Vector loadFirst(const double * ptr, std::size_t count) { return _mm512_maskz_loadu_pd(first(count), ptr); }
+            __attribute__((target("avx512f"))) static inline Vector sub(Vector a, Vector b) { return _mm512_sub_pd(a, b); }
+            __attribute__((target("avx512f"))) static inline Vector add(Vector a, Vector b) { return _mm512_add_pd(a, b); }
+            __attribute__((target("avx512f"))) static inline Vector fmadd(Vector a, Vector b, Vector c) { return _mm512_fmadd_pd(a, b, c); }
+            __attribute__((target("avx512f"))) static inline Mask present(Vector a) { return _mm512_cmp_pd_mask(a, a, _CMP_ORD_Q); }
+            __attribute__((target("avx512f"))) static inline Vector maskAdd(Vector acc, Mask mask, Vector a) { return _mm512_mask_add_pd(acc, mask, acc, a); }
+            __attribute__((target("avx512f"))) static inline Vector maskFmadd(Vector a, Mask mask, Vector b, Vector acc) { return _mm512_mask3_fmadd_pd(a, b, acc, mask); }
+
+            __attribute__((target("avx512f"))) static inline double reduce(Vector a)
+            {
+                // the halves are extracted with a zeroing mask: the unmasked extract (and _mm512_reduce_add_pd(), which uses it) starts from an
+                // undefined vector that GCC reports as uninitialised
+                const auto half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xff, a, 0), _mm512_maskz_extractf64x4_pd(0xff, a, 1));
+                const auto pair = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+            }
+        };
+
+        template<>
+        struct Ops<float>
+        {
+            using Vector = __m512;
+            using Mask = __mmask16;
+            static constexpr std::size_t Width = 16;
+
+            __attribute__((target("avx512f"))) static inline Vector zero() { return _mm512_setzero_ps(); }
+            __attribute__((target("avx512f"))) static inline Vector broadcast(float value) { return _mm512_set1_ps(value); }
+            __attribute__((target("avx512f"))) static inline Vector load(const float * ptr) { return _mm512_loadu_ps(ptr); }
+            __attribute__((target("avx512f"))) static inline Mask first(std::size_t count) { return static_cast<Mask>((1U << count) - 1); }
+            __attribute__((target("avx512f"))) static inline Vector loadFirst(const float * ptr, std::size_t count) { return _mm512_maskz_loadu_ps(first(count), ptr); }
+            __attribute__((target("avx512f"))) static inline Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+            __attribute__((target("avx512f"))) static inline Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+            __attribute__((target("avx512f"))) static inline Vector fmadd(Vector a, Vector b, Vector c) { return _mm512_fmadd_ps(a, b, c); }
+            __attribute__((target("avx512f"))) static inline Mask present(Vector a) { return _mm512_cmp_ps_mask(a, a, _CMP_ORD_Q); }
+            __attribute__((target("avx512f"))) static inline Vector maskAdd(Vector acc, Mask mask, Vector a) { return _mm512_mask_add_ps(acc, mask, acc, a); }
+            __attribute__((target("avx512f"))) static inline Vector maskFmadd(Vector a, Mask mask, Vector b, Vector acc) { return _mm512_mask3_fmadd_ps(a, b, acc, mask); }
+
+            __attribute__((target("avx512f"))) static inline float reduce(Vector a)
+            {
+                // as for double; the halves are extracted as doubles since the 256-bit float extract needs AVX512DQ
+                const auto bits = _mm512_castps_pd(a);
+                const auto half = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, bits, 0)), _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, bits, 1)));
+                auto quad = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+                quad = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+                return _mm_cvtss_f32(_mm_add_ss(quad, _mm_movehdup_ps(quad)));
+            }
+        };
+
+        template<class T>
+        __attribute__((target("avx512f"))) T sum(const T * values, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                const auto x0 = O::load(values + idx);
+                const auto x1 = O::load(values + idx + O::Width);
+                acc0 = O::maskAdd(acc0, O::present(x0), x0);
+                acc1 = O::maskAdd(acc1, O::present(x1), x1);
+            }
+
+            // masked-off lanes of the tail load are zero, which doesn't change the sum
+            for (; idx < count; idx += O::Width) {
+                const auto x = O::loadFirst(values + idx, std::min(O::Width, count - idx));
+                acc0 = O::maskAdd(acc0, O::present(x), x);
+            }
+
+            return O::reduce(O::add(acc0, acc1));
+        }
+
+        template<class T>
+        __attribute__((target("avx512f"))) T sumSquares(const T * values, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                const auto x0 = O::load(values + idx);
+                const auto x1 = O::load(values + idx + O::Width);
+                acc0 = O::maskFmadd(x0, O::present(x0), x0, acc0);
+                acc1 = O::maskFmadd(x1, O::present(x1), x1, acc1);
+            }
+
+            for (; idx < count; idx += O::Width) {
+                const auto x = O::loadFirst(values + idx, std::min(O::Width, count - idx));
+                acc0 = O::maskFmadd(x, O::present(x), x, acc0);
+            }
+
+            return O::reduce(O::add(acc0, acc1));
+        }
+
+        template<class T>
+        __attribute__((target("avx512f"))) T sumSquaredDeviations(const T * values, std::size_t count, T mean)
+        {
+            using O = Ops<T>;
+            const auto vMean = O::broadcast(mean);
+            auto acc0 = O::zero();
+            auto acc1 = O::zero();
+            std::size_t idx = 0;
+
+            for (; idx + 2 * O::Width <= count; idx += 2 * O::Width) {
+                const auto d0 = O::sub(O::load(values + idx), vMean);
+                const auto d1 = O::sub(O::load(values + idx + O::Width), vMean);
+                acc0 = O::maskFmadd(d0, O::present(d0), d0, acc0);
+                acc1 = O::maskFmadd(d1, O::present(d1), d1, acc1);
+            }
+
+            // the tail can't use a zero-filled load here because the padding lanes would contribute mean ^ 2
+            return O::reduce(O::add(acc0, acc1)) + Scalar::sumSquaredDeviations(values + idx, count - idx, mean);
+        }
+
+        template<class T>
+        __attribute__((target("avx512f"))) DifferenceSums<T> differenceSums(const T * first, const T * second, std::size_t count)
+        {
+            using O = Ops<T>;
+            auto sum = O::zero();
+            auto sumSquares = O::zero();
+            std::size_t pairs = 0;
+            std::size_t idx = 0;
+
+            // a missing value on either side makes the difference NaN; padding lanes of the tail loads are masked off so they aren't counted as pairs
+            for (; idx < count; idx += O::Width) {
+                const auto width = std::min(O::Width, count - idx);
+                const auto diff = O::sub(O::loadFirst(first + idx, width), O::loadFirst(second + idx, width));
+                const auto mask = static_cast<typename O::Mask>(O::present(diff) & O::first(width));
+                pairs += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(mask)));
+                sum = O::maskAdd(sum, mask, diff);
+                sumSquares = O::maskFmadd(diff, mask, diff, sumSquares);
+            }
+
+            return {pairs, O::reduce(sum), O::reduce(sumSquares)};
+        }
+    }
+#endif
+
+    /**
+     * Masked sum: the sum of the values in a buffer, skipping NaN (missing) values.
+     *
+     * @param values The start of the buffer.
+     * @param count The number of values in the buffer.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class T, std::enable_if_t<HasKernels<T>, bool> = true>
+    T sum(const T * values, std::size_t count, InstructionSet set = bestInstructionSet())
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case InstructionSet::Avx512:
+                return Avx512::sum(values, count);
+
+            case InstructionSet::Avx2:
+                return Avx2::sum(values, count);
+#endif
+
+            default:
+                return Scalar::sum(values, count);
+        }
+    }
+
+    /**
+     * Masked sum of squares: the sum of the squares of the values in a buffer, skipping NaN (missing) values.
+     *
+     * @param values The start of the buffer.
+     * @param count The number of values in the buffer.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class T, std::enable_if_t<HasKernels<T>, bool> = true>
+    T sumSquares(const T * values, std::size_t count, InstructionSet set = bestInstructionSet())
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case InstructionSet::Avx512:
+                return Avx512::sumSquares(values, count);
+
+            case InstructionSet::Avx2:
+                return Avx2::sumSquares(values, count);
+#endif
+
+            default:
+                return Scalar::sumSquares(values, count);
+        }
+    }
+
+    /**
+     * Masked sum of squared deviations: the sum of (value - mean) ^ 2 for the values in a buffer, skipping NaN (missing) values.
+     *
+     * @param values The start of the buffer.
+     * @param count The number of values in the buffer.
+     * @param mean The value from which deviations are measured.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class T, std::enable_if_t<HasKernels<T>, bool> = true>
+    T sumSquaredDeviations(const T * values, std::size_t count, T mean, InstructionSet set = bestInstructionSet())
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case InstructionSet::Avx512:
+                return Avx512::sumSquaredDeviations(values, count, mean);
+
+            case InstructionSet::Avx2:
+                return Avx2::sumSquaredDeviations(values, count, mean);
+#endif
+
+            default:
+                return Scalar::sumSquaredDeviations(values, count, mean);
+        }
+    }
+
+    /**
+     * Paired difference sums: the number of complete pairs, sum(first[i] - second[i]) and sum((first[i] - second[i]) ^ 2).
+     *
+     * Pairs with a NaN (missing) value on either side are skipped.
+     *
+     * @param first The start of the first buffer.
+     * @param second The start of the second buffer.
+     * @param count The number of values in each buffer.
+     * @param set The instruction set to use. Must be supported by the CPU (see isSupported()).
+     */
+    template<class T, std::enable_if_t<HasKernels<T>, bool> = true>
+    DifferenceSums<T> differenceSums(const T * first, const T * second, std::size_t count, InstructionSet set = bestInstructionSet())
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case InstructionSet::Avx512:
+                return Avx512::differenceSums(first, second, count);
+
+            case InstructionSet::Avx2:
+                return Avx2::differenceSums(first, second, count);
+#endif
+
+            default:
+                return Scalar::differenceSums(first, second, count);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef STATISTICS_MAPPEDFILE_H
+#define STATISTICS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STATISTICS_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Statistics
+{
+    /**
+     * A read-only memory mapping of a local file.
+     *
+     * Only regular files are mapped. Pipes, FIFOs, character devices and the like can't be mapped, so for those (and on platforms without mmap()) the
+     * object is simply not open and the caller is expected to fall back to reading the file as a stream.
+     */
+    class MappedFile
+    {
+        public:
+            /**
+             * Map a file.
+             *
+             * Check isOpen() to find out whether the mapping succeeded.
+             *
+             * @param path The path to the file to map.
+             */
+            explicit MappedFile(const std::string & path)
+            {
+#if defined(STATISTICS_HAVE_MMAP)
+                const int fd = ::open(path.c_str(), O_RDONLY);
+
+                if (0 > fd) {
+                    return;
+                }
+
+                struct stat info{};
+
+                if (0 == ::fstat(fd, &info) && S_ISREG(info.st_mode)) {
+                    m_size = static_cast<std::size_t>(info.st_size);
+
+                    if (0 == m_size) {
+                        // nothing to map, but an empty regular file is still a successfully opened file
+                        m_open = true;
+                    } else {
+                        void * addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                        if (MAP_FAILED != addr) {
+                            ::madvise(addr, m_size, MADV_SEQUENTIAL);
+                            m_data = static_cast<const char *>(addr);
+                            m_open = true;
+                        } else {
+                            m_size = 0;
+                        }
+                    }
+                }
+
+                // the mapping remains valid after the descriptor is closed
+                ::close(fd);
+#else
+                static_cast<void>(path);
+#endif
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile & operator=(const MappedFile &) = delete;
+
+            /**
+             * Initialise a mapping by taking over another.
+             *
+             * @param other The mapping to move.
+             */
+            MappedFile(MappedFile && other) noexcept
+            :   m_data(std::exchange(other.m_data, nullptr)),
+                m_size(std::exchange(other.m_size, 0)),
+                m_open(std::exchange(other.m_open, false))
+            {}
+
+            /**
+             * Take over another mapping, releasing this one.
+             *
+             * @param other The mapping to move.
+             */
+            MappedFile & operator=(MappedFile && other) noexcept
+            {
+                if (this != &other) {
+                    unmap();
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                    m_open = std::exchange(other.m_open, false);
+                }
+
+                return *this;
+            }
+
+            /**
+             * Release the mapping.
+             */
+            ~MappedFile()
+            {
+                unmap();
+            }
+
+            /**
+             * Check whether the file was successfully mapped.
+             */
+            [[nodiscard]] inline bool isOpen() const
+            {
+                return m_open;
+            }
+
+            /**
+             * The size of the mapped file in bytes.
+             */
+            [[nodiscard]] inline std::size_t size() const
+            {
+                return m_size;
+            }
+
+            /**
+             * Fetch the content of the mapped file.
+             *
+             * The view is only valid for as long as the MappedFile is alive.
+             */
+            [[nodiscard]] inline std::string_view content() const
+            {
+                return {m_data, m_size};
+            }
+
+        private:
+            /**
+             * Helper to release the mapping, if any.
+             */
+            void unmap() noexcept
+            {
+#if defined(STATISTICS_HAVE_MMAP)
+                if (m_data) {
+                    ::munmap(const_cast<char *>(m_data), m_size);
+                }
+#endif
+                m_data = nullptr;
+                m_size = 0;
+                m_open = false;
+            }
+
+            /**
+             * The start of the mapped content.
+             */
+            const char * m_data = nullptr;
+
+            /**
+             * The number of bytes mapped.
+             */
+            std::size_t m_size = 0;
+
+            /**
+             * Whether the file was successfully opened.
+             */
+            bool m_open = false;
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef STATISTICS_PARALLEL_H
+#define STATISTICS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Statistics
+{
+    /**
+     * The number of threads to use when the caller doesn't specify one.
+     *
+     * @return The number of hardware threads, or 1 if that can't be determined.
+     */
+    [[nodiscard]] inline unsigned int defaultThreadCount()
+    {
+        const auto count = std::thread::hardware_concurrency();
+        return 0 == count ? 1 : count;
+    }
+
+    /**
+     * Run a task for each index in [0, count) on a pool of worker threads.
+     *
+     * The workers take indices one at a time from a shared counter, so uneven tasks balance themselves. The calling thread is one of the workers, and the
+     * call returns once every index has been processed. Tasks must not depend on the order in which indices are processed; callers that need ordered
+     * results should write them to a slot per index.
+     *
+     * If any task throws, no further indices are started and the first exception is rethrown once the workers have finished.
+     *
+     * @param threads The maximum number of threads to use, including the calling thread. 0 means defaultThreadCount().
+     * @param count The number of indices.
+     * @param task The task, invocable with a std::size_t index.
+     */
+    template<class Task>
+    void parallelFor(unsigned int threads, std::size_t count, Task && task)
+    {
+        if (0 == threads) {
+            threads = defaultThreadCount();
+        }
+
+        threads = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+
+        if (1 >= threads) {
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                task(idx);
+            }
+
+            return;
+        }
+
+        std::atomic<std::size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto work = [&]() {
+            try {
+                for (auto idx = next.fetch_add(1, std::memory_order_relaxed); idx < count; idx = next.fetch_add(1, std::memory_order_relaxed)) {
+                    task(idx);
+                }
+            } catch (...) {
+                // stop handing out indices and remember the first failure
+                next.store(count, std::memory_order_relaxed);
+                std::lock_guard lock(errorMutex);
+
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+
+        for (unsigned int idx = 1; idx < threads; ++idx) {
+            workers.emplace_back(work);
+        }
+
+        work();
+
+        for (auto & worker : workers) {
+            worker.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif
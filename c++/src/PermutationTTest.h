@@ -0,0 +1,699 @@
+#ifndef STATISTICS_PERMUTATIONTTEST_H
+#define STATISTICS_PERMUTATIONTTEST_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "TTest.h"
+#include "Parallel.h"
+#include "Random.h"
+
+namespace Statistics
+{
+    /**
+     * How a PermutationTTest samples the permutation distribution.
+     */
+    enum class PermutationMode
+    {
+        /**
+         * Exact if the number of permutations is no more than PermutationOptions::exactLimit, Monte Carlo otherwise.
+         */
+        Auto = 0,
+
+        /**
+         * Enumerate every permutation.
+         */
+        Exact,
+
+        /**
+         * Sample random permutations.
+         */
+        MonteCarlo,
+    };
+
+    /**
+     * Options controlling a permutation test.
+     */
+    struct PermutationOptions
+    {
+        /**
+         * How to sample the permutation distribution.
+         */
+        PermutationMode mode = PermutationMode::Auto;
+
+        /**
+         * The (maximum) number of random permutations for a Monte Carlo test.
+         */
+        std::uint64_t permutations = 10000;
+
+        /**
+         * The largest number of permutations that Auto mode will enumerate exactly.
+         */
+        std::uint64_t exactLimit = 100000;
+
+        /**
+         * The seed for the random permutations. The same seed always gives the same result, whatever the thread count.
+         */
+        std::uint64_t seed = 0;
+
+        /**
+         * The number of threads to use. 0 means one per hardware thread.
+         */
+        unsigned int threads = 1;
+
+        /**
+         * Stop a Monte Carlo test early once the half-width of the 99% confidence interval for p is no more than this. 0 means never stop early.
+         */
+        double tolerance = 0.0;
+    };
+
+    /**
+     * The outcome of a permutation test.
+     *
+     * @tparam T The type of the values.
+     */
+    template<class T>
+    struct PermutationResult
+    {
+        /**
+         * The observed t statistic.
+         */
+        T t;
+
+        /**
+         * The two-tailed permutation p-value.
+         *
+         * For exact tests this is the proportion of permutations whose |t| is at least the observed |t|. For Monte Carlo tests it is (b + 1) / (m + 1)
+         * for b such permutations out of m sampled, which counts the observed arrangement and so is never 0.
+         */
+        T p;
+
+        /**
+         * The number of permutations evaluated.
+         */
+        std::uint64_t permutations;
+
+        /**
+         * The number of permutations whose |t| is at least the observed |t|.
+         */
+        std::uint64_t extreme;
+
+        /**
+         * Whether every permutation was evaluated.
+         */
+        bool exact;
+
+        /**
+         * The half-width of the 99% confidence interval for a Monte Carlo p. 0 for exact tests.
+         */
+        T halfWidth;
+    };
+
+    /**
+     * A permutation test using the t statistic, for data that can't be assumed to be normally distributed.
+     *
+     * The values are copied once out of the DataFile into a flat buffer. For unpaired tests (of any type) each permutation reassigns the
+     * condition labels by shuffling only the smaller group's worth of values into place; because the totals of the values and their squares don't change
+     * between permutations, t for both groups follows from the sums over the smaller group alone. For paired tests each permutation flips the signs of the
+     * differences, and only the sum of the differences changes.
+     *
+     * Random permutations are generated in fixed-size blocks, each with its own random number stream derived from the seed and the block number, and
+     * blocks are spread over threads with parallelFor(). Results therefore depend only on the seed, never on the thread count. Early stopping is checked
+     * between rounds of blocks.
+     *
+     * @tparam T The underlying data type for the values to be tested. See TTest.
+     * @tparam Accumulator The policy used to accumulate sums. See TTest.
+     */
+    template<class T = long double, class Accumulator = NaiveSum<T>>
+    class PermutationTTest
+    {
+        public:
+            /**
+             * Alias for the single test type whose statistics the permutation test uses.
+             */
+            using TestType = TTest<T, Accumulator>;
+
+            /**
+             * Alias for the type in which the statistic is calculated.
+             */
+            using ResultType = typename TestType::ResultType;
+
+            /**
+             * Alias for the type of DataFile the test runs on.
+             */
+            using DataFileType = typename TestType::DataFileType;
+
+            /**
+             * Alias for the shared pointer to the DataFile.
+             */
+            using DataFilePtr = typename TestType::DataFilePtr;
+
+            /**
+             * Alias for the type of column indices.
+             */
+            using IndexType = typename DataFileType::IndexType;
+
+            /**
+             * Alias for the result type.
+             */
+            using Result = PermutationResult<ResultType>;
+
+            /**
+             * The number of random permutations generated from each random number stream.
+             */
+            static constexpr std::uint64_t BlockSize = 256;
+
+            /**
+             * The number of blocks of random permutations between checks for early stopping.
+             */
+            static constexpr std::uint64_t RoundBlocks = 32;
+
+            /**
+             * Initialise a new permutation test.
+             *
+             * @param data The data to process. Shared with the caller.
+             * @param type The type of test.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit PermutationTTest(DataFilePtr data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   m_data(std::move(data)),
+                m_type(type),
+                m_first(first),
+                m_second(second)
+            {}
+
+            /**
+             * Initialise a new permutation test.
+             *
+             * @param data The data to process. Moved into the test.
+             * @param type The type of test.
+             * @param first The column for the first condition.
+             * @param second The column for the second condition.
+             */
+            explicit PermutationTTest(DataFileType && data, const TTestType & type = TestType::DefaultTestType, IndexType first = 0, IndexType second = 1)
+            :   PermutationTTest(std::make_shared<DataFileType>(std::move(data)), type, first, second)
+            {}
+
+            /**
+             * Fetch the type of test.
+             */
+            [[nodiscard]] inline TTestType type() const
+            {
+                return m_type;
+            }
+
+            /**
+             * Set the type of test.
+             */
+            inline void setType(const TTestType & type)
+            {
+                m_type = type;
+            }
+
+            /**
+             * Run the test.
+             *
+             * If either condition has fewer than two values (or, for paired tests, there are fewer than two complete pairs) t can't be calculated and the
+             * result has NaN t and p.
+             *
+             * @param options The options for the test.
+             * @return The outcome.
+             * @throws std::invalid_argument if either column is not in the data.
+             * @throws std::length_error if an exact test is requested and there are too many permutations to count.
+             */
+            [[nodiscard]] Result run(const PermutationOptions & options = {}) const
+            {
+                const auto sample = (TTestType::Paired == m_type ? pairedSample() : unpairedSample());
+                const auto total = permutationCount(sample);
+                const auto exact = (PermutationMode::Exact == options.mode || (PermutationMode::Auto == options.mode && total <= options.exactLimit));
+
+                if (!sample.isValid(TTestType::Paired == m_type)) {
+                    return {NAN, NAN, 0, 0, exact, 0};
+                }
+
+                if (exact && std::numeric_limits<std::uint64_t>::max() == total) {
+                    throw std::length_error("too many permutations for an exact test");
+                }
+
+                return exact ? runExact(sample, total, options) : runMonteCarlo(sample, options);
+            }
+
+        private:
+            /**
+             * The values that are permuted, in the form the statistic needs.
+             */
+            struct Sample
+            {
+                /**
+                 * For paired tests the differences; for unpaired tests the values of both conditions (first condition first), centred on their mean.
+                 */
+                std::vector<ResultType> values;
+
+                /**
+                 * The number of values in the first condition (unpaired tests only).
+                 */
+                std::size_t n1 = 0;
+
+                /**
+                 * The sum of the values.
+                 */
+                ResultType sum = 0;
+
+                /**
+                 * The sum of the squares of the values.
+                 */
+                ResultType sumSquares = 0;
+
+                /**
+                 * The absolute t for the observed arrangement.
+                 */
+                ResultType observed = 0;
+
+                /**
+                 * The t for the observed arrangement, signed as TTest would report it.
+                 */
+                ResultType t = 0;
+
+                /**
+                 * The size of the group whose values are permuted into place (unpaired tests only).
+                 */
+                [[nodiscard]] inline std::size_t smallerGroup() const
+                {
+                    return std::min(n1, values.size() - n1);
+                }
+
+                /**
+                 * Whether there are enough values to calculate t.
+                 */
+                [[nodiscard]] inline bool isValid(bool paired) const
+                {
+                    return paired ? 2 <= values.size() : (2 <= n1 && 2 <= values.size() - n1);
+                }
+            };
+
+            /**
+             * Relative amount by which a permuted |t| may fall short of the observed |t| and still count as at least as extreme.
+             *
+             * Permutations that reproduce the observed arrangement sum the same values in a different order, so they can differ in the last few bits.
+             */
+            static constexpr ResultType TieTolerance = 1e-9;
+
+            /**
+             * The standard normal quantile for a 99% confidence interval.
+             */
+            static constexpr double ConfidenceZ = 2.5758293035489004;
+
+            /**
+             * Helper to extract the differences for a paired test.
+             */
+            Sample pairedSample() const
+            {
+                const auto & first = m_data->column(m_first);
+                const auto & second = m_data->column(m_second);
+                Sample sample;
+                sample.values.reserve(first.size());
+
+                for (std::size_t row = 0; row < first.size(); ++row) {
+                    if (first.isValid(row) && second.isValid(row)) {
+                        const auto difference = static_cast<ResultType>(first[row]) - static_cast<ResultType>(second[row]);
+                        sample.values.push_back(difference);
+                        sample.sum += difference;
+                        sample.sumSquares += difference * difference;
+                    }
+                }
+
+                sample.t = pairedT(sample.sum, sample);
+                sample.observed = std::abs(sample.t);
+                return sample;
+            }
+
+            /**
+             * Helper to extract the pooled, centred values for an unpaired test.
+             */
+            Sample unpairedSample() const
+            {
+                const auto & first = m_data->column(m_first);
+                const auto & second = m_data->column(m_second);
+                Sample sample;
+                sample.values.reserve(first.size() + second.size());
+
+                for (const auto * column : {&first, &second}) {
+                    for (std::size_t row = 0; row < column->size(); ++row) {
+                        if (column->isValid(row)) {
+                            sample.values.push_back(static_cast<ResultType>((*column)[row]));
+                        }
+                    }
+
+                    if (column == &first) {
+                        sample.n1 = sample.values.size();
+                    }
+                }
+
+                if (sample.values.empty()) {
+                    return sample;
+                }
+
+                // centring on the pooled mean keeps the sums of squares small so that the per-group variances don't suffer from cancellation
+                ResultType mean = 0;
+
+                for (const auto & value : sample.values) {
+                    mean += value;
+                }
+
+                mean /= static_cast<ResultType>(sample.values.size());
+                ResultType firstSum = 0;
+                ResultType firstSumSquares = 0;
+
+                for (std::size_t idx = 0; idx < sample.values.size(); ++idx) {
+                    auto & value = sample.values[idx];
+                    value -= mean;
+                    sample.sum += value;
+                    sample.sumSquares += value * value;
+
+                    if (idx < sample.n1) {
+                        firstSum += value;
+                        firstSumSquares += value * value;
+                    }
+                }
+
+                sample.t = unpairedT(firstSum, firstSumSquares, sample.n1, sample);
+                sample.observed = sample.t;
+                return sample;
+            }
+
+            /**
+             * Calculate paired t for one assignment of signs to the differences.
+             *
+             * The sum of squares doesn't depend on the signs, so only the sum is needed.
+             *
+             * @param sum The sum of the signed differences.
+             * @param sample The sample.
+             */
+            static inline ResultType pairedT(const ResultType & sum, const Sample & sample)
+            {
+                const auto n = static_cast<ResultType>(sample.values.size());
+                return (sum / n) / std::sqrt((sample.sumSquares - sum * sum / n) / (n - 1) / n);
+            }
+
+            /**
+             * Calculate unpaired t for one assignment of labels to the values.
+             *
+             * @param sum The sum of the values in one group.
+             * @param sumSquares The sum of the squares of the values in the group.
+             * @param count The number of values in the group.
+             * @param sample The sample. The other group's sums are the totals less the group's.
+             */
+            ResultType unpairedT(const ResultType & sum, const ResultType & sumSquares, std::size_t count, const Sample & sample) const
+            {
+                const auto otherCount = sample.values.size() - count;
+                const auto otherSum = sample.sum - sum;
+                const auto otherSumSquares = sample.sumSquares - sumSquares;
+                typename TestType::ColumnAggregates group;
+                group.count = static_cast<ResultType>(count);
+                group.mean = sum / group.count;
+                group.sumSquaredDeviations = sumSquares - sum * group.mean;
+                typename TestType::ColumnAggregates other;
+                other.count = static_cast<ResultType>(otherCount);
+                other.mean = otherSum / other.count;
+                other.sumSquaredDeviations = otherSumSquares - otherSum * other.mean;
+                return TestType::unpairedStatistic(m_type, group, other).t;
+            }
+
+            /**
+             * Check whether a permuted statistic is at least as extreme as the observed one.
+             */
+            static inline bool isExtreme(const ResultType & t, const Sample & sample)
+            {
+                return std::abs(t) >= sample.observed * (1 - TieTolerance);
+            }
+
+            /**
+             * Calculate the binomial coefficient C(n, k), saturating at the maximum std::uint64_t.
+             */
+            static std::uint64_t binomial(std::uint64_t n, std::uint64_t k)
+            {
+                if (k > n) {
+                    return 0;
+                }
+
+                k = std::min(k, n - k);
+                std::uint64_t result = 1;
+
+                for (std::uint64_t idx = 1; idx <= k; ++idx) {
+                    if (static_cast<long double>(result) * static_cast<long double>(n - k + idx) >= static_cast<long double>(std::numeric_limits<std::uint64_t>::max())) {
+                        return std::numeric_limits<std::uint64_t>::max();
+                    }
+
+                    // exact: result * (n - k + idx) is idx * C(n - k + idx, idx)
+                    result = result * (n - k + idx) / idx;
+                }
+
+                return result;
+            }
+
+            /**
+             * Helper to count the distinct permutations for a sample, saturating at the maximum std::uint64_t.
+             */
+            std::uint64_t permutationCount(const Sample & sample) const
+            {
+                if (TTestType::Paired == m_type) {
+                    return 64 > sample.values.size() ? (std::uint64_t{1} << sample.values.size()) : std::numeric_limits<std::uint64_t>::max();
+                }
+
+                return binomial(sample.values.size(), sample.smallerGroup());
+            }
+
+            /**
+             * Helper to run the test by evaluating every permutation.
+             */
+            Result runExact(const Sample & sample, std::uint64_t total, const PermutationOptions & options) const
+            {
+                static constexpr std::uint64_t ChunkSize = 4096;
+                const auto chunks = (total + ChunkSize - 1) / ChunkSize;
+                std::vector<std::uint64_t> extreme(chunks, 0);
+
+                parallelFor(options.threads, chunks, [this, &sample, &extreme, total](std::size_t chunk) {
+                    const auto begin = chunk * ChunkSize;
+                    const auto end = std::min(total, begin + ChunkSize);
+                    extreme[chunk] = (TTestType::Paired == m_type ? exactPairedChunk(sample, begin, end) : exactUnpairedChunk(sample, begin, end));
+                });
+
+                std::uint64_t count = 0;
+
+                for (const auto & chunkCount : extreme) {
+                    count += chunkCount;
+                }
+
+                return {sample.t, static_cast<ResultType>(count) / static_cast<ResultType>(total), total, count, true, 0};
+            }
+
+            /**
+             * Helper to count the extreme sign assignments in a range, for an exact paired test.
+             *
+             * Bit i of each assignment's index says whether difference i is negated.
+             */
+            std::uint64_t exactPairedChunk(const Sample & sample, std::uint64_t begin, std::uint64_t end) const
+            {
+                std::uint64_t count = 0;
+
+                for (auto signs = begin; signs < end; ++signs) {
+                    ResultType sum = 0;
+
+                    for (std::size_t idx = 0; idx < sample.values.size(); ++idx) {
+                        sum += ((signs >> idx) & 1U) ? -sample.values[idx] : sample.values[idx];
+                    }
+
+                    count += isExtreme(pairedT(sum, sample), sample);
+                }
+
+                return count;
+            }
+
+            /**
+             * Helper to count the extreme label assignments in a range, for an exact unpaired test.
+             *
+             * Assignments are the combinations of positions for the smaller group, in lexicographic order; the range is of ranks in that order.
+             */
+            std::uint64_t exactUnpairedChunk(const Sample & sample, std::uint64_t begin, std::uint64_t end) const
+            {
+                const auto n = sample.values.size();
+                const auto k = sample.smallerGroup();
+                std::vector<std::size_t> positions(k);
+
+                // unrank the first combination in the range
+                auto rank = begin;
+                std::size_t next = 0;
+
+                for (std::size_t idx = 0; idx < k; ++idx) {
+                    for (;; ++next) {
+                        const auto following = binomial(n - 1 - next, k - 1 - idx);
+
+                        if (rank < following) {
+                            break;
+                        }
+
+                        rank -= following;
+                    }
+
+                    positions[idx] = next++;
+                }
+
+                std::uint64_t count = 0;
+
+                for (auto combination = begin; combination < end; ++combination) {
+                    ResultType sum = 0;
+                    ResultType sumSquares = 0;
+
+                    for (const auto position : positions) {
+                        sum += sample.values[position];
+                        sumSquares += sample.values[position] * sample.values[position];
+                    }
+
+                    count += isExtreme(unpairedT(sum, sumSquares, k, sample), sample);
+
+                    // advance to the next combination
+                    auto idx = k;
+
+                    while (0 < idx && positions[idx - 1] == n - k + idx - 1) {
+                        --idx;
+                    }
+
+                    if (0 == idx) {
+                        break;
+                    }
+
+                    ++positions[idx - 1];
+
+                    for (; idx < k; ++idx) {
+                        positions[idx] = positions[idx - 1] + 1;
+                    }
+                }
+
+                return count;
+            }
+
+            /**
+             * Helper to run the test by sampling random permutations.
+             */
+            Result runMonteCarlo(const Sample & sample, const PermutationOptions & options) const
+            {
+                const auto blocks = (options.permutations + BlockSize - 1) / BlockSize;
+
+                // one scratch buffer per block in a round, reused from round to round; shuffling continues from wherever the last block left the buffer,
+                // which is fine because a partial Fisher-Yates shuffle picks a uniformly random subset whatever order it starts from
+                std::vector<std::vector<ResultType>> scratch(TTestType::Paired == m_type ? 0 : std::min(RoundBlocks, blocks), sample.values);
+                std::vector<std::uint64_t> extreme(RoundBlocks, 0);
+                std::uint64_t permutations = 0;
+                std::uint64_t count = 0;
+                ResultType halfWidth = 0;
+
+                for (std::uint64_t round = 0; round * RoundBlocks < blocks; ++round) {
+                    const auto firstBlock = round * RoundBlocks;
+                    const auto roundBlocks = std::min(RoundBlocks, blocks - firstBlock);
+
+                    parallelFor(options.threads, roundBlocks, [&](std::size_t idx) {
+                        const auto block = firstBlock + idx;
+                        const auto blockPermutations = std::min(BlockSize, options.permutations - block * BlockSize);
+                        Xoshiro256StarStar rng(options.seed, block);
+                        extreme[idx] = (TTestType::Paired == m_type
+                            ? monteCarloPairedBlock(sample, blockPermutations, rng)
+                            : monteCarloUnpairedBlock(sample, blockPermutations, rng, scratch[idx]));
+                    });
+
+                    for (std::uint64_t idx = 0; idx < roundBlocks; ++idx) {
+                        count += extreme[idx];
+                    }
+
+                    permutations = std::min(options.permutations, (firstBlock + roundBlocks) * BlockSize);
+                    const auto p = static_cast<ResultType>(count + 1) / static_cast<ResultType>(permutations + 1);
+                    halfWidth = static_cast<ResultType>(ConfidenceZ) * std::sqrt(p * (1 - p) / static_cast<ResultType>(permutations));
+
+                    if (0.0 < options.tolerance && halfWidth <= static_cast<ResultType>(options.tolerance)) {
+                        break;
+                    }
+                }
+
+                return {sample.t, static_cast<ResultType>(count + 1) / static_cast<ResultType>(permutations + 1), permutations, count, false, halfWidth};
+            }
+
+            /**
+             * Helper to count the extreme permutations in a block of random sign assignments, for a Monte Carlo paired test.
+             */
+            static std::uint64_t monteCarloPairedBlock(const Sample & sample, std::uint64_t permutations, Xoshiro256StarStar & rng)
+            {
+                std::uint64_t count = 0;
+
+                for (std::uint64_t permutation = 0; permutation < permutations; ++permutation) {
+                    ResultType sum = 0;
+                    std::uint64_t signs = 0;
+
+                    for (std::size_t idx = 0; idx < sample.values.size(); ++idx) {
+                        // one random word supplies the signs for 64 differences
+                        if (0 == idx % 64) {
+                            signs = rng();
+                        }
+
+                        sum += (signs & 1U) ? -sample.values[idx] : sample.values[idx];
+                        signs >>= 1;
+                    }
+
+                    count += isExtreme(pairedT(sum, sample), sample);
+                }
+
+                return count;
+            }
+
+            /**
+             * Helper to count the extreme permutations in a block of random label assignments, for a Monte Carlo unpaired test.
+             */
+            std::uint64_t monteCarloUnpairedBlock(const Sample & sample, std::uint64_t permutations, Xoshiro256StarStar & rng, std::vector<ResultType> & values) const
+            {
+                const auto n = values.size();
+                const auto k = sample.smallerGroup();
+                std::uint64_t count = 0;
+
+                for (std::uint64_t permutation = 0; permutation < permutations; ++permutation) {
+                    ResultType sum = 0;
+                    ResultType sumSquares = 0;
+
+                    // partial Fisher-Yates: the first k values become the smaller group
+                    for (std::size_t idx = 0; idx < k; ++idx) {
+                        std::swap(values[idx], values[idx + rng.below(n - idx)]);
+                        sum += values[idx];
+                        sumSquares += values[idx] * values[idx];
+                    }
+
+                    count += isExtreme(unpairedT(sum, sumSquares, k, sample), sample);
+                }
+
+                return count;
+            }
+
+            /**
+             * The data.
+             */
+            DataFilePtr m_data;
+
+            /**
+             * The type of test.
+             */
+            TTestType m_type;
+
+            /**
+             * The column for the first condition.
+             */
+            IndexType m_first;
+
+            /**
+             * The column for the second condition.
+             */
+            IndexType m_second;
+    };
+}
+
+#endif
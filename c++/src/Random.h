@@ -0,0 +1,453 @@
+#ifndef STATISTICS_RANDOM_H
+#define STATISTICS_RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "Kernels.h"
+
+namespace Statistics
+{
+    /**
+     * One step of the SplitMix64 generator.
+     *
+     * Advances the state and returns a well-mixed 64-bit value. Used to expand seeds into generator state, and useful as a hash for seeds and stream
+     * numbers.
+     *
+     * @param state The generator state, updated in place.
+     * @return The next value.
+     */
+    inline std::uint64_t splitMix64(std::uint64_t & state)
+    {
+        auto z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * The xoshiro256** pseudo-random number generator.
+     *
+     * Small, fast and statistically strong. Each generator is identified by a seed and a stream number; generators with the same seed and different
+     * streams produce independent sequences, so parallel work can give each unit of work its own stream and get the same results whichever thread runs
+     * it.
+     *
+     * Satisfies the UniformRandomBitGenerator requirements so it can be used with the standard distributions.
+     */
+    class Xoshiro256StarStar
+    {
+        public:
+            /**
+             * The type of the generated values.
+             */
+            using result_type = std::uint64_t;
+
+            /**
+             * Initialise a generator.
+             *
+             * @param seed The seed.
+             * @param stream The stream number.
+             */
+            explicit Xoshiro256StarStar(std::uint64_t seed = 0, std::uint64_t stream = 0)
+            {
+                // mix the stream into the seed before expanding it so that adjacent streams are unrelated
+                std::uint64_t streamState = stream;
+                std::uint64_t state = seed ^ splitMix64(streamState);
+
+                for (auto & word : m_state) {
+                    word = splitMix64(state);
+                }
+            }
+
+            static constexpr result_type min()
+            {
+                return 0;
+            }
+
+            static constexpr result_type max()
+            {
+                return std::numeric_limits<result_type>::max();
+            }
+
+            /**
+             * Generate the next value.
+             */
+            inline result_type operator()()
+            {
+                const auto result = rotateLeft(m_state[1] * 5, 7) * 9;
+                const auto t = m_state[1] << 17;
+                m_state[2] ^= m_state[0];
+                m_state[3] ^= m_state[1];
+                m_state[1] ^= m_state[2];
+                m_state[0] ^= m_state[3];
+                m_state[2] ^= t;
+                m_state[3] = rotateLeft(m_state[3], 45);
+                return result;
+            }
+
+            /**
+             * Generate a uniformly-distributed value in [0, bound).
+             *
+             * Uses Lemire's multiply-and-reject method, which avoids division in almost all cases.
+             *
+             * @param bound The exclusive upper bound. Must be > 0.
+             */
+            inline std::uint64_t below(std::uint64_t bound)
+            {
+#if defined(__SIZEOF_INT128__)
+                auto product = static_cast<unsigned __int128>((*this)()) * bound;
+                auto low = static_cast<std::uint64_t>(product);
+
+                if (low < bound) {
+                    const auto threshold = (0 - bound) % bound;
+
+                    while (low < threshold) {
+                        product = static_cast<unsigned __int128>((*this)()) * bound;
+                        low = static_cast<std::uint64_t>(product);
+                    }
+                }
+
+                return static_cast<std::uint64_t>(product >> 64);
+#else
+                const auto threshold = (0 - bound) % bound;
+                auto value = (*this)();
+
+                while (value < threshold) {
+                    value = (*this)();
+                }
+
+                return value % bound;
+#endif
+            }
+
+        private:
+            static constexpr std::uint64_t rotateLeft(std::uint64_t value, int bits)
+            {
+                return (value << bits) | (value >> (64 - bits));
+            }
+
+            /**
+             * The generator state.
+             */
+            std::uint64_t m_state[4];
+    };
+
+    /**
+     * The Philox4x32-10 counter-based pseudo-random number generator.
+     *
+     * A counter-based generator is a keyed bijection: the block of random values for a counter depends only on the counter and the key, not on any
+     * previous output. Any value in any stream can therefore be generated directly, without stepping through the values before it, so work can be
+     * split arbitrarily between threads and the results depend only on the seed. Each call to block() is ten rounds of two 32x32 -> 64-bit
+     * multiplications, with no state in memory, so loops that generate many blocks vectorise well.
+     *
+     * The stream interface treats the key as the seed and the upper half of the counter as the stream number; the lower half counts blocks within the
+     * stream.
+     */
+    class Philox4x32
+    {
+        public:
+            /**
+             * The type of the generated values.
+             */
+            using result_type = std::uint32_t;
+
+            /**
+             * The type of the counter.
+             */
+            using Counter = std::array<std::uint32_t, 4>;
+
+            /**
+             * The type of the key.
+             */
+            using Key = std::array<std::uint32_t, 2>;
+
+            /**
+             * The round multipliers.
+             */
+            static constexpr std::uint32_t Multiplier0 = 0xd2511f53U;
+            static constexpr std::uint32_t Multiplier1 = 0xcd9e8d57U;
+
+            /**
+             * The Weyl sequence increments for the round keys.
+             */
+            static constexpr std::uint32_t Weyl0 = 0x9e3779b9U;
+            static constexpr std::uint32_t Weyl1 = 0xbb67ae85U;
+
+            /**
+             * Initialise a generator.
+             *
+             * @param seed The seed.
+             * @param stream The stream number.
+             */
+            explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+            :   m_key({static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}),
+                m_counter({0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)}),
+                m_buffer(),
+                m_used(4)
+            {}
+
+            static constexpr result_type min()
+            {
+                return 0;
+            }
+
+            static constexpr result_type max()
+            {
+                return std::numeric_limits<result_type>::max();
+            }
+
+            /**
+             * Generate the block of four random values for a counter and key.
+             *
+             * @param counter The counter.
+             * @param key The key.
+             */
+            static inline Counter block(Counter counter, Key key)
+            {
+                for (int round = 0; round < 10; ++round) {
+                    const auto product0 = static_cast<std::uint64_t>(Multiplier0) * counter[0];
+                    const auto product1 = static_cast<std::uint64_t>(Multiplier1) * counter[2];
+                    counter = {
+                        static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                        static_cast<std::uint32_t>(product1),
+                        static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                        static_cast<std::uint32_t>(product0),
+                    };
+                    key[0] += Weyl0;
+                    key[1] += Weyl1;
+                }
+
+                return counter;
+            }
+
+            /**
+             * Generate uniformly-distributed indices from consecutive blocks.
+             *
+             * Each block yields two indices, each from 64 random bits u (the first and second, or third and fourth, values of the block) as
+             * floor(u * bound / 2^64). This needs no division or rejection loop, so it vectorises; the bias is at most bound / 2^64. The block counters
+             * are counter, counter + 1, ... in the first word of the counter; the other words are fixed.
+             *
+             * @param counter The counter for the first block.
+             * @param key The key.
+             * @param bound The exclusive upper bound for the indices. Must be > 0.
+             * @param indices The buffer to fill.
+             * @param count The number of indices to generate. Must be even.
+             * @param set The instruction set to use. Must be supported by the CPU (see Kernels::isSupported()). The indices are the same whichever is
+             * used.
+             */
+            static void indices(const Counter & counter, const Key & key, std::uint32_t bound, std::uint32_t * indices, std::size_t count,
+                                Kernels::InstructionSet set = Kernels::bestInstructionSet());
+
+            /**
+             * Generate the next value in the stream.
+             */
+            inline result_type operator()()
+            {
+                if (4 == m_used) {
+                    m_buffer = block(m_counter, m_key);
+                    m_used = 0;
+
+                    if (0 == ++m_counter[0]) {
+                        ++m_counter[1];
+                    }
+                }
+
+                return m_buffer[m_used++];
+            }
+
+            /**
+             * Skip ahead in the stream.
+             *
+             * Unlike with a conventional generator this takes constant time.
+             *
+             * @param count The number of values to skip.
+             */
+            void discard(std::uint64_t count)
+            {
+                // position in the stream, in values, of the next value to be returned
+                const auto position = ((static_cast<std::uint64_t>(m_counter[1]) << 32 | m_counter[0]) * 4 - (4 - m_used)) + count;
+                const auto blockIndex = position / 4;
+                m_counter[0] = static_cast<std::uint32_t>(blockIndex);
+                m_counter[1] = static_cast<std::uint32_t>(blockIndex >> 32);
+                m_used = 4;
+
+                // regenerate the part-used block, if any
+                for (auto skip = position % 4; 0 < skip; --skip) {
+                    (*this)();
+                }
+            }
+
+            /**
+             * Fetch the key derived from the seed.
+             */
+            [[nodiscard]] inline const Key & key() const
+            {
+                return m_key;
+            }
+
+        private:
+            /**
+             * The key.
+             */
+            Key m_key;
+
+            /**
+             * The counter for the next block to generate.
+             */
+            Counter m_counter;
+
+            /**
+             * The most recently generated block.
+             */
+            Counter m_buffer;
+
+            /**
+             * The number of values from the buffer that have been returned.
+             */
+            unsigned int m_used;
+    };
+    namespace Detail::PhiloxKernels
+    {
+        /**
+         * floor(u * bound / 2^64) for u = high * 2^32 + low, using only 32 x 32 -> 64-bit products.
+         *
+         * u * bound = high * bound * 2^32 + low * bound, so the result is (high * bound + floor(low * bound / 2^32)) / 2^32; the sum can't overflow.
+         */
+        constexpr std::uint32_t scaleToIndex(std::uint32_t high, std::uint32_t low, std::uint32_t bound)
+        {
+            const auto sum = static_cast<std::uint64_t>(high) * bound + (static_cast<std::uint64_t>(low) * bound >> 32);
+            return static_cast<std::uint32_t>(sum >> 32);
+        }
+
+        inline void indices(Philox4x32::Counter counter, const Philox4x32::Key & key, std::uint32_t bound, std::uint32_t * indices, std::size_t count)
+        {
+            for (std::size_t idx = 0; idx < count; idx += 2) {
+                const auto block = Philox4x32::block(counter, key);
+                ++counter[0];
+                indices[idx] = scaleToIndex(block[0], block[1], bound);
+                indices[idx + 1] = scaleToIndex(block[2], block[3], bound);
+            }
+        }
+
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+        /**
+         * AVX2 kernel: eight blocks at once, one per 32-bit lane.
+         *
+         * _mm256_mul_epu32() multiplies only the even lanes, so each 32 x 32 -> 64-bit product is done twice, once for the even lanes and once for the odd
+         * lanes shifted down, and the halves are blended back together.
+         */
+        namespace Avx2
+        {
+            struct Products
+            {
+                __m256i high;
+                __m256i low;
+            };
+
+            __attribute__((target("avx2"))) static inline Products multiply(__m256i values, __m256i multiplier)
+            {
+                const auto even = _mm256_mul_epu32(values, multiplier);
+                const auto odd = _mm256_mul_epu32(_mm256_srli_epi64(values, 32), multiplier);
+                return {_mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa), _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa)};
+            }
+
+            __attribute__((target("avx2"))) static inline __m256i scaleToIndex(__m256i high, __m256i low, __m256i bound)
+            {
+                const auto even = _mm256_add_epi64(_mm256_mul_epu32(high, bound), _mm256_srli_epi64(_mm256_mul_epu32(low, bound), 32));
+                const auto odd = _mm256_add_epi64(
+                    _mm256_mul_epu32(_mm256_srli_epi64(high, 32), bound),
+                    _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(low, 32), bound), 32)
+                );
+                return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+            }
+
+            __attribute__((target("avx2"))) inline void indices(Philox4x32::Counter counter, const Philox4x32::Key & key, std::uint32_t bound, std::uint32_t * indices, std::size_t count)
+            {
+                static constexpr std::size_t Width = 8;
+
+                // independent groups of lanes are interleaved so that each round's multiplications overlap rather than waiting on each other
+                static constexpr std::size_t Groups = 4;
+                const auto multiplier0 = _mm256_set1_epi32(static_cast<int>(Philox4x32::Multiplier0));
+                const auto multiplier1 = _mm256_set1_epi32(static_cast<int>(Philox4x32::Multiplier1));
+                const auto bounds = _mm256_set1_epi32(static_cast<int>(bound));
+                const auto laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                std::size_t idx = 0;
+
+                for (; idx + 2 * Width * Groups <= count; idx += 2 * Width * Groups) {
+                    __m256i x0[Groups];
+                    __m256i x1[Groups];
+                    __m256i x2[Groups];
+                    __m256i x3[Groups];
+
+                    for (std::size_t group = 0; group < Groups; ++group) {
+                        x0[group] = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(counter[0] + group * Width)), laneOffsets);
+                        x1[group] = _mm256_set1_epi32(static_cast<int>(counter[1]));
+                        x2[group] = _mm256_set1_epi32(static_cast<int>(counter[2]));
+                        x3[group] = _mm256_set1_epi32(static_cast<int>(counter[3]));
+                    }
+
+                    auto key0 = key[0];
+                    auto key1 = key[1];
+
+                    for (int round = 0; round < 10; ++round) {
+                        const auto roundKey0 = _mm256_set1_epi32(static_cast<int>(key0));
+                        const auto roundKey1 = _mm256_set1_epi32(static_cast<int>(key1));
+
+                        for (std::size_t group = 0; group < Groups; ++group) {
+                            const auto product0 = multiply(x0[group], multiplier0);
+                            const auto product1 = multiply(x2[group], multiplier1);
+                            x0[group] = _mm256_xor_si256(_mm256_xor_si256(product1.high, x1[group]), roundKey0);
+                            x1[group] = product1.low;
+                            x2[group] = _mm256_xor_si256(_mm256_xor_si256(product0.high, x3[group]), roundKey1);
+                            x3[group] = product0.low;
+                        }
+
+                        key0 += Philox4x32::Weyl0;
+                        key1 += Philox4x32::Weyl1;
+                    }
+
+                    for (std::size_t group = 0; group < Groups; ++group) {
+                        // interleave so that each block's two indices are adjacent, as in the scalar kernel
+                        const auto first = scaleToIndex(x0[group], x1[group], bounds);
+                        const auto second = scaleToIndex(x2[group], x3[group], bounds);
+                        const auto low = _mm256_unpacklo_epi32(first, second);
+                        const auto high = _mm256_unpackhi_epi32(first, second);
+                        auto * out = indices + idx + 2 * Width * group;
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permute2x128_si256(low, high, 0x20));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + Width), _mm256_permute2x128_si256(low, high, 0x31));
+                    }
+
+                    counter[0] += static_cast<std::uint32_t>(Width * Groups);
+                }
+
+                PhiloxKernels::indices(counter, key, bound, indices + idx, count - idx);
+            }
+        }
+#endif
+    }
+
+    inline void Philox4x32::indices(const Counter & counter, const Key & key, std::uint32_t bound, std::uint32_t * indices, std::size_t count, Kernels::InstructionSet set)
+    {
+        switch (set) {
+#if defined(STATISTICS_HAVE_X86_KERNELS)
+            case Kernels::InstructionSet::Avx512:
+            case Kernels::InstructionSet::Avx2:
+                // the kernel is bound by multiplication latency rather than width, so AVX-512 CPUs use the AVX2 kernel too
+                if (Kernels::isSupported(Kernels::InstructionSet::Avx2)) {
+                    Detail::PhiloxKernels::Avx2::indices(counter, key, bound, indices, count);
+                    return;
+                }
+
+                break;
+#endif
+
+            default:
+                break;
+        }
+
+        Detail::PhiloxKernels::indices(counter, key, bound, indices, count);
+    }
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef STATISTICS_RUNNINGMOMENTS_H
+#define STATISTICS_RUNNINGMOMENTS_H
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace Statistics
+{
+    /**
+     * Online accumulator for the count, mean and variance of a stream of values.
+     *
+     * Uses Welford's algorithm, which updates the mean and the sum of squared deviations from the mean in a single pass without the catastrophic
+     * cancellation that the naive sum/sum-of-squares approach suffers from on large or offset data. Memory use is constant however many values are added.
+     *
+     * @tparam T The floating-point type to accumulate in.
+     */
+    template<class T = long double, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+    class RunningMoments
+    {
+        public:
+            /**
+             * Alias for the type of values accumulated.
+             */
+            using ValueType = T;
+
+            /**
+             * Alias for the type used to count values.
+             */
+            using CountType = std::int64_t;
+
+            /**
+             * Add a value.
+             *
+             * NaN values are ignored, consistent with the way DataFile treats them as missing.
+             *
+             * @param value The value to add.
+             */
+            inline void add(const ValueType & value)
+            {
+                if (std::isnan(value)) {
+                    return;
+                }
+
+                ++m_count;
+                const auto delta = value - m_mean;
+                m_mean += delta / static_cast<ValueType>(m_count);
+                m_sumSquaredDeviations += delta * (value - m_mean);
+            }
+
+            /**
+             * Remove a value that was previously added.
+             *
+             * This reverses add(), so that a value that has been superseded can be taken back out in constant time. Removing a value that was never
+             * added gives meaningless results. NaN values are ignored, as they are by add().
+             *
+             * @param value The value to remove.
+             */
+            inline void remove(const ValueType & value)
+            {
+                if (std::isnan(value) || 0 == m_count) {
+                    return;
+                }
+
+                if (1 == --m_count) {
+                    // recalculating from the remaining value avoids accumulating rounding error as values are taken out
+                    m_mean = m_mean * 2 - value;
+                    m_sumSquaredDeviations = 0;
+                    return;
+                }
+
+                if (0 == m_count) {
+                    reset();
+                    return;
+                }
+
+                const auto previousMean = m_mean;
+                m_mean -= (value - m_mean) / static_cast<ValueType>(m_count);
+                m_sumSquaredDeviations -= (value - m_mean) * (value - previousMean);
+
+                // rounding can take a (near-)zero sum of squares fractionally negative
+                if (0 > m_sumSquaredDeviations) {
+                    m_sumSquaredDeviations = 0;
+                }
+            }
+
+            /**
+             * Combine the values accumulated by another instance into this one.
+             *
+             * This is Chan et al.'s pairwise update, so partial results from separate chunks of data can be combined exactly as if the values had all been
+             * added to one accumulator.
+             *
+             * @param other The accumulator to merge.
+             */
+            void merge(const RunningMoments & other)
+            {
+                if (0 == other.m_count) {
+                    return;
+                }
+
+                if (0 == m_count) {
+                    *this = other;
+                    return;
+                }
+
+                const auto count = m_count + other.m_count;
+                const auto delta = other.m_mean - m_mean;
+                const auto n1 = static_cast<ValueType>(m_count);
+                const auto n2 = static_cast<ValueType>(other.m_count);
+                const auto n = static_cast<ValueType>(count);
+                m_mean += delta * n2 / n;
+                m_sumSquaredDeviations += other.m_sumSquaredDeviations + delta * delta * n1 * n2 / n;
+                m_count = count;
+            }
+
+            /**
+             * Discard all accumulated values.
+             */
+            inline void reset()
+            {
+                *this = {};
+            }
+
+            /**
+             * The number of values added.
+             */
+            [[nodiscard]] inline CountType count() const
+            {
+                return m_count;
+            }
+
+            /**
+             * The arithmetic mean of the values added.
+             *
+             * This is 0 if no values have been added.
+             */
+            [[nodiscard]] inline ValueType mean() const
+            {
+                return m_mean;
+            }
+
+            /**
+             * The sum of the values added.
+             */
+            [[nodiscard]] inline ValueType sum() const
+            {
+                return m_mean * static_cast<ValueType>(m_count);
+            }
+
+            /**
+             * The sum of the squared differences between each value and the mean.
+             */
+            [[nodiscard]] inline ValueType sumSquaredDeviations() const
+            {
+                return m_sumSquaredDeviations;
+            }
+
+            /**
+             * The sample variance (i.e. with Bessel's correction) of the values added.
+             *
+             * This is NaN if fewer than two values have been added.
+             */
+            [[nodiscard]] inline ValueType variance() const
+            {
+                if (2 > m_count) {
+                    return NAN;
+                }
+
+                return m_sumSquaredDeviations / static_cast<ValueType>(m_count - 1);
+            }
+
+        private:
+            /**
+             * The number of values added.
+             */
+            CountType m_count = 0;
+
+            /**
+             * The running mean.
+             */
+            ValueType m_mean = 0.0L;
+
+            /**
+             * The running sum of squared deviations from the mean.
+             */
+            ValueType m_sumSquaredDeviations = 0.0L;
+    };
+}
+
+#endif
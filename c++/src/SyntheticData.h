@@ -0,0 +1,452 @@
+#ifndef STATISTICS_SYNTHETICDATA_H
+#define STATISTICS_SYNTHETICDATA_H
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "CacheFile.h"
+#include "Column.h"
+#include "Parallel.h"
+#include "Random.h"
+
+namespace Statistics
+{
+    /**
+     * The distributions synthetic data can be drawn from.
+     */
+    enum class SyntheticDistribution
+    {
+        /**
+         * Normal, with mean location and standard deviation scale.
+         */
+        Normal = 0,
+
+        /**
+         * Uniform on [location, location + scale).
+         */
+        Uniform,
+
+        /**
+         * Exponential with mean scale, shifted by location.
+         */
+        Exponential,
+    };
+
+    /**
+     * Options describing a synthetic data set.
+     */
+    struct SyntheticDataOptions
+    {
+        /**
+         * The number of rows. Must be at least 1.
+         */
+        std::uint64_t rows = 1000;
+
+        /**
+         * The number of columns. Must be at least 1.
+         */
+        std::uint32_t columns = 2;
+
+        /**
+         * The distribution the values are drawn from.
+         */
+        SyntheticDistribution distribution = SyntheticDistribution::Normal;
+
+        /**
+         * The location of the distribution for the first column. See SyntheticDistribution.
+         */
+        double location = 100.0;
+
+        /**
+         * The scale of the distribution. See SyntheticDistribution.
+         */
+        double scale = 15.0;
+
+        /**
+         * An amount added to the location for each successive column, so that tests on the data have a difference to find.
+         */
+        double shift = 0.0;
+
+        /**
+         * The probability that a cell is empty.
+         */
+        double missing = 0.0;
+
+        /**
+         * The probability that a row stops short of the full width. The first row is always full width.
+         */
+        double ragged = 0.0;
+
+        /**
+         * The seed. The same seed and options always produce the same data, whatever the thread count.
+         */
+        std::uint64_t seed = 0;
+
+        /**
+         * The number of digits written after the decimal point.
+         */
+        int precision = 6;
+
+        /**
+         * The number of threads to generate with. 0 means one per hardware thread.
+         */
+        unsigned int threads = 1;
+    };
+
+    /**
+     * A reproducible synthetic data set, written as CSV and optionally as the binary column cache for that CSV (see Cache).
+     *
+     * Every random draw is a block of a Philox4x32 counter-based generator keyed by the seed, with the row and column in the counter, so each cell is a
+     * pure function of the options and its position. Rows are generated in blocks on a pool of threads and written in order, in batches so that memory
+     * use is bounded however large the output.
+     */
+    class SyntheticData
+    {
+        public:
+            /**
+             * The number of rows generated as a unit. A multiple of the validity bitmap word size, so that blocks write whole words of the bitmaps.
+             */
+            static constexpr std::uint64_t BlockRows = 64 * 1024;
+
+            /**
+             * Initialise a new data set.
+             *
+             * @param options The options describing the data.
+             */
+            explicit SyntheticData(SyntheticDataOptions options = {})
+            :   m_options(options),
+                m_key{static_cast<std::uint32_t>(options.seed), static_cast<std::uint32_t>(options.seed >> 32)}
+            {}
+
+            /**
+             * Fetch the options describing the data.
+             */
+            [[nodiscard]] inline const SyntheticDataOptions & options() const
+            {
+                return m_options;
+            }
+
+            /**
+             * The number of cells in a row.
+             *
+             * @param row The index of the row.
+             */
+            [[nodiscard]] std::uint32_t rowWidth(std::uint64_t row) const
+            {
+                if (0 == row || 0 >= m_options.ragged || 1 >= m_options.columns) {
+                    return m_options.columns;
+                }
+
+                const auto draw = Philox4x32::block({static_cast<std::uint32_t>(row), static_cast<std::uint32_t>(row >> 32), RowWidthColumn, 0}, m_key);
+
+                if (uniform(draw[0], draw[1]) >= m_options.ragged) {
+                    return m_options.columns;
+                }
+
+                return 1 + draw[2] % (m_options.columns - 1);
+            }
+
+            /**
+             * The value of a cell, before it is rounded to the output precision.
+             *
+             * @param row The index of the row.
+             * @param col The index of the column.
+             * @return The value, or NaN if the cell is empty (including cells beyond the end of a short row).
+             */
+            [[nodiscard]] double value(std::uint64_t row, std::uint32_t col) const
+            {
+                return col < rowWidth(row) ? cellValue(row, col) : std::numeric_limits<double>::quiet_NaN();
+            }
+
+            /**
+             * Write the data as CSV.
+             *
+             * Rows are separated by '\n' and there is no newline after the last row. Empty cells are written as nothing at all.
+             *
+             * @param out The stream to write to.
+             * @return true if the data was written, false if the stream failed.
+             */
+            bool writeCsv(std::ostream & out) const
+            {
+                std::uint64_t lastLineOffset = 0;
+                return generate<double>(out, nullptr, lastLineOffset);
+            }
+
+            /**
+             * Write the data as CSV to a file, along with the binary column cache for it.
+             *
+             * The cache holds exactly what a DataFile<T> would parse from the CSV, so loading the CSV with the cache enabled maps the cache straight
+             * away. It is written to a temporary file of its own (see Cache::temporaryPath()) that replaces the cache once the CSV is complete.
+             *
+             * @tparam T The value type of the cache.
+             * @param csvPath The path to write the CSV to.
+             * @param cachePath The path to write the cache to. Empty for the default path for the CSV and value type.
+             * @return true if both files were written, false otherwise.
+             */
+            template<class T>
+            bool writeCsvAndCache(const std::string & csvPath, std::string cachePath = {}) const
+            {
+                if (cachePath.empty()) {
+                    cachePath = Cache::defaultPath<T>(csvPath);
+                }
+
+                const auto temporaryPath = Cache::temporaryPath(cachePath);
+                const Cache::Layout layout(m_options.rows, m_options.columns, sizeof(T));
+                std::ofstream csv(csvPath, std::ios::binary | std::ios::trunc);
+                std::ofstream cache(temporaryPath, std::ios::binary | std::ios::trunc);
+                std::uint64_t lastLineOffset = 0;
+
+                if (!csv.is_open() || !cache.is_open() || !generate<T>(csv, &cache, lastLineOffset)) {
+                    cache.close();
+                    std::error_code error;
+                    std::filesystem::remove(temporaryPath, error);
+                    return false;
+                }
+
+                csv.close();
+                const auto stamp = SourceStamp::of(csvPath);
+                std::error_code error;
+
+                if (csv && stamp) {
+                    // every row before the last includes the full-width first row; there is no header line and no Text column
+                    const auto header = Cache::header<T>(*stamp, layout, lastLineOffset, 1 < m_options.rows ? m_options.columns : 0, false, Cache::textColumnsHash({}));
+                    cache.seekp(0);
+                    cache.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                    cache.seekp(static_cast<std::streamoff>(Cache::DirectoryOffset));
+
+                    for (std::uint32_t col = 0; col < m_options.columns; ++col) {
+                        const auto entry = layout.entry(col);
+                        cache.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+                    }
+
+                    cache.close();
+
+                    if (cache) {
+                        std::filesystem::rename(temporaryPath, cachePath, error);
+
+                        if (!error) {
+                            return true;
+                        }
+                    }
+                }
+
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+
+        private:
+            /**
+             * The column index used in the counter for the draw that decides a row's width. Never a real column, because widths are 32-bit.
+             */
+            static constexpr std::uint32_t RowWidthColumn = std::numeric_limits<std::uint32_t>::max();
+
+            /**
+             * The largest number of characters in a formatted value.
+             */
+            static constexpr std::size_t MaxValueLength = 384;
+
+            /**
+             * The mathematical constant.
+             */
+            static constexpr double Pi = 3.14159265358979323846;
+
+            /**
+             * A generated block of rows.
+             *
+             * @tparam T The value type of the cache, if one is being written.
+             */
+            template<class T>
+            struct Block
+            {
+                /**
+                 * The CSV for the rows, including the '\n' that separates the block from the previous one.
+                 */
+                std::string csv;
+
+                /**
+                 * The offset in csv of the start of the last row.
+                 */
+                std::uint64_t lastLineOffset = 0;
+
+                /**
+                 * The parsed values for each column. Only filled in if a cache is being written.
+                 */
+                std::vector<Column<T>> columns;
+            };
+
+            /**
+             * Helper to make a uniform double on [0, 1) from two random words.
+             */
+            static inline double uniform(std::uint32_t high, std::uint32_t low)
+            {
+                return static_cast<double>((static_cast<std::uint64_t>(high) << 21) ^ (low >> 11)) * 0x1p-53;
+            }
+
+            /**
+             * Helper to calculate the value of a cell within its row, or NaN if it is empty.
+             */
+            [[nodiscard]] double cellValue(std::uint64_t row, std::uint32_t col) const
+            {
+                const Philox4x32::Counter counter = {static_cast<std::uint32_t>(row), static_cast<std::uint32_t>(row >> 32), col, 0};
+
+                if (0 < m_options.missing) {
+                    const auto draw = Philox4x32::block({counter[0], counter[1], counter[2], 1}, m_key);
+
+                    if (uniform(draw[0], draw[1]) < m_options.missing) {
+                        return std::numeric_limits<double>::quiet_NaN();
+                    }
+                }
+
+                const auto draw = Philox4x32::block(counter, m_key);
+                const auto location = m_options.location + m_options.shift * col;
+
+                switch (m_options.distribution) {
+                    case SyntheticDistribution::Uniform:
+                        return location + m_options.scale * uniform(draw[0], draw[1]);
+
+                    case SyntheticDistribution::Exponential:
+                        return location - m_options.scale * std::log1p(-uniform(draw[0], draw[1]));
+
+                    default:
+                        // Box-Muller; 1 - u is in (0, 1] so the log is finite
+                        return location + m_options.scale * std::sqrt(-2.0 * std::log1p(-uniform(draw[0], draw[1])))
+                            * std::cos(2.0 * Pi * uniform(draw[2], draw[3]));
+                }
+            }
+
+            /**
+             * Helper to generate a block of rows.
+             *
+             * @param index The index of the block.
+             * @param withColumns Whether to fill in the parsed values as well as the CSV.
+             * @param block The block to generate into.
+             */
+            template<class T>
+            void generateBlock(std::uint64_t index, bool withColumns, Block<T> & block) const
+            {
+                const auto firstRow = index * BlockRows;
+                const auto lastRow = std::min(firstRow + BlockRows, m_options.rows);
+                char buffer[MaxValueLength];
+
+                if (withColumns) {
+                    block.columns.resize(m_options.columns);
+
+                    for (auto & column : block.columns) {
+                        column.reserve(lastRow - firstRow);
+                    }
+                }
+
+                for (auto row = firstRow; row < lastRow; ++row) {
+                    if (0 < row) {
+                        block.csv += '\n';
+                    }
+
+                    block.lastLineOffset = block.csv.size();
+                    const auto width = rowWidth(row);
+
+                    for (std::uint32_t col = 0; col < m_options.columns; ++col) {
+                        const auto value = (col < width ? cellValue(row, col) : std::numeric_limits<double>::quiet_NaN());
+
+                        if (0 < col && col < width) {
+                            block.csv += ',';
+                        }
+
+                        if (std::isnan(value)) {
+                            if (withColumns) {
+                                block.columns[col].appendMissing();
+                            }
+
+                            continue;
+                        }
+
+                        const auto [end, error] = std::to_chars(buffer, buffer + MaxValueLength, value, std::chars_format::fixed, m_options.precision);
+                        block.csv.append(buffer, end);
+
+                        if (withColumns) {
+                            // parsed back from the text so that the cache holds exactly what parsing the CSV would
+                            T parsed{};
+                            std::from_chars(buffer, end, parsed);
+                            block.columns[col].append(parsed);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Helper to generate the data and write it out.
+             *
+             * @param csv The stream to write the CSV to.
+             * @param cache The stream to write the cache's column blocks to, or nullptr. The header and directory are not written.
+             * @param lastLineOffset Receives the offset in the CSV of the start of the last row.
+             * @return true if the data was written, false if a stream failed.
+             */
+            template<class T>
+            bool generate(std::ostream & csv, std::ostream * cache, std::uint64_t & lastLineOffset) const
+            {
+                const auto threads = (0 == m_options.threads ? defaultThreadCount() : m_options.threads);
+                const auto blockCount = (m_options.rows + BlockRows - 1) / BlockRows;
+                const auto batchSize = static_cast<std::uint64_t>(threads) * 2;
+                const Cache::Layout layout(m_options.rows, m_options.columns, sizeof(T));
+                std::uint64_t written = 0;
+
+                for (std::uint64_t firstBlock = 0; firstBlock < blockCount; firstBlock += batchSize) {
+                    std::vector<Block<T>> blocks(static_cast<std::size_t>(std::min(batchSize, blockCount - firstBlock)));
+
+                    parallelFor(threads, blocks.size(), [this, &blocks, firstBlock, cache](std::size_t idx) {
+                        generateBlock(firstBlock + idx, nullptr != cache, blocks[idx]);
+                    });
+
+                    for (std::size_t idx = 0; idx < blocks.size(); ++idx) {
+                        const auto & block = blocks[idx];
+                        lastLineOffset = written + block.lastLineOffset;
+                        csv.write(block.csv.data(), static_cast<std::streamsize>(block.csv.size()));
+                        written += block.csv.size();
+
+                        if (!cache) {
+                            continue;
+                        }
+
+                        const auto firstRow = (firstBlock + idx) * BlockRows;
+
+                        for (std::uint32_t col = 0; col < m_options.columns; ++col) {
+                            const auto & column = block.columns[col];
+                            const auto entry = layout.entry(col);
+                            cache->seekp(static_cast<std::streamoff>(entry.valuesOffset + firstRow * sizeof(T)));
+                            cache->write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+                            cache->seekp(static_cast<std::streamoff>(entry.validityOffset + firstRow / Column<T>::BitsPerWord * sizeof(typename Column<T>::BitmapWord)));
+                            cache->write(
+                                reinterpret_cast<const char *>(column.validity()),
+                                static_cast<std::streamsize>((column.size() + Column<T>::BitsPerWord - 1) / Column<T>::BitsPerWord * sizeof(typename Column<T>::BitmapWord))
+                            );
+                        }
+                    }
+
+                    if (!csv || (cache && !*cache)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * The options describing the data.
+             */
+            SyntheticDataOptions m_options;
+
+            /**
+             * The key for the random draws, made from the seed.
+             */
+            Philox4x32::Key m_key;
+    };
+}
+
+#endif
@@ -1,9 +1,19 @@
 #ifndef STATISTICS_TTEST_TTEST_H
 #define STATISTICS_TTEST_TTEST_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <istream>
+#include <fstream>
+#include <string_view>
+#include <vector>
 #include "DataFile.h"
+#include "RunningMoments.h"
+#include "Distributions.h"
+#include "Instrumentation.h"
 
 namespace Statistics
 {
@@ -12,20 +22,78 @@ namespace Statistics
      */
     enum class TTestType
     {
+        /**
+         * Paired (repeated-measures) test on the row-wise differences. n - 1 degrees of freedom.
+         */
         Paired = 0,
+
+        /**
+         * Unpaired test with the variance of each condition estimated separately (unpooled variance), as t-test has always calculated it. n1 + n2 - 2
+         * degrees of freedom.
+         */
         Unpaired,
+
+        /**
+         * Welch's unpaired test, which does not assume equal variances. The same statistic as Unpaired, with Welch–Satterthwaite degrees of freedom.
+         */
+        Welch,
+
+        /**
+         * Student's unpaired test, assuming equal variances (pooled variance). n1 + n2 - 2 degrees of freedom.
+         */
+        Student,
+    };
+
+    /**
+     * The full outcome of a t-test.
+     *
+     * @tparam T The type of the values.
+     */
+    template<class T>
+    struct TTestResult
+    {
+        /**
+         * The t statistic.
+         */
+        T t;
+
+        /**
+         * The degrees of freedom. Not necessarily an integer (e.g. for Welch's test).
+         */
+        T degreesOfFreedom;
+
+        /**
+         * The one-tailed p-value, for the tail in the direction of the observed difference.
+         */
+        T oneTailedP;
+
+        /**
+         * The two-tailed p-value.
+         */
+        T twoTailedP;
+
+        /**
+         * Calculate the p-values for a statistic.
+         *
+         * @param t The statistic.
+         * @param degreesOfFreedom The degrees of freedom.
+         */
+        static TTestResult fromStatistic(const T & t, const T & degreesOfFreedom)
+        {
+            const auto p = studentsTTwoTailedP(t, degreesOfFreedom);
+            return {t, degreesOfFreedom, p / 2, p};
+        }
     };
 
     /**
      * A class representing a t-test on a given dataset.
      *
-     * The class can perform both paired and unpaired analyses. It assumes that:
+     * The class can perform paired and unpaired (unpooled, Welch's and Student's) analyses. It assumes that:
      * - the data is organised with conditions represented by columns and observations represented by rows
      * - the data to analyse has has at least two columns
      * - the data to analyse is in the first two columns
      *
-     * For paired tests it further assumes that:
-     * - each row contains valid values in both of the first two columns
+     * For paired tests only rows with values in both of the first two columns contribute.
      *
      * The data provided is not validated against these assumptions - that is the caller's responsibility.
      *
@@ -41,8 +109,10 @@ namespace Statistics
      * - implements comparison with operator > and operator < or some other combination of comparison operators that enable the compiler to automatically
      *   create these operators
      * - has an implementation of std::isnan()
+     * @tparam Accumulator The policy used to accumulate sums (see Accumulators.h). Its ValueType is the type in which the statistic is calculated and
+     * returned. Use a wider type than T and/or a compensated policy to store values compactly without losing precision. Defaults to a naive sum in T.
      */
-    template<class T = long double, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+    template<class T = long double, class Accumulator = NaiveSum<T>, typename = std::enable_if_t<std::is_floating_point_v<T>>>
     class TTest
     {
         public:
@@ -54,10 +124,20 @@ namespace Statistics
              */
             using ValueType = T;
 
+            /**
+             * Alias for the accumulation policy.
+             */
+            using AccumulatorType = Accumulator;
+
+            /**
+             * Alias for the type in which the statistic is calculated.
+             */
+            using ResultType = typename Accumulator::ValueType;
+
             /**
              * Convenience alias for the concrete type of the DataFile used for TTest objects.
              */
-            using DataFileType = DataFile<ValueType>;
+            using DataFileType = DataFile<ValueType, defaultDataItemParser<ValueType>, Accumulator>;
 
             /**
              * Type alias for the data file shared pointer.
@@ -67,7 +147,15 @@ namespace Statistics
             /**
              * The default type of t-test.
              */
-            static const TTestType DefaultTestType = TTestType::Paired;
+            static constexpr TTestType DefaultTestType = TTestType::Paired;
+
+            /**
+             * The columns of the data that the test uses: the first condition is in column 0, the second in column 1.
+             *
+             * Load a data file with these as LoadOptions::columns to have it parse only the columns the test needs. Any other pair of the file's columns
+             * can be tested by loading those two instead.
+             */
+            static inline const std::vector<std::size_t> Columns = {0, 1};
 
             /**
              * Initialise a new t-test.
@@ -233,8 +321,10 @@ namespace Statistics
              *
              * If you find a way to optimise the calculation so that it runs 10 times faster, you can reimplement this in a subclass.
              */
-            [[nodiscard]] virtual inline ValueType t() const
+            [[nodiscard]] virtual inline ResultType t() const
             {
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Statistic);
+
                 if(TTestType::Paired == m_type) {
                     return pairedT();
                 }
@@ -242,90 +332,276 @@ namespace Statistics
                 return unpairedT();
             }
 
-        protected:
             /**
-             * Helper to calculate t for paired data.
+             * Per-column aggregates used by the unpaired test.
+             */
+            struct ColumnAggregates
+            {
+                /**
+                 * The number of values in the column.
+                 */
+                ResultType count = 0;
+
+                /**
+                 * The mean of the values in the column.
+                 */
+                ResultType mean = 0;
+
+                /**
+                 * The sum of squared differences between each value in the column and the mean.
+                 */
+                ResultType sumSquaredDeviations = 0;
+            };
+
+            /**
+             * Calculate the aggregates for one column that the unpaired test needs.
              *
-             * Do not call unless you are certain that the t-test has data. See hasData().
+             * These only depend on the column, so when testing many pairs of columns (see BatchTTest) they can be calculated once per column and reused.
+             *
+             * @param data The data.
+             * @param col The column. Bounds-checked.
+             * @throws std::invalid_argument if col is not a valid column index.
              */
-            [[nodiscard]] ValueType pairedT() const
+            [[nodiscard]] static ColumnAggregates columnAggregates(const DataFileType & data, const typename DataFileType::IndexType & col)
             {
-                // the number of pairs of observations
-                auto n = m_data->columnItemCount(0);
+                const auto values = data.columnView(col);
+                ColumnAggregates aggregates;
+                aggregates.count = static_cast<ResultType>(data.columnItemCount(col));
+                aggregates.mean = data.columnSum(col) / aggregates.count;
+
+                if constexpr (Kernels::HasKernels<ValueType> && AccumulatesWithKernels<ValueType, Accumulator>) {
+                    Accumulator meanDiffs;
+
+                    forEachPartial<Accumulator>(values.size(), [&meanDiffs, &values, mean = aggregates.mean](std::size_t offset, std::size_t size) {
+                        meanDiffs.addPartial(Kernels::sumSquaredDeviations(values.data() + offset, size, mean));
+                    });
 
-                // differences between pairs of observations: (x1 - x2)
-                std::vector<ValueType> diffs(n, NAN);
+                    aggregates.sumSquaredDeviations = meanDiffs.value();
+                } else {
+                    Accumulator meanDiffs;
 
-                // squared differences between pairs of observations: (x1 - x2) ^ 2
-                std::vector<ValueType> diffs2(n, NAN);
+                    for (auto i = static_cast<std::ptrdiff_t>(values.size()) - 1; i >= 0; --i) {
+                        auto x = static_cast<ResultType>(values[static_cast<std::size_t>(i)]);
+
+                        if(!std::isnan(x)) {
+                            x -= aggregates.mean;
+                            meanDiffs.add(x * x);
+                        }
+                    }
+
+                    aggregates.sumSquaredDeviations = meanDiffs.value();
+                }
+
+                return aggregates;
+            }
+
+            /**
+             * A t statistic along with its degrees of freedom.
+             */
+            struct Statistic
+            {
+                ResultType t;
+                ResultType degreesOfFreedom;
+            };
+
+            /**
+             * Calculate t for paired data in a given pair of columns.
+             *
+             * The differences are never stored: a single fused pass over the two columns accumulates both sums, so the calculation does no heap
+             * allocation and reads each value once. Rows with a value missing from either column are skipped.
+             *
+             * @param data The data.
+             * @param first The column for the first condition. Bounds-checked.
+             * @param second The column for the second condition. Bounds-checked.
+             * @return The (signed) statistic and n - 1 degrees of freedom, where n is the number of complete pairs.
+             * @throws std::invalid_argument if either column is not a valid column index.
+             */
+            [[nodiscard]] static Statistic pairedStatistic(const DataFileType & data, const typename DataFileType::IndexType & first, const typename DataFileType::IndexType & second)
+            {
+                const auto values1 = data.columnView(first);
+                const auto values2 = data.columnView(second);
+
+                // the number of complete pairs of observations
+                std::size_t n = 0;
 
                 // sum of differences between pairs of observations: sum[i = 1 to n](x1 - x2)
-                ValueType sumDiffs = 0.0L;
+                ResultType sumDiffs = 0.0L;
 
                 // sum of squared differences between pairs of observations: sum[i = 1 to n]((x1 - x2) ^ 2)
-                ValueType sumDiffs2 = 0.0L;
+                ResultType sumDiffs2 = 0.0L;
+
+                if constexpr (Kernels::HasKernels<ValueType> && AccumulatesWithKernels<ValueType, Accumulator>) {
+                    Accumulator diffs;
+                    Accumulator diffs2;
+
+                    forEachPartial<Accumulator>(std::min(values1.size(), values2.size()), [&](std::size_t offset, std::size_t size) {
+                        const auto sums = Kernels::differenceSums(values1.data() + offset, values2.data() + offset, size);
+                        n += sums.count;
+                        diffs.addPartial(sums.sum);
+                        diffs2.addPartial(sums.sumSquares);
+                    });
+
+                    sumDiffs = diffs.value();
+                    sumDiffs2 = diffs2.value();
+                } else {
+                    Accumulator diffs;
+                    Accumulator diffs2;
+
+                    for(std::size_t i = 0; i < std::min(values1.size(), values2.size()); ++i) {
+                        const ResultType diff = static_cast<ResultType>(values1[i]) - static_cast<ResultType>(values2[i]);
+
+                        // a missing value on either side makes the difference NaN
+                        if(!std::isnan(diff)) {
+                            ++n;
+                            diffs.add(diff);
+                            diffs2.add(diff * diff);
+                        }
+                    }
 
-                for(int i = 0; i < n; ++i) {
-                    diffs[i] = m_data->item(i, 0) - m_data->item(i, 1);
-                    diffs2[i] = diffs[i] * diffs[i];
-                    sumDiffs += diffs[i];
-                    sumDiffs2 += diffs2[i];
+                    sumDiffs = diffs.value();
+                    sumDiffs2 = diffs2.value();
                 }
 
-                return sumDiffs / static_cast<ValueType>(std::pow((((static_cast<ValueType>(n) * sumDiffs2) - (sumDiffs * sumDiffs)) / static_cast<ValueType>(n - 1)), 0.5L));
+                return {
+                    sumDiffs / static_cast<ResultType>(std::pow((((static_cast<ResultType>(n) * sumDiffs2) - (sumDiffs * sumDiffs)) / (static_cast<ResultType>(n) - 1)), 0.5L)),
+                    static_cast<ResultType>(n) - 1,
+                };
             }
 
             /**
-             * Helper to calculate t for unpaired data.
+             * Calculate t for unpaired data from the aggregates for the two columns.
              *
-             * Do not call unless you are certain that the t-test has data. See hasData().
+             * The variance of each condition is estimated separately, as for Welch's test, but the degrees of freedom are n1 + n2 - 2.
+             *
+             * @param first The aggregates for the first condition.
+             * @param second The aggregates for the second condition.
+             * @return The (always positive) statistic and n1 + n2 - 2 degrees of freedom.
              */
-            [[nodiscard]] ValueType unpairedT() const
+            [[nodiscard]] static Statistic unpairedStatistic(const ColumnAggregates & first, const ColumnAggregates & second)
             {
-                // observation counts for each condition
-                auto n1 = static_cast<ValueType>(m_data->columnItemCount(0));
-                auto n2 = static_cast<ValueType>(m_data->columnItemCount(1));
+                const auto & n1 = first.count;
+                const auto & n2 = second.count;
 
-                // sums for each condition
-                auto sum1 = m_data->columnSum(0);
-                auto sum2 = m_data->columnSum(1);
-
-                // means for each condition
-                auto mean1 = sum1 / n1;
-                auto mean2 = sum2 / n2;
+                // calculate the statistic
+                ResultType t = (first.mean - second.mean) / std::pow(((first.sumSquaredDeviations / n1 / (n1 - 1)) + (second.sumSquaredDeviations / n2 / (n2 - 1))), 0.5L);
 
-                // sum of differences between items and the mean for each condition
-                auto sumMeanDiffs1 = static_cast<ValueType>(0.0L);
-                auto sumMeanDiffs2 = static_cast<ValueType>(0.0L);
+                // always return +ve t
+                if(0.0L > t) {
+                    t = -t;
+                }
 
-                for(auto i = m_data->rowCount() - 1; i >= 0; --i) {
-                    auto x = m_data->item(i, 0);
+                return {t, n1 + n2 - 2};
+            }
 
-                    if(!std::isnan(x)) {
-                        x -= mean1;
-                        sumMeanDiffs1 += (x * x);
-                    }
+            /**
+             * Calculate Student's t for unpaired data from the aggregates for the two columns.
+             *
+             * The variance is pooled, on the assumption that both conditions have the same variance.
+             *
+             * @param first The aggregates for the first condition.
+             * @param second The aggregates for the second condition.
+             * @return The (always positive) statistic and n1 + n2 - 2 degrees of freedom.
+             */
+            [[nodiscard]] static Statistic studentStatistic(const ColumnAggregates & first, const ColumnAggregates & second)
+            {
+                const auto & n1 = first.count;
+                const auto & n2 = second.count;
+                const ResultType degreesOfFreedom = n1 + n2 - 2;
+                const auto pooledVariance = (first.sumSquaredDeviations + second.sumSquaredDeviations) / degreesOfFreedom;
 
-                    x = m_data->item(i, 1);
+                // calculate the statistic
+                ResultType t = (first.mean - second.mean) / std::pow(pooledVariance * ((1 / n1) + (1 / n2)), 0.5L);
 
-                    if(!std::isnan(x)) {
-                        x -= mean2;
-                        sumMeanDiffs2 += (x * x);
-                    }
+                // always return +ve t
+                if(0.0L > t) {
+                    t = -t;
                 }
 
-                sumMeanDiffs1 /= n1;
-                sumMeanDiffs2 /= n2;
+                return {t, degreesOfFreedom};
+            }
+
+            /**
+             * Calculate Welch's t for unpaired data from the aggregates for the two columns.
+             *
+             * The variance of each condition is estimated separately, and the degrees of freedom are the Welch–Satterthwaite approximation.
+             *
+             * @param first The aggregates for the first condition.
+             * @param second The aggregates for the second condition.
+             * @return The (always positive) statistic and its degrees of freedom.
+             */
+            [[nodiscard]] static Statistic welchStatistic(const ColumnAggregates & first, const ColumnAggregates & second)
+            {
+                const auto & n1 = first.count;
+                const auto & n2 = second.count;
+
+                // squared standard errors of the means
+                const auto squaredError1 = first.sumSquaredDeviations / n1 / (n1 - 1);
+                const auto squaredError2 = second.sumSquaredDeviations / n2 / (n2 - 1);
+                const auto squaredError = squaredError1 + squaredError2;
 
                 // calculate the statistic
-                ValueType t = (mean1 - mean2) / std::pow(((sumMeanDiffs1 / (n1 - 1.0L)) + (sumMeanDiffs2 / (n2 - 1.0L))), 0.5L);
+                ResultType t = (first.mean - second.mean) / std::pow(squaredError, 0.5L);
 
                 // always return +ve t
                 if(0.0L > t) {
                     t = -t;
                 }
 
-                return t;
+                return {t, (squaredError * squaredError) / ((squaredError1 * squaredError1 / (n1 - 1)) + (squaredError2 * squaredError2 / (n2 - 1)))};
+            }
+
+            /**
+             * Calculate t for any type of unpaired test from the aggregates for the two columns.
+             *
+             * @param type The type of test. Must be Unpaired, Welch or Student.
+             * @param first The aggregates for the first condition.
+             * @param second The aggregates for the second condition.
+             */
+            [[nodiscard]] static inline Statistic unpairedStatistic(const TTestType & type, const ColumnAggregates & first, const ColumnAggregates & second)
+            {
+                switch (type) {
+                    case TTestType::Welch:
+                        return welchStatistic(first, second);
+
+                    case TTestType::Student:
+                        return studentStatistic(first, second);
+
+                    default:
+                        return unpairedStatistic(first, second);
+                }
+            }
+
+            /**
+             * Calculate t, its degrees of freedom and the p-values.
+             *
+             * Do not call unless you are certain that the t-test has data. See hasData().
+             */
+            [[nodiscard]] inline TTestResult<ResultType> result() const
+            {
+                const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Statistic);
+                const auto statistic = (TTestType::Paired == m_type ? pairedStatistic(*m_data, 0, 1) : unpairedStatistic(m_type, columnAggregates(*m_data, 0), columnAggregates(*m_data, 1)));
+                return TTestResult<ResultType>::fromStatistic(statistic.t, statistic.degreesOfFreedom);
+            }
+
+        protected:
+            /**
+             * Helper to calculate t for paired data.
+             *
+             * Do not call unless you are certain that the t-test has data. See hasData().
+             */
+            [[nodiscard]] inline ResultType pairedT() const
+            {
+                return pairedStatistic(*m_data, 0, 1).t;
+            }
+
+            /**
+             * Helper to calculate t for unpaired data.
+             *
+             * Do not call unless you are certain that the t-test has data. See hasData().
+             */
+            [[nodiscard]] inline ResultType unpairedT() const
+            {
+                return unpairedStatistic(m_type, columnAggregates(*m_data, 0), columnAggregates(*m_data, 1)).t;
             }
 
         private:
@@ -343,6 +619,296 @@ namespace Statistics
              */
             TTestType m_type;
     };
+
+    /**
+     * A t-test calculated in a single pass over a stream of rows, without loading the data into a DataFile.
+     *
+     * Only running counts, means and sums of squared deviations are kept (see RunningMoments), so memory use is constant however many rows are read. This
+     * makes it suitable for unbounded input such as logs piped from other tools. Input is CSV with the same layout, dialect and parsing rules as
+     * DataFile; only the first two columns are read.
+     *
+     * For paired tests only rows with values in both columns contribute; for unpaired tests each column contributes all of its values.
+     *
+     * @tparam T The underlying data type for the values to be tested. Must be a floating-point type.
+     * @tparam parser The function used to parse each CSV cell. See DataFile.
+     */
+    template<class T = long double, DataItemParser<T> parser = defaultDataItemParser<T>, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+    class StreamingTTest
+    {
+        public:
+            /**
+             * Alias for the type of numeric data.
+             */
+            using ValueType = T;
+
+            /**
+             * Alias for the accumulator type.
+             */
+            using MomentsType = RunningMoments<ValueType>;
+
+            /**
+             * Initialise a new streaming t-test with no data.
+             *
+             * @param type The type of test.
+             * @param dialect The delimiter and quote character of the CSV to read.
+             */
+            explicit StreamingTTest(const TTestType & type = TTest<ValueType>::DefaultTestType, const Csv::Dialect & dialect = {})
+            :   m_type(type),
+                m_dialect(dialect)
+            {}
+
+            /**
+             * Fetch the type of test.
+             */
+            [[nodiscard]] inline TTestType type() const
+            {
+                return m_type;
+            }
+
+            /**
+             * Fetch the delimiter and quote character of the CSV read.
+             */
+            [[nodiscard]] inline const Csv::Dialect & dialect() const
+            {
+                return m_dialect;
+            }
+
+            /**
+             * Set the type of test.
+             *
+             * The accumulators for both types of test are always maintained, so the type can be changed at any point.
+             */
+            inline void setType(const TTestType & type)
+            {
+                m_type = type;
+            }
+
+            /**
+             * Add a row of observations.
+             *
+             * @param x1 The observation for the first condition. NaN if missing.
+             * @param x2 The observation for the second condition. NaN if missing.
+             */
+            inline void addRow(const ValueType & x1, const ValueType & x2)
+            {
+                m_moments1.add(x1);
+                m_moments2.add(x2);
+
+                if (!std::isnan(x1) && !std::isnan(x2)) {
+                    m_differenceMoments.add(x1 - x2);
+                }
+            }
+
+            /**
+             * Remove a row of observations that was previously added.
+             *
+             * @param x1 The observation for the first condition. NaN if missing.
+             * @param x2 The observation for the second condition. NaN if missing.
+             */
+            inline void removeRow(const ValueType & x1, const ValueType & x2)
+            {
+                m_moments1.remove(x1);
+                m_moments2.remove(x2);
+
+                if (!std::isnan(x1) && !std::isnan(x2)) {
+                    m_differenceMoments.remove(x1 - x2);
+                }
+            }
+
+            /**
+             * Discard all the rows added.
+             */
+            inline void reset()
+            {
+                m_moments1.reset();
+                m_moments2.reset();
+                m_differenceMoments.reset();
+            }
+
+            /**
+             * Parse a line of CSV and add it as a row of observations.
+             *
+             * @param line The line, without its line terminator.
+             */
+            void addLine(std::string_view line)
+            {
+                ValueType values[2] = {NAN, NAN};
+                std::size_t col = 0;
+
+                Csv::forEachField(line, m_dialect, [this, &values, &col](std::string_view field) {
+                    if (2 > col) {
+                        values[col] = parseItem(Csv::unquote(field, m_dialect));
+                    }
+
+                    ++col;
+                });
+
+                addRow(values[0], values[1]);
+            }
+
+            /**
+             * Read rows from a stream until it is exhausted.
+             *
+             * If the first line is a header (see isHeaderLine()) it is skipped.
+             *
+             * @param in The stream to read.
+             */
+            void read(std::istream & in)
+            {
+                std::string line;
+                bool isFirstLine = true;
+
+                while (!in.eof()) {
+                    Csv::readRecord(in, m_dialect, line);
+
+                    if (isFirstLine) {
+                        isFirstLine = false;
+
+                        if (isHeaderLine<ValueType, parser>(line, m_dialect)) {
+                            continue;
+                        }
+                    }
+
+                    addLine(line);
+                }
+            }
+
+            /**
+             * Read rows from a file until it is exhausted.
+             *
+             * @param path The path to the file. Use "-" to read from stdin.
+             * @return true if the file was read, false if it could not be opened.
+             */
+            bool read(const std::string & path)
+            {
+                if ("-" == path) {
+                    read(std::cin);
+                    return true;
+                }
+
+                std::ifstream in(path);
+
+                if (!in.is_open()) {
+                    return false;
+                }
+
+                read(in);
+                return true;
+            }
+
+            /**
+             * The accumulated moments for the first condition.
+             */
+            [[nodiscard]] inline const MomentsType & moments1() const
+            {
+                return m_moments1;
+            }
+
+            /**
+             * The accumulated moments for the second condition.
+             */
+            [[nodiscard]] inline const MomentsType & moments2() const
+            {
+                return m_moments2;
+            }
+
+            /**
+             * The accumulated moments for the paired differences (x1 - x2).
+             */
+            [[nodiscard]] inline const MomentsType & differenceMoments() const
+            {
+                return m_differenceMoments;
+            }
+
+            /**
+             * Calculate and return t for the rows added so far.
+             *
+             * The result matches TTest::t() for the same data: paired t is signed, unpaired t is always positive.
+             */
+            [[nodiscard]] inline ValueType t() const
+            {
+                return result().t;
+            }
+
+            /**
+             * Calculate t, its degrees of freedom and the p-values from the rows added so far.
+             */
+            [[nodiscard]] TTestResult<ValueType> result() const
+            {
+                if (TTestType::Paired == m_type) {
+                    const auto n = static_cast<ValueType>(m_differenceMoments.count());
+                    return TTestResult<ValueType>::fromStatistic(m_differenceMoments.mean() * std::sqrt(n) / std::sqrt(m_differenceMoments.variance()), n - 1);
+                }
+
+                const auto n1 = static_cast<ValueType>(m_moments1.count());
+                const auto n2 = static_cast<ValueType>(m_moments2.count());
+                ValueType t;
+                ValueType degreesOfFreedom;
+
+                if (TTestType::Student != m_type) {
+                    const auto squaredError1 = m_moments1.variance() / n1;
+                    const auto squaredError2 = m_moments2.variance() / n2;
+                    const auto squaredError = squaredError1 + squaredError2;
+                    t = (m_moments1.mean() - m_moments2.mean()) / std::sqrt(squaredError);
+                    degreesOfFreedom = (TTestType::Welch == m_type
+                        ? (squaredError * squaredError) / ((squaredError1 * squaredError1 / (n1 - 1)) + (squaredError2 * squaredError2 / (n2 - 1)))
+                        : n1 + n2 - 2);
+                } else {
+                    degreesOfFreedom = n1 + n2 - 2;
+                    const auto pooledVariance = (m_moments1.sumSquaredDeviations() + m_moments2.sumSquaredDeviations()) / degreesOfFreedom;
+                    t = (m_moments1.mean() - m_moments2.mean()) / std::sqrt(pooledVariance * ((1 / n1) + (1 / n2)));
+                }
+
+                return TTestResult<ValueType>::fromStatistic(0.0L > t ? -t : t, degreesOfFreedom);
+            }
+
+        private:
+            /**
+             * Helper to parse a single cell, treating unparseable cells as missing.
+             *
+             * Empty cells are missing values and are skipped silently; cells with content that isn't a number are reported on stderr.
+             */
+            static ValueType parseItem(std::string_view item)
+            {
+                ValueType value = NAN;
+                const auto status = parseDataItem<ValueType, parser>(item, value);
+
+                if (DataItemStatus::Ok == status) {
+                    return value;
+                }
+
+                if (DataItemStatus::Empty != status) {
+                    std::cerr << "ERR " << describe(status) << " \"" << item.substr(0, ParseError::MaxTextLength) << "\"\n";
+                }
+
+                return NAN;
+            }
+
+            /**
+             * The type of test.
+             */
+            TTestType m_type;
+
+            /**
+             * The delimiter and quote character of the CSV read.
+             */
+            Csv::Dialect m_dialect;
+
+            /**
+             * Accumulated moments for the first condition.
+             */
+            MomentsType m_moments1;
+
+            /**
+             * Accumulated moments for the second condition.
+             */
+            MomentsType m_moments2;
+
+            /**
+             * Accumulated moments for the paired differences.
+             */
+            MomentsType m_differenceMoments;
+    };
 }
 
 #endif
@@ -0,0 +1,383 @@
+#ifndef STATISTICS_VIEWS_H
+#define STATISTICS_VIEWS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Statistics
+{
+    template<class T>
+    class StridedView;
+
+    /**
+     * A non-owning view of a contiguous run of a column's cells, in the manner of std::span.
+     *
+     * The view exposes the raw value buffer, so kernels can walk it with no per-element checks, and the validity bitmap for code that must distinguish
+     * missing cells from values (for floating-point types missing cells hold NaN, so the values alone are usually enough). Nothing is bounds-checked;
+     * the view is only valid for as long as the column it was taken from is alive and unmodified.
+     *
+     * @tparam T The value type.
+     */
+    template<class T>
+    class ColumnView
+    {
+        public:
+            /**
+             * Alias for the type of values in the view.
+             */
+            using ValueType = T;
+
+            /**
+             * Alias for the type used for cell indices.
+             */
+            using SizeType = std::size_t;
+
+            /**
+             * Alias for the type of each word in the validity bitmap.
+             */
+            using BitmapWord = std::uint64_t;
+
+            /**
+             * Alias for the iterator type.
+             */
+            using Iterator = const ValueType *;
+
+            /**
+             * The number of cells tracked by each word in the validity bitmap.
+             */
+            static constexpr SizeType BitsPerWord = std::numeric_limits<BitmapWord>::digits;
+
+            /**
+             * Initialise an empty view.
+             */
+            constexpr ColumnView() noexcept = default;
+
+            /**
+             * Initialise a view of some cells.
+             *
+             * @param values The first cell value.
+             * @param validity The validity bitmap word holding the first cell's bit.
+             * @param size The number of cells.
+             * @param bitOffset The position of the first cell's bit in the first validity word. Must be less than BitsPerWord.
+             */
+            constexpr ColumnView(const ValueType * values, const BitmapWord * validity, SizeType size, SizeType bitOffset = 0) noexcept
+            :   m_values(values),
+                m_validity(validity),
+                m_size(size),
+                m_bitOffset(bitOffset)
+            {}
+
+            /**
+             * Fetch a pointer to the first cell value. The values are contiguous.
+             */
+            [[nodiscard]] constexpr const ValueType * data() const noexcept
+            {
+                return m_values;
+            }
+
+            /**
+             * Fetch a pointer to the validity bitmap word holding the first cell's bit. See bitOffset().
+             */
+            [[nodiscard]] constexpr const BitmapWord * validity() const noexcept
+            {
+                return m_validity;
+            }
+
+            /**
+             * Fetch the position of the first cell's bit in the first validity word.
+             */
+            [[nodiscard]] constexpr SizeType bitOffset() const noexcept
+            {
+                return m_bitOffset;
+            }
+
+            /**
+             * The number of cells in the view, including missing cells.
+             */
+            [[nodiscard]] constexpr SizeType size() const noexcept
+            {
+                return m_size;
+            }
+
+            /**
+             * Check whether the view has no cells.
+             */
+            [[nodiscard]] constexpr bool isEmpty() const noexcept
+            {
+                return 0 == m_size;
+            }
+
+            /**
+             * Fetch a cell value.
+             *
+             * @param idx The cell index. Not bounds-checked.
+             * @return The value. For floating-point types this is NaN if the cell is empty.
+             */
+            [[nodiscard]] constexpr const ValueType & operator[](SizeType idx) const noexcept
+            {
+                return m_values[idx];
+            }
+
+            /**
+             * Check whether a cell contains a value.
+             *
+             * @param idx The cell index. Not bounds-checked.
+             */
+            [[nodiscard]] constexpr bool isValid(SizeType idx) const noexcept
+            {
+                const auto bit = idx + m_bitOffset;
+                return (m_validity[bit / BitsPerWord] >> (bit % BitsPerWord)) & 1U;
+            }
+
+            [[nodiscard]] constexpr Iterator begin() const noexcept
+            {
+                return m_values;
+            }
+
+            [[nodiscard]] constexpr Iterator end() const noexcept
+            {
+                return m_values + m_size;
+            }
+
+            /**
+             * Fetch a view of a run of the cells in this view.
+             *
+             * @param first The index of the first cell. Not bounds-checked.
+             * @param count The number of cells. first + count must not exceed size().
+             */
+            [[nodiscard]] constexpr ColumnView subview(SizeType first, SizeType count) const noexcept
+            {
+                const auto bit = first + m_bitOffset;
+                return {m_values + first, m_validity + bit / BitsPerWord, count, bit % BitsPerWord};
+            }
+
+            /**
+             * Fetch a view of every stride'th cell in this view, starting with the first.
+             *
+             * @param stride The distance between successive cells. Must not be 0.
+             */
+            [[nodiscard]] constexpr StridedView<ValueType> strided(SizeType stride) const noexcept;
+
+        private:
+            /**
+             * The first cell value.
+             */
+            const ValueType * m_values = nullptr;
+
+            /**
+             * The validity word holding the first cell's bit.
+             */
+            const BitmapWord * m_validity = nullptr;
+
+            /**
+             * The number of cells.
+             */
+            SizeType m_size = 0;
+
+            /**
+             * The position of the first cell's bit in the first validity word.
+             */
+            SizeType m_bitOffset = 0;
+    };
+
+    /**
+     * A non-owning view of values spaced at a fixed distance through a buffer.
+     *
+     * Used for sampling a column at regular intervals, or for walking any buffer laid out with a stride. Nothing is bounds-checked.
+     *
+     * @tparam T The value type.
+     */
+    template<class T>
+    class StridedView
+    {
+        public:
+            /**
+             * Alias for the type of values in the view.
+             */
+            using ValueType = T;
+
+            /**
+             * Alias for the type used for indices.
+             */
+            using SizeType = std::size_t;
+
+            /**
+             * Initialise an empty view.
+             */
+            constexpr StridedView() noexcept = default;
+
+            /**
+             * Initialise a view.
+             *
+             * @param values The first value.
+             * @param size The number of values in the view.
+             * @param stride The distance between successive values, in values.
+             */
+            constexpr StridedView(const ValueType * values, SizeType size, SizeType stride) noexcept
+            :   m_values(values),
+                m_size(size),
+                m_stride(stride)
+            {}
+
+            /**
+             * Fetch a pointer to the first value.
+             */
+            [[nodiscard]] constexpr const ValueType * data() const noexcept
+            {
+                return m_values;
+            }
+
+            /**
+             * The number of values in the view.
+             */
+            [[nodiscard]] constexpr SizeType size() const noexcept
+            {
+                return m_size;
+            }
+
+            /**
+             * The distance between successive values, in values.
+             */
+            [[nodiscard]] constexpr SizeType stride() const noexcept
+            {
+                return m_stride;
+            }
+
+            /**
+             * Check whether the view has no values.
+             */
+            [[nodiscard]] constexpr bool isEmpty() const noexcept
+            {
+                return 0 == m_size;
+            }
+
+            /**
+             * Fetch a value.
+             *
+             * @param idx The index of the value in the view. Not bounds-checked.
+             */
+            [[nodiscard]] constexpr const ValueType & operator[](SizeType idx) const noexcept
+            {
+                return m_values[idx * m_stride];
+            }
+
+        private:
+            /**
+             * The first value.
+             */
+            const ValueType * m_values = nullptr;
+
+            /**
+             * The number of values.
+             */
+            SizeType m_size = 0;
+
+            /**
+             * The distance between successive values.
+             */
+            SizeType m_stride = 1;
+    };
+
+    template<class T>
+    constexpr StridedView<T> ColumnView<T>::strided(SizeType stride) const noexcept
+    {
+        return {m_values, (m_size + stride - 1) / stride, stride};
+    }
+
+    /**
+     * A non-owning view of one row across a set of columns.
+     *
+     * Data is stored column-major, so the cells of a row are not contiguous: each access reads from a different column's buffer. Nothing is
+     * bounds-checked; the view is only valid for as long as the columns are alive and unmodified.
+     *
+     * @tparam ColumnType The type of the columns. Must provide data() and isValid().
+     */
+    template<class ColumnType>
+    class RowView
+    {
+        public:
+            /**
+             * Alias for the type of values in the row.
+             */
+            using ValueType = typename ColumnType::ValueType;
+
+            /**
+             * Alias for the type used for column indices.
+             */
+            using SizeType = std::size_t;
+
+            /**
+             * Initialise an empty view.
+             */
+            constexpr RowView() noexcept = default;
+
+            /**
+             * Initialise a view of a row.
+             *
+             * @param columns The first column.
+             * @param width The number of columns.
+             * @param row The index of the row in each column.
+             */
+            constexpr RowView(const ColumnType * columns, SizeType width, SizeType row) noexcept
+            :   m_columns(columns),
+                m_width(width),
+                m_row(row)
+            {}
+
+            /**
+             * The number of cells in the row, including missing cells.
+             */
+            [[nodiscard]] constexpr SizeType size() const noexcept
+            {
+                return m_width;
+            }
+
+            /**
+             * The index of the row.
+             */
+            [[nodiscard]] constexpr SizeType row() const noexcept
+            {
+                return m_row;
+            }
+
+            /**
+             * Fetch a cell value.
+             *
+             * @param col The column index. Not bounds-checked.
+             * @return The value. For floating-point types this is NaN if the cell is empty.
+             */
+            [[nodiscard]] const ValueType & operator[](SizeType col) const noexcept
+            {
+                return m_columns[col].data()[m_row];
+            }
+
+            /**
+             * Check whether a cell contains a value.
+             *
+             * @param col The column index. Not bounds-checked.
+             */
+            [[nodiscard]] bool isValid(SizeType col) const noexcept
+            {
+                return m_columns[col].isValid(m_row);
+            }
+
+        private:
+            /**
+             * The first column.
+             */
+            const ColumnType * m_columns = nullptr;
+
+            /**
+             * The number of columns.
+             */
+            SizeType m_width = 0;
+
+            /**
+             * The index of the row.
+             */
+            SizeType m_row = 0;
+    };
+}
+
+#endif
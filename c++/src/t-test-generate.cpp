@@ -0,0 +1,335 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <optional>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "SyntheticData.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Program exit codes.
+     */
+    constexpr const int ExitOk = 0;
+    constexpr const int ExitErrMissingArg = 1;
+    constexpr const int ExitErrInvalidArg = 2;
+    constexpr const int ExitErrNoOutput = 3;
+    constexpr const int ExitErrWriteFailed = 4;
+    constexpr const int ExitErrUnrecognisedOption = 5;
+
+    /**
+     * Options for --distribution command-line arg.
+     */
+    constexpr const char * NormalDistributionArg = "normal";
+    constexpr const char * UniformDistributionArg = "uniform";
+    constexpr const char * ExponentialDistributionArg = "exponential";
+
+    /**
+     * Options for --cache command-line arg. These match the --storage options of t-test.
+     */
+    constexpr const char * FloatCacheTypeArg = "float";
+    constexpr const char * DoubleCacheTypeArg = "double";
+    constexpr const char * LongDoubleCacheTypeArg = "long-double";
+
+    /**
+     * The largest number of digits after the decimal point that can be requested.
+     */
+    constexpr const std::uint64_t MaxPrecision = 17;
+
+    /**
+     * The value types the cache can be written for.
+     */
+    enum class CacheType
+    {
+        Float = 0,
+        Double,
+        LongDouble,
+    };
+
+    /**
+     * Write a summary of the command-line args.
+     *
+     * @param out The output stream to write to.
+     */
+    void writeUsage(std::ostream & out)
+    {
+        out << "Usage: t-test-generate [options] output-path\n"
+            << "\n"
+            << "Writes a synthetic CSV data file. Use \"-\" as the output path to write to stdout.\n"
+            << "\n"
+            << "Options:\n"
+            << "  --rows N               number of rows (default 1000)\n"
+            << "  --columns N            number of columns (default 2)\n"
+            << "  --distribution NAME    normal (default), uniform or exponential\n"
+            << "  --location X           location of the distribution (default 100)\n"
+            << "  --scale X              scale of the distribution (default 15)\n"
+            << "  --shift X              amount added to the location for each successive column (default 0)\n"
+            << "  --missing P            probability that a cell is empty (default 0)\n"
+            << "  --ragged P             probability that a row stops short of the full width (default 0)\n"
+            << "  --seed N               seed (default 0)\n"
+            << "  --precision N          digits after the decimal point (default 6)\n"
+            << "  --cache TYPE           also write the t-test cache for float, double or long-double storage\n"
+            << "  -j, --threads N        threads to generate with; 0 means one per hardware thread (default 1)\n"
+            << "  -h, --help             show this summary\n";
+    }
+
+    /**
+     * Parse the distribution provided on the command line.
+     *
+     * @param distribution The string to parse.
+     *
+     * @return The distribution, or an empty optional if the string is invalid.
+     */
+    std::optional<SyntheticDistribution> parseDistribution(const std::string_view & distribution)
+    {
+        if (NormalDistributionArg == distribution) {
+            return SyntheticDistribution::Normal;
+        } else if (UniformDistributionArg == distribution) {
+            return SyntheticDistribution::Uniform;
+        } else if (ExponentialDistributionArg == distribution) {
+            return SyntheticDistribution::Exponential;
+        }
+
+        return {};
+    }
+
+    /**
+     * Parse the cache value type provided on the command line.
+     *
+     * @param type The string to parse.
+     *
+     * @return The type, or an empty optional if the string is invalid.
+     */
+    std::optional<CacheType> parseCacheType(const std::string_view & type)
+    {
+        if (FloatCacheTypeArg == type) {
+            return CacheType::Float;
+        } else if (DoubleCacheTypeArg == type) {
+            return CacheType::Double;
+        } else if (LongDoubleCacheTypeArg == type) {
+            return CacheType::LongDouble;
+        }
+
+        return {};
+    }
+
+    /**
+     * Parse an unsigned integer option provided on the command line.
+     *
+     * @param value The string to parse.
+     *
+     * @return The value, or an empty optional if the string is not a valid non-negative integer.
+     */
+    std::optional<std::uint64_t> parseUnsigned(const std::string_view & value)
+    {
+        std::uint64_t parsed;
+        auto [firstUnusedChar, exitCode] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+
+        if (exitCode != std::errc() || firstUnusedChar != value.data() + value.size()) {
+            return {};
+        }
+
+        return parsed;
+    }
+
+    /**
+     * Parse a finite number provided on the command line.
+     *
+     * @param value The string to parse.
+     *
+     * @return The value, or an empty optional if the string is not a finite number.
+     */
+    std::optional<double> parseNumber(const std::string_view & value)
+    {
+        double parsed;
+        auto [firstUnusedChar, exitCode] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+
+        if (exitCode != std::errc() || firstUnusedChar != value.data() + value.size() || !std::isfinite(parsed)) {
+            return {};
+        }
+
+        return parsed;
+    }
+}
+
+/**
+ * Entry point.
+ *
+ * Generates a synthetic data file for testing and benchmarking t-test. The same options always produce byte-for-byte the same file, whatever the thread
+ * count. Args are:
+ * - --rows specifies the number of rows. Defaults to 1000.
+ * - --columns specifies the number of columns. Defaults to 2.
+ * - --distribution specifies the distribution of the values. Follow it with "normal" (the default), "uniform" or "exponential".
+ * - --location and --scale specify the parameters of the distribution: the mean and standard deviation of the normal distribution, the lower bound and
+ *   width of the uniform distribution, or the lower bound and mean excess of the exponential distribution. Default to 100 and 15.
+ * - --shift specifies an amount added to the location for each successive column. Defaults to 0.
+ * - --missing specifies the probability that a cell is empty. Defaults to 0.
+ * - --ragged specifies the probability that a row stops short of the full width. Defaults to 0. The first row is always full width.
+ * - --seed specifies the seed. Follow it with a non-negative integer. Defaults to 0.
+ * - --precision specifies the number of digits after the decimal point. Defaults to 6.
+ * - --cache also writes the binary cache that t-test would build for the file, so the file can be analysed straight away without being parsed. Follow it
+ *   with the storage type that will be used with t-test: "float", "double" or "long-double".
+ * - -j (or --threads) specifies the number of threads to generate with. Follow it with a number; 0 means one per hardware thread. Defaults to 1.
+ * - -h (or --help) outputs a summary of the args and exits.
+ * - The first arg not recognised as an option is the path of the file to write. Use "-" to write to stdout (not with --cache). Any other arg that starts
+ *   with "-" is an error, so a mistyped option is never taken for the path.
+ *
+ * @param argc Number of command-line args.
+ * @param argv Command-line args array, all null-terminated c strings.
+ */
+int main(int argc, char ** argv)
+{
+	SyntheticDataOptions options;
+	std::optional<std::string> outputPath;
+	std::optional<CacheType> cache;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg(argv[i]);
+
+		if ("--rows" == arg || "--columns" == arg || "--seed" == arg || "--precision" == arg || "-j" == arg || "--threads" == arg) {
+			++i;
+
+			if (i >= argc) {
+				std::cerr << "ERR " << arg << " option requires a value\n";
+				return ExitErrMissingArg;
+			}
+
+			const auto value = parseUnsigned(argv[i]);
+
+			if (!value
+				|| ("--rows" == arg && 0 == *value)
+				|| ("--columns" == arg && (0 == *value || std::numeric_limits<std::uint32_t>::max() <= *value))
+				|| ("--precision" == arg && MaxPrecision < *value)
+				|| (("-j" == arg || "--threads" == arg) && std::numeric_limits<unsigned int>::max() < *value)) {
+				std::cerr << "ERR invalid value for " << arg << " \"" << argv[i] << "\"\n";
+				return ExitErrInvalidArg;
+			}
+
+			if ("--rows" == arg) {
+				options.rows = *value;
+			} else if ("--columns" == arg) {
+				options.columns = static_cast<std::uint32_t>(*value);
+			} else if ("--seed" == arg) {
+				options.seed = *value;
+			} else if ("--precision" == arg) {
+				options.precision = static_cast<int>(*value);
+			} else {
+				options.threads = static_cast<unsigned int>(*value);
+			}
+		} else if ("--location" == arg || "--scale" == arg || "--shift" == arg || "--missing" == arg || "--ragged" == arg) {
+			++i;
+
+			if (i >= argc) {
+				std::cerr << "ERR " << arg << " option requires a value\n";
+				return ExitErrMissingArg;
+			}
+
+			const auto value = parseNumber(argv[i]);
+			const auto isProbability = ("--missing" == arg || "--ragged" == arg);
+
+			if (!value || (isProbability && !(0.0 <= *value && 1.0 >= *value)) || ("--scale" == arg && 0.0 > *value)) {
+				std::cerr << "ERR invalid value for " << arg << " \"" << argv[i] << "\"\n";
+				return ExitErrInvalidArg;
+			}
+
+			if ("--location" == arg) {
+				options.location = *value;
+			} else if ("--scale" == arg) {
+				options.scale = *value;
+			} else if ("--shift" == arg) {
+				options.shift = *value;
+			} else if ("--missing" == arg) {
+				options.missing = *value;
+			} else {
+				options.ragged = *value;
+			}
+		} else if ("--distribution" == arg) {
+			++i;
+
+			if (i >= argc) {
+				std::cerr << "ERR --distribution option requires a distribution\n";
+				return ExitErrMissingArg;
+			}
+
+			const auto distribution = parseDistribution(argv[i]);
+
+			if (!distribution) {
+				std::cerr << "ERR unrecognised distribution \"" << argv[i] << "\"\n";
+				return ExitErrInvalidArg;
+			}
+
+			options.distribution = *distribution;
+		} else if ("--cache" == arg) {
+			++i;
+
+			if (i >= argc) {
+				std::cerr << "ERR --cache option requires a storage type\n";
+				return ExitErrMissingArg;
+			}
+
+			cache = parseCacheType(argv[i]);
+
+			if (!cache) {
+				std::cerr << "ERR unrecognised storage type \"" << argv[i] << "\"\n";
+				return ExitErrInvalidArg;
+			}
+		} else if ("-h" == arg || "--help" == arg) {
+			writeUsage(std::cout);
+			return ExitOk;
+		} else if (1 < arg.size() && '-' == arg.front()) {
+			std::cerr << "ERR unrecognised option \"" << arg << "\"\n\n";
+			writeUsage(std::cerr);
+			return ExitErrUnrecognisedOption;
+		} else {
+			// first unrecognised arg is the output path
+			outputPath = arg;
+			break;
+		}
+	}
+
+	if (!outputPath) {
+		std::cerr << "No output file provided.\n";
+		return ExitErrNoOutput;
+	}
+
+	const SyntheticData data(options);
+
+	if ("-" == *outputPath) {
+		if (cache) {
+			std::cerr << "ERR --cache can't be used when writing to stdout\n";
+			return ExitErrInvalidArg;
+		}
+
+		std::ios::sync_with_stdio(false);
+		return data.writeCsv(std::cout) ? ExitOk : ExitErrWriteFailed;
+	}
+
+	bool written;
+
+	if (!cache) {
+		std::ofstream out(*outputPath, std::ios::binary | std::ios::trunc);
+		written = out.is_open() && data.writeCsv(out);
+		out.close();
+		written = written && out;
+	} else if (CacheType::Float == *cache) {
+		written = data.writeCsvAndCache<float>(*outputPath);
+	} else if (CacheType::Double == *cache) {
+		written = data.writeCsvAndCache<double>(*outputPath);
+	} else {
+		written = data.writeCsvAndCache<long double>(*outputPath);
+	}
+
+	if (!written) {
+		std::cerr << "ERR could not write \"" << *outputPath << "\"\n";
+		return ExitErrWriteFailed;
+	}
+
+	return ExitOk;
+}
@@ -5,18 +5,142 @@
 #include <functional>
 #include <algorithm>
 #include <optional>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STATISTICS_HAVE_GLOB 1
+#include <glob.h>
+#endif
 
 #include "TTest.h"
+#include "BatchTTest.h"
+#include "PermutationTTest.h"
+#include "Bootstrap.h"
+#include "IncrementalTTest.h"
+#include "DataFileWriter.h"
+#include "Instrumentation.h"
 
 using namespace Statistics;
 
+#if STATISTICS_INSTRUMENTATION
+/*
+ * With instrumentation compiled in, the global allocation functions are replaced so that --stats can report the number and total size of heap
+ * allocations.
+ */
+namespace
+{
+    /**
+     * Helper for the replacement allocation functions.
+     */
+    void * countedAllocation(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        Instrumentation::add(Instrumentation::Counter::Allocations);
+        Instrumentation::add(Instrumentation::Counter::AllocatedBytes, size);
+
+        // aligned_alloc() requires the size to be a multiple of the alignment
+        size = (0 == size ? alignment : (size + alignment - 1) / alignment * alignment);
+        void * ptr = (alignof(std::max_align_t) >= alignment ? std::malloc(size) : std::aligned_alloc(alignment, size));
+
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+}
+
+void * operator new(std::size_t size)
+{
+    return countedAllocation(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return countedAllocation(size);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocation(size, static_cast<std::size_t>(alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocation(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
 /**
  * Instantiation of TTest template for a long double data type.
  *
- * For maintenance - to change the underlying data type for our t-tests, just change the template parameter here.
+ * For maintenance - to change the underlying data type for our t-tests, just change the template parameter here. long double can't be vectorised, so
+ * this uses the scalar code.
  */
 using ConcreteTTest = TTest<long double>;
 
+/**
+ * Instantiation of TTest template storing float values, used for --storage float.
+ *
+ * Values take a quarter of the memory (and bandwidth) of long double; sums are compensated and accumulated in double so precision is retained. The
+ * vectorised kernels accumulate in the storage type, so this uses the scalar code.
+ */
+using FloatStorageTTest = TTest<float, NeumaierSum<double>>;
+
+/**
+ * Instantiation of TTest template storing double values, used for --storage double.
+ *
+ * Sums are pairwise, so they use the vectorised kernels without the rounding error of a naive sum growing with the number of rows.
+ */
+using DoubleStorageTTest = TTest<double, PairwiseSum<double>>;
+
 namespace
 {
     /**
@@ -27,12 +151,62 @@ namespace
     constexpr const int ExitErrUnrecognisedTestType = 2;
     constexpr const int ExitErrNoDataFile = 3;
     constexpr const int ExitErrEmptyDataFile = 4;
+    constexpr const int ExitErrMissingThreadCount = 5;
+    constexpr const int ExitErrInvalidThreadCount = 6;
+    constexpr const int ExitErrMissingStorageType = 7;
+    constexpr const int ExitErrUnrecognisedStorageType = 8;
+    constexpr const int ExitErrMissingControlColumn = 9;
+    constexpr const int ExitErrInvalidControlColumn = 10;
+    constexpr const int ExitErrMissingFileList = 11;
+    constexpr const int ExitErrNoFiles = 12;
+    constexpr const int ExitErrMissingPermutationArg = 13;
+    constexpr const int ExitErrInvalidPermutationArg = 14;
+    constexpr const int ExitErrMissingBootstrapArg = 15;
+    constexpr const int ExitErrInvalidBootstrapArg = 16;
+    constexpr const int ExitErrMissingFollowInterval = 17;
+    constexpr const int ExitErrInvalidFollowInterval = 18;
+    constexpr const int ExitErrMissingColumns = 19;
+    constexpr const int ExitErrInvalidColumns = 20;
+    constexpr const int ExitErrMissingDialectArg = 21;
+    constexpr const int ExitErrInvalidDialectArg = 22;
+    constexpr const int ExitErrIncompatibleOptions = 23;
 
     /**
      * Options for for -t command-line arg.
      */
     constexpr const char * PairedTestTypeArg = "paired";
     constexpr const char * UnpairedTestTypeArg = "unpaired";
+    constexpr const char * WelchTestTypeArg = "welch";
+    constexpr const char * StudentTestTypeArg = "student";
+
+    /**
+     * The available widths for storing values.
+     */
+    enum class StorageType
+    {
+        Float = 0,
+        Double,
+        LongDouble,
+    };
+
+    /**
+     * Options for --storage command-line arg.
+     */
+    constexpr const char * FloatStorageTypeArg = "float";
+    constexpr const char * DoubleStorageTypeArg = "double";
+    constexpr const char * LongDoubleStorageTypeArg = "long-double";
+
+    /**
+     * Named options for the --delimiter command-line arg.
+     */
+    constexpr const char * CommaDelimiterArg = "comma";
+    constexpr const char * TabDelimiterArg = "tab";
+    constexpr const char * SemicolonDelimiterArg = "semicolon";
+
+    /**
+     * Option for the --quote command-line arg that turns quoting off.
+     */
+    constexpr const char * NoQuoteArg = "none";
 
     /**
      * Get a lower-case version of a string.
@@ -66,37 +240,626 @@ namespace
             return TTestType::Paired;
         } else if(UnpairedTestTypeArg == lowerType) {
             return TTestType::Unpaired;
+        } else if(WelchTestTypeArg == lowerType) {
+            return TTestType::Welch;
+        } else if(StudentTestTypeArg == lowerType) {
+            return TTestType::Student;
         }
 
         return {};
     }
 
     /**
-     * Write a DataFile to an output stream.
+     * Parse the storage type provided on the command line to a StorageType.
+     *
+     * @param type The string to parse.
+     *
+     * @return The storage type, or an empty optional if the string is invalid.
+     */
+    std::optional<StorageType> parseStorageType(const std::string_view & type)
+    {
+        const auto lowerType = toLower(type);
+
+        if (FloatStorageTypeArg == lowerType) {
+            return StorageType::Float;
+        } else if (DoubleStorageTypeArg == lowerType) {
+            return StorageType::Double;
+        } else if (LongDoubleStorageTypeArg == lowerType) {
+            return StorageType::LongDouble;
+        }
+
+        return {};
+    }
+
+    /**
+     * Parse the field delimiter provided on the command line.
+     *
+     * @param delimiter The string to parse: "comma", "tab", "semicolon" or a single character.
+     *
+     * @return The delimiter, or an empty optional if the string is invalid or a line end.
+     */
+    std::optional<char> parseDelimiter(const std::string_view & delimiter)
+    {
+        const auto lowerDelimiter = toLower(delimiter);
+
+        if (CommaDelimiterArg == lowerDelimiter) {
+            return ',';
+        } else if (TabDelimiterArg == lowerDelimiter) {
+            return '\t';
+        } else if (SemicolonDelimiterArg == lowerDelimiter) {
+            return ';';
+        } else if (1 == delimiter.size() && '\n' != delimiter.front() && '\r' != delimiter.front()) {
+            return delimiter.front();
+        }
+
+        return {};
+    }
+
+    /**
+     * Parse the quote character provided on the command line.
+     *
+     * @param quote The string to parse: a single character, or "none" to turn quoting off.
+     *
+     * @return The quote character ('\0' for none), or an empty optional if the string is invalid or a line end.
+     */
+    std::optional<char> parseQuote(const std::string_view & quote)
+    {
+        if (NoQuoteArg == toLower(quote)) {
+            return '\0';
+        } else if (1 == quote.size() && '\n' != quote.front() && '\r' != quote.front()) {
+            return quote.front();
+        }
+
+        return {};
+    }
+
+    /**
+     * Parse the thread count provided on the command line.
+     *
+     * @param threads The string to parse.
+     *
+     * @return The thread count, or an empty optional if the string is not a valid non-negative integer.
+     */
+    std::optional<unsigned int> parseThreadCount(const std::string_view & threads)
+    {
+        unsigned int count;
+        auto [firstUnusedChar, exitCode] = std::from_chars(threads.data(), threads.data() + threads.size(), count);
+
+        if (exitCode != std::errc() || firstUnusedChar != threads.data() + threads.size()) {
+            return {};
+        }
+
+        return count;
+    }
+
+    /**
+     * Parse the control column index provided on the command line.
+     *
+     * @param column The string to parse.
+     *
+     * @return The column index, or an empty optional if the string is not a valid non-negative integer.
+     */
+    std::optional<long> parseColumnIndex(const std::string_view & column)
+    {
+        long index;
+        auto [firstUnusedChar, exitCode] = std::from_chars(column.data(), column.data() + column.size(), index);
+
+        if (exitCode != std::errc() || firstUnusedChar != column.data() + column.size() || 0 > index) {
+            return {};
+        }
+
+        return index;
+    }
+
+    /**
+     * Parse the list of columns provided on the command line.
+     *
+     * @param columns The string to parse: column indices or names separated by commas.
+     *
+     * @return The columns, or an empty optional if any of them is empty.
+     */
+    std::optional<std::vector<std::string>> parseColumnList(std::string_view columns)
+    {
+        std::vector<std::string> list;
+
+        while (true) {
+            const auto separatorPos = columns.find(',');
+            const auto column = columns.substr(0, separatorPos);
+
+            if (column.empty()) {
+                return {};
+            }
+
+            list.emplace_back(column);
+
+            if (std::string_view::npos == separatorPos) {
+                return list;
+            }
+
+            columns.remove_prefix(separatorPos + 1);
+        }
+    }
+
+    /**
+     * Select the columns to load.
+     *
+     * If every column in the list is an index, the columns are selected by index; otherwise they are all selected by name.
+     *
+     * @param loadOptions The options to select the columns in.
+     * @param columns The columns, as given on the command line.
+     */
+    void selectColumns(LoadOptions & loadOptions, const std::vector<std::string> & columns)
+    {
+        std::vector<std::size_t> indices;
+
+        for (const auto & column : columns) {
+            const auto index = parseColumnIndex(column);
+
+            if (!index) {
+                loadOptions.columnNames = columns;
+                return;
+            }
+
+            indices.push_back(static_cast<std::size_t>(*index));
+        }
+
+        loadOptions.columns = std::move(indices);
+    }
+
+    /**
+     * Parse an unsigned integer option provided on the command line.
+     *
+     * @param value The string to parse.
+     *
+     * @return The value, or an empty optional if the string is not a valid non-negative integer.
+     */
+    std::optional<std::uint64_t> parseUnsigned(const std::string_view & value)
+    {
+        std::uint64_t parsed;
+        auto [firstUnusedChar, exitCode] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+
+        if (exitCode != std::errc() || firstUnusedChar != value.data() + value.size()) {
+            return {};
+        }
+
+        return parsed;
+    }
+
+    /**
+     * Parse a probability provided on the command line.
+     *
+     * @param value The string to parse.
+     *
+     * @return The value, or an empty optional if the string is not a number in [0, 1].
+     */
+    std::optional<double> parseProbability(const std::string_view & value)
+    {
+        double parsed;
+        auto [firstUnusedChar, exitCode] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+
+        if (exitCode != std::errc() || firstUnusedChar != value.data() + value.size() || !(0.0 <= parsed && 1.0 >= parsed)) {
+            return {};
+        }
+
+        return parsed;
+    }
+
+    /**
+     * Read a list of paths, one per line.
+     *
+     * Blank lines are skipped.
+     *
+     * @param in The stream to read the list from.
+     * @param paths The vector to add the paths to.
+     */
+    void readPathList(std::istream & in, std::vector<std::string> & paths)
+    {
+        std::string path;
+
+        while (std::getline(in, path)) {
+            if (!path.empty() && '\r' == path.back()) {
+                path.pop_back();
+            }
+
+            if (!path.empty()) {
+                paths.push_back(std::move(path));
+            }
+        }
+    }
+
+    /**
+     * Read a list of paths from a file.
+     *
+     * @param listPath The file containing the paths. Use "-" to read from stdin.
+     * @param paths The vector to add the paths to.
+     * @return true if the list was read, false if it could not be opened.
+     */
+    bool readPathList(const std::string & listPath, std::vector<std::string> & paths)
+    {
+        if ("-" == listPath) {
+            readPathList(std::cin, paths);
+            return true;
+        }
+
+        std::ifstream in(listPath);
+
+        if (!in.is_open()) {
+            return false;
+        }
+
+        readPathList(in, paths);
+        return true;
+    }
+
+    /**
+     * Expand a glob pattern to the paths that match it.
+     *
+     * Paths are added in the (sorted) order glob() produces them.
+     *
+     * @param pattern The pattern.
+     * @param paths The vector to add the paths to.
+     * @return true if globbing is supported on this platform, false otherwise.
+     */
+    bool expandGlob(const std::string & pattern, std::vector<std::string> & paths)
+    {
+#if defined(STATISTICS_HAVE_GLOB)
+        ::glob_t matches{};
+
+        if (0 == ::glob(pattern.c_str(), 0, nullptr, &matches)) {
+            for (std::size_t idx = 0; idx < matches.gl_pathc; ++idx) {
+                paths.emplace_back(matches.gl_pathv[idx]);
+            }
+        }
+
+        ::globfree(&matches);
+        return true;
+#else
+        static_cast<void>(pattern);
+        static_cast<void>(paths);
+        return false;
+#endif
+    }
+
+    /**
+     * Writes the --stats report to stderr when it goes out of scope, so that it is written however the run ends.
+     */
+    class StatsReport
+    {
+        public:
+            /**
+             * @param enabled Whether to write the report.
+             */
+            explicit StatsReport(bool enabled)
+            :   m_enabled(enabled)
+            {}
+
+            StatsReport(const StatsReport &) = delete;
+            StatsReport & operator=(const StatsReport &) = delete;
+
+            ~StatsReport()
+            {
+                if (m_enabled) {
+                    Instrumentation::report(std::cerr);
+                }
+            }
+
+        private:
+            /**
+             * Whether to write the report.
+             */
+            bool m_enabled;
+    };
+
+    /**
+     * Write the outcome of a test.
+     *
+     * t is always written. The degrees of freedom and p-values are written on separate lines following it if asked for.
      *
-     * @tparam T The (inferred) value type for the data file.
      * @param out The output stream to write to.
-     * @param data The DataFile to write.
-     * @return The output stream.
+     * @param result The outcome of the test.
+     * @param pValues Whether to write the degrees of freedom and p-values.
      */
-    template<class ValueType>
-    std::ostream & operator<<(std::ostream & out, const DataFile<ValueType> & data)
+    template<class T>
+    void writeResult(std::ostream & out, const TTestResult<T> & result, bool pValues)
     {
-        out << std::dec << std::fixed << std::left << std::setfill(' ') << std::setprecision(3);
+        out << "t = " << std::fixed << std::setprecision(6) << result.t << "\n";
+
+        if (pValues) {
+            out << "df = " << result.degreesOfFreedom << "\n"
+                << std::defaultfloat
+                << "p (one-tailed) = " << result.oneTailedP << "\n"
+                << "p (two-tailed) = " << result.twoTailedP << "\n";
+        }
+    }
 
-        for (int row = 0; row < data.rowCount(); ++row) {
-            for (int column = 0; column < data.columnCount(); ++column) {
-                try {
-                    out << data.item(row, column) << "  ";
-                } catch (const std::invalid_argument & e) {
-                    out << "      ";
+    /**
+     * Load a data file, output it (unless asked not to) and output t.
+     *
+     * @tparam TestClass The TTest instantiation to use.
+     * @param path The path to the data file.
+     * @param type The type of test.
+     * @param loadOptions The options for loading the data file.
+     * @param echo Whether to output the data before t.
+     * @param pValues Whether to output the degrees of freedom and p-values as well as t.
+     * @param permutation If set, also run a permutation test with these options and output its p-value.
+     * @param bootstrap If set, also bootstrap the difference between the means with these options and output the confidence intervals.
+     * @return The program exit code.
+     */
+    template<class TestClass>
+    int runTest(const std::string & path, const TTestType & type, const LoadOptions & loadOptions, bool echo, bool pValues,
+                const std::optional<PermutationOptions> & permutation, const std::optional<BootstrapOptions> & bootstrap)
+    {
+        // read and output the data
+        auto data = typename TestClass::DataFileType(path, loadOptions);
+
+        if (data.isEmpty()) {
+            std::cerr << "No data in data file (or data file does not exist or could not be opened).\n";
+            return ExitErrEmptyDataFile;
+        }
+
+        if (echo) {
+            const Instrumentation::ScopedTimer timer(Instrumentation::Phase::Output);
+            DataFileWriter(3).write(std::cout, data);
+        }
+
+        // output the calculated statistic - note we don't need the data any longer so we move it into the test object, which shares it with the
+        // permutation test
+        const TestClass test(std::move(data), type);
+
+        if (pValues) {
+            writeResult(std::cout, test.result(), true);
+        } else {
+            std::cout << "t = " << std::fixed << std::setprecision(6) << test.t() << "\n";
+        }
+
+        if (permutation) {
+            try {
+                const auto result = PermutationTTest<typename TestClass::ValueType, typename TestClass::AccumulatorType>(test.dataPtr(), type).run(*permutation);
+                std::cout << "p (permutation) = " << std::defaultfloat << std::setprecision(6) << result.p << " (" << result.permutations
+                          << (result.exact ? " permutations, exact" : " random permutations") << ")\n";
+            } catch (const std::length_error & err) {
+                std::cerr << "ERR " << err.what() << "\n";
+                return ExitErrInvalidPermutationArg;
+            }
+        }
+
+        if (bootstrap) {
+            const auto result = MeanDifferenceBootstrap<typename TestClass::ValueType, typename TestClass::AccumulatorType>(test.dataPtr(), type).run(*bootstrap);
+            const auto writeInterval = [confidence = bootstrap->confidence](const char * method, const auto & interval) {
+                std::cout << "CI (" << method << ", " << std::defaultfloat << std::setprecision(6) << confidence * 100 << "%) = ["
+                          << std::fixed << interval.lower << ", " << interval.upper << "]\n";
+            };
+
+            std::cout << "mean difference = " << std::fixed << std::setprecision(6) << result.meanDifference << "\n";
+            writeInterval("percentile", result.percentile);
+            writeInterval("BCa", result.bca);
+        }
+
+        return ExitOk;
+    }
+
+    /**
+     * Calculate t in a single pass over a data file, without loading it, and output the result.
+     *
+     * Nothing is stored, so the storage width only decides the precision of the calculation: each value is parsed and accumulated at the precision the
+     * TTest instantiation accumulates sums in, as --follow does.
+     *
+     * @tparam TestClass The TTest instantiation to match.
+     * @param path The path to the data file. Use "-" to read from stdin.
+     * @param type The type of test.
+     * @param loadOptions The options for loading the data file. Only the dialect is used.
+     * @param pValues Whether to output the degrees of freedom and p-values as well as t.
+     * @return The program exit code.
+     */
+    template<class TestClass>
+    int runStream(const std::string & path, const TTestType & type, const LoadOptions & loadOptions, bool pValues)
+    {
+        StreamingTTest<typename TestClass::ResultType> test(type, loadOptions.dialect);
+
+        if (!test.read(path)) {
+            std::cerr << "Data file does not exist or could not be opened.\n";
+            return ExitErrEmptyDataFile;
+        }
+
+        writeResult(std::cout, test.result(), pValues);
+        return ExitOk;
+    }
+
+    /**
+     * Load a data file, output t, then follow the file as rows are appended to it, outputting t again whenever it changes.
+     *
+     * Only the bytes appended since the file was last read are parsed, and t is updated incrementally from the new rows (see IncrementalTTest). The
+     * data is not echoed. Each line is the number of rows, a tab and t, optionally followed by tab-separated degrees of freedom and one- and two-tailed
+     * p-values. Runs until the process is interrupted.
+     *
+     * @tparam TestClass The TTest instantiation whose value and accumulator types to use.
+     * @param path The path to the data file.
+     * @param type The type of test.
+     * @param loadOptions The options for loading the data file.
+     * @param pValues Whether to output the degrees of freedom and p-values as well as t.
+     * @param interval How long to wait between checks for new rows.
+     * @return The program exit code, if the file can't be loaded.
+     */
+    template<class TestClass>
+    int runFollow(const std::string & path, const TTestType & type, const LoadOptions & loadOptions, bool pValues, std::chrono::milliseconds interval)
+    {
+        using Test = IncrementalTTest<typename TestClass::ValueType, typename TestClass::AccumulatorType>;
+        auto data = typename Test::DataFileType(path, loadOptions);
+
+        if (data.isEmpty()) {
+            std::cerr << "No data in data file (or data file does not exist or could not be opened).\n";
+            return ExitErrEmptyDataFile;
+        }
+
+        Test test(std::move(data), type);
+
+        const auto writeLine = [&test, pValues]() {
+            const auto result = test.result();
+            std::cout << test.rowCount() << '\t' << std::fixed << std::setprecision(6) << result.t;
+
+            if (pValues) {
+                std::cout << '\t' << result.degreesOfFreedom << '\t' << std::defaultfloat << result.oneTailedP << '\t' << result.twoTailedP;
+            }
+
+            // flushed so that whatever is reading the output sees each update as it happens
+            std::cout << std::endl;
+        };
+
+        writeLine();
+
+        while (true) {
+            std::this_thread::sleep_for(interval);
+
+            if (test.refresh() < test.rowCount()) {
+                writeLine();
+            }
+        }
+    }
+
+    /**
+     * Load a data file and output a table of t for many pairs of its columns.
+     *
+     * The data is not echoed. Each line of the table contains the two column indices (in the file, whatever columns were loaded) and t for that pair,
+     * optionally followed by the degrees of freedom and the one- and two-tailed p-values.
+     *
+     * @tparam TestClass The TTest instantiation whose value and accumulator types to use.
+     * @param path The path to the data file.
+     * @param type The type of test.
+     * @param loadOptions The options for loading the data file. The thread count is also used for the tests.
+     * @param control The control column to test every other column against, by index in the file or by name. If empty, all pairs of columns are
+     * tested.
+     * @param pValues Whether to output the degrees of freedom and p-values as well as t.
+     * @return The program exit code.
+     */
+    template<class TestClass>
+    int runBatch(const std::string & path, const TTestType & type, const LoadOptions & loadOptions, const std::optional<std::string> & control, bool pValues)
+    {
+        using Batch = BatchTTest<typename TestClass::ValueType, typename TestClass::AccumulatorType>;
+        auto data = typename Batch::DataFileType(path, loadOptions);
+
+        if (data.isEmpty()) {
+            std::cerr << "No data in data file (or data file does not exist or could not be opened).\n";
+            return ExitErrEmptyDataFile;
+        }
+
+        using IndexType = typename Batch::DataFileType::IndexType;
+        const auto columnCount = data.columnCount();
+        std::vector<IndexType> sourceColumns;
+
+        for (IndexType col = 0; col < columnCount; ++col) {
+            sourceColumns.push_back(data.sourceColumn(col));
+        }
+
+        std::optional<IndexType> controlColumn;
+
+        if (control) {
+            if (const auto index = parseColumnIndex(*control); index) {
+                const auto source = std::find(sourceColumns.cbegin(), sourceColumns.cend(), static_cast<IndexType>(*index));
+
+                if (sourceColumns.cend() != source) {
+                    controlColumn = static_cast<IndexType>(source - sourceColumns.cbegin());
                 }
+            } else {
+                controlColumn = data.columnIndex(*control);
+            }
+
+            if (!controlColumn) {
+                std::cerr << "ERR control column " << *control << " is not in the data file (it has " << columnCount << " columns)\n";
+                return ExitErrInvalidControlColumn;
+            }
+        }
+
+        const auto pairs = (controlColumn ? Batch::allVersusControl(columnCount, *controlColumn) : Batch::allPairs(columnCount));
+        const auto results = Batch(std::move(data), type).run(pairs, loadOptions.threads);
+
+        std::cout << std::right << std::setw(6) << "a" << std::setw(6) << "b" << std::setw(14) << "t";
+
+        if (pValues) {
+            std::cout << std::setw(14) << "df" << std::setw(14) << "p1" << std::setw(14) << "p2";
+        }
+
+        std::cout << "\n" << std::setprecision(6);
+
+        for (const auto & result : results) {
+            std::cout << std::fixed << std::setw(6) << sourceColumns[static_cast<std::size_t>(result.first)] << std::setw(6)
+                      << sourceColumns[static_cast<std::size_t>(result.second)] << std::setw(14) << result.t;
+
+            if (pValues) {
+                std::cout << std::setw(14) << result.degreesOfFreedom << std::defaultfloat << std::setw(14) << result.oneTailedP << std::setw(14) << result.twoTailedP;
             }
 
-            out << "\n";
+            std::cout << "\n";
         }
 
-        return out;
+        return ExitOk;
+    }
+
+    /**
+     * Calculate t for each of a list of data files and output one line per file.
+     *
+     * Files are loaded and tested concurrently; each thread takes the next unprocessed file as soon as it finishes one, so a few large files don't hold
+     * up the rest. Each line is the path, a tab and either t (optionally followed by tab-separated degrees of freedom and one- and two-tailed p-values)
+     * or an error, and the lines are always output in the same order as the paths, whatever order the files finish in. The data is not echoed. A file
+     * that can't be loaded, has fewer than two columns or has too little data to calculate t is an error; it doesn't stop the other files being tested.
+     *
+     * @tparam TestClass The TTest instantiation to use.
+     * @param paths The paths to the data files.
+     * @param type The type of test.
+     * @param loadOptions The options for loading the data files. The thread count is the maximum number of files to process concurrently.
+     * @param pValues Whether to output the degrees of freedom and p-values as well as t.
+     * @return The program exit code. This is ExitOk if every file was tested, ExitErrEmptyDataFile otherwise.
+     */
+    template<class TestClass>
+    int runFiles(const std::vector<std::string> & paths, const TTestType & type, const LoadOptions & loadOptions, bool pValues)
+    {
+        std::vector<std::string> lines(paths.size());
+        std::vector<char> failed(paths.size(), 0);
+        auto fileLoadOptions = loadOptions;
+
+        // each file is parsed single-threaded; the parallelism is across files
+        fileLoadOptions.threads = 1;
+
+        parallelFor(loadOptions.threads, paths.size(), [&paths, &lines, &failed, &type, &fileLoadOptions, pValues](std::size_t idx) {
+            std::ostringstream line;
+            line << paths[idx] << '\t';
+
+            // one bad file must not take the rest of the list down with it, so everything that can go wrong is reported on the file's own line
+            try {
+                auto data = typename TestClass::DataFileType(paths[idx], fileLoadOptions);
+
+                if (data.isEmpty()) {
+                    line << "ERR no data in data file (or data file does not exist or could not be opened)";
+                    failed[idx] = 1;
+                } else if (2 > data.columnCount() || 0 == data.columnItemCount(1)) {
+                    line << "ERR data file has fewer than two columns";
+                    failed[idx] = 1;
+                } else {
+                    const auto result = TestClass(std::move(data), type).result();
+
+                    if (!(0 < result.degreesOfFreedom) || std::isnan(result.t)) {
+                        line << "ERR too little data to calculate t";
+                        failed[idx] = 1;
+                    } else if (pValues) {
+                        line << std::fixed << std::setprecision(6) << result.t << '\t' << result.degreesOfFreedom << '\t'
+                             << std::defaultfloat << result.oneTailedP << '\t' << result.twoTailedP;
+                    } else {
+                        line << std::fixed << std::setprecision(6) << result.t;
+                    }
+                }
+            } catch (const std::exception & err) {
+                line.str("");
+                line << paths[idx] << "\tERR " << err.what();
+                failed[idx] = 1;
+            }
+
+            lines[idx] = line.str();
+        });
+
+        for (const auto & line : lines) {
+            std::cout << line << '\n';
+        }
+
+        return std::find(failed.cbegin(), failed.cend(), 1) == failed.cend() ? ExitOk : ExitErrEmptyDataFile;
     }
 }
 
@@ -104,8 +867,56 @@ namespace
  * Entry point.
  * 
  * As always, the first argv is the binary. Other possible args are:
- * - -t specifies the type of test. Follow it with "paired" or "unpaired".
- * - The first arg not recognised as an option is considered the name of the data file.
+ * - -t specifies the type of test. Follow it with "paired", "unpaired" (unpooled variance, n1 + n2 - 2 degrees of freedom; the default), "welch"
+ *   (Welch's, unpooled variance and Welch–Satterthwaite degrees of freedom) or "student" (Student's, pooled variance).
+ * - -p (or --p-values) also outputs the degrees of freedom and the one- and two-tailed p-values.
+ * - -q (or --quiet, or --no-echo) outputs only the results, without first echoing the data.
+ * - --stream calculates t in a single pass over the data file without loading it into memory. The data is not echoed. No values are stored, so with
+ *   --storage float or double the calculation is simply done in double precision.
+ * - --columns specifies the columns to test. Follow it with their (0-based) indices or their names in the data file's header, separated by commas,
+ *   e.g. 3,7 or before,after. Name the columns all by index or all by name; a list that isn't all indices is all names. Only these columns are parsed
+ *   (and echoed). A single test needs exactly two and defaults to 0,1, and unless the data is echoed the other columns are skipped even without this
+ *   option. With --all-pairs or --control, the pairs are made from these columns (and the control column). Not available with --stream.
+ * - --delimiter specifies the character that separates the fields of the data file. Follow it with "comma" (the default), "tab", "semicolon" or a
+ *   single character.
+ * - --quote specifies the character that encloses fields containing delimiters or line ends. Follow it with a single character, or "none" to turn
+ *   quoting off. Defaults to a double quote. A quoted cell is parsed by its content, so "1.5" is the value 1.5.
+ * - --storage specifies the width of the values held in memory. Follow it with "float", "double" or "long-double" (the default). Narrower storage
+ *   uses less memory. float values are summed in compensated double precision; double values are summed pairwise with the vectorised (AVX2 or
+ *   AVX-512) kernels where the CPU has them, which is the fastest option.
+ * - --all-pairs tests every pair of columns and outputs a table of the results instead of echoing the data.
+ * - --control tests every column against a control column and outputs a table of the results instead of echoing the data. Follow it with the
+ *   (0-based) index of the control column or its name in the header.
+ * - --files tests each of a list of data files, outputting a line with the path and t for each. Follow it with the path to a file containing the
+ *   list, one path per line, or "-" to read the list from stdin. No data file argument is required.
+ * - --glob tests each data file matching a pattern, like --files. Follow it with the pattern (quoted so that the shell doesn't expand it). May be
+ *   combined with --files and given more than once.
+ * - --permutations also runs a permutation test and outputs its p-value. Follow it with the number of random permutations to sample; if the data has no
+ *   more than 100000 distinct permutations they are all evaluated instead.
+ * - --exact runs an exact permutation test, evaluating every permutation however many there are.
+ * - --seed specifies the seed for the random permutations and bootstrap resamples. Follow it with a non-negative integer. Defaults to 0.
+ * - --tolerance stops sampling random permutations once the 99% confidence interval for the permutation p-value is no wider than plus or minus this.
+ *   Follow it with a probability.
+ * - --permutations, --exact and --tolerance are only available for a single test, not with --stream, --follow, --files, --glob, --all-pairs or
+ *   --control.
+ * - --bootstrap also outputs the difference between the means with percentile and BCa bootstrap confidence intervals. Follow it with the number of
+ *   bootstrap replicates.
+ * - --confidence specifies the confidence level for the bootstrap intervals. Follow it with a probability. Defaults to 0.95. --bootstrap and
+ *   --confidence are only available for a single test, like the permutation options.
+ * - --follow outputs t, then watches the data file and outputs t again (with the row count) whenever rows are appended to it. Only the appended bytes are
+ *   read, and t is updated incrementally. Runs until interrupted. Tests the columns given with --columns, or 0,1. Not available with stdin, --stream,
+ *   --files, --glob, --all-pairs or --control.
+ * - --interval specifies how often --follow checks for new rows. Follow it with a number of seconds. Defaults to 1.
+ * - --no-cache always parses the data file. By default a binary cache of the parsed data is kept alongside each data file (with the columns loaded,
+ *   the delimiter and quote if they aren't the default, the value type and ".ttcache" appended to its name) and mapped instead of parsing the file, and rebuilt whenever the data file's size or modification time changes.
+ * - --stats writes a report to stderr once the run is complete: the bytes read, rows, cells and parse errors parsed, heap allocations, and the wall time
+ *   spent loading, parsing, reading and writing the cache, echoing the data, summarising columns and calculating the statistic. Phases can nest (loading
+ *   includes parsing, for example). Only available if t-test was built with instrumentation (the TTEST_INSTRUMENTATION CMake option, on by default).
+ * - -j (or --threads) specifies the number of threads to use to parse the data file, run batch tests, or process files concurrently. Follow it with a number; 0 means one per
+ *   hardware thread.
+ * - The first arg not recognised as an option is considered the name of the data file. Use "-" to read the data from stdin.
+ *
+ * If the first line of the data file contains no numbers it is a header naming the columns, and is not part of the data.
  *
  * @param argc Number of command-line args.
  * @param argv Command-line args array, all null-terminated c strings.
@@ -114,6 +925,22 @@ int main(int argc, char ** argv)
 {
 	auto type = TTestType::Unpaired;
 	std::optional<std::string> dataFilePath;
+    LoadOptions loadOptions;
+    loadOptions.cache = CacheMode::Update;
+    bool stream = false;
+    auto storage = StorageType::LongDouble;
+    bool batch = false;
+    std::optional<std::string> control;
+    std::optional<std::vector<std::string>> dataFilePaths;
+    bool pValues = false;
+    std::optional<PermutationOptions> permutation;
+    std::optional<BootstrapOptions> bootstrap;
+    std::uint64_t seed = 0;
+    bool follow = false;
+    std::chrono::milliseconds followInterval(1000);
+    bool stats = false;
+    bool echo = true;
+    std::optional<std::vector<std::string>> columns;
 
     // read command-line args
 	if (1 < argc) {
@@ -124,7 +951,7 @@ int main(int argc, char ** argv)
 				++i;
 
 				if (i >= argc) {
-					std::cerr << "ERR -t option requires a type of test - paired or unpaired\n";
+					std::cerr << "ERR -t option requires a type of test - paired, unpaired, welch or student\n";
 					return ExitErrMissingTestType;
 				}
 
@@ -136,6 +963,218 @@ int main(int argc, char ** argv)
 				}
 
 				type = *parsedType;
+			} else if ("-p" == arg || "--p-values" == arg) {
+				pValues = true;
+			} else if ("--permutations" == arg || "--seed" == arg || "--tolerance" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR " << arg << " option requires a value\n";
+					return ExitErrMissingPermutationArg;
+				}
+
+				if ("--tolerance" == arg) {
+					auto tolerance = parseProbability(argv[i]);
+
+					if (!tolerance) {
+						std::cerr << "ERR invalid tolerance \"" << argv[i] << "\"\n";
+						return ExitErrInvalidPermutationArg;
+					}
+
+					if (!permutation) {
+						permutation.emplace();
+					}
+
+					permutation->tolerance = *tolerance;
+				} else {
+					auto value = parseUnsigned(argv[i]);
+
+					if (!value || ("--permutations" == arg && 0 == *value)) {
+						std::cerr << "ERR invalid " << arg.substr(2) << " \"" << argv[i] << "\"\n";
+						return ExitErrInvalidPermutationArg;
+					}
+
+					if ("--seed" == arg) {
+						seed = *value;
+					} else {
+						if (!permutation) {
+							permutation.emplace();
+						}
+
+						permutation->permutations = *value;
+					}
+				}
+			} else if ("--bootstrap" == arg || "--confidence" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR " << arg << " option requires a value\n";
+					return ExitErrMissingBootstrapArg;
+				}
+
+				if (!bootstrap) {
+					bootstrap.emplace();
+				}
+
+				if ("--confidence" == arg) {
+					auto confidence = parseProbability(argv[i]);
+
+					if (!confidence || 0.0 == *confidence || 1.0 == *confidence) {
+						std::cerr << "ERR invalid confidence level \"" << argv[i] << "\"\n";
+						return ExitErrInvalidBootstrapArg;
+					}
+
+					bootstrap->confidence = *confidence;
+				} else {
+					auto replicates = parseUnsigned(argv[i]);
+
+					if (!replicates || 0 == *replicates) {
+						std::cerr << "ERR invalid bootstrap replicate count \"" << argv[i] << "\"\n";
+						return ExitErrInvalidBootstrapArg;
+					}
+
+					bootstrap->replicates = *replicates;
+				}
+			} else if ("--exact" == arg) {
+				if (!permutation) {
+					permutation.emplace();
+				}
+
+				permutation->mode = PermutationMode::Exact;
+			} else if ("--follow" == arg) {
+				follow = true;
+			} else if ("--interval" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR --interval option requires a number of seconds\n";
+					return ExitErrMissingFollowInterval;
+				}
+
+				const std::string_view value(argv[i]);
+				double seconds;
+				auto [firstUnusedChar, exitCode] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+
+				if (exitCode != std::errc() || firstUnusedChar != value.data() + value.size() || !(0.0 < seconds)) {
+					std::cerr << "ERR invalid interval \"" << argv[i] << "\"\n";
+					return ExitErrInvalidFollowInterval;
+				}
+
+				followInterval = std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(std::ceil(seconds * 1000)));
+			} else if ("-q" == arg || "--quiet" == arg || "--no-echo" == arg) {
+				echo = false;
+			} else if ("--columns" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR --columns option requires a list of columns\n";
+					return ExitErrMissingColumns;
+				}
+
+				columns = parseColumnList(argv[i]);
+
+				if (!columns) {
+					std::cerr << "ERR invalid columns \"" << argv[i] << "\"\n";
+					return ExitErrInvalidColumns;
+				}
+			} else if ("--delimiter" == arg || "--quote" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR " << arg << " option requires a character\n";
+					return ExitErrMissingDialectArg;
+				}
+
+				const auto character = ("--delimiter" == arg ? parseDelimiter(argv[i]) : parseQuote(argv[i]));
+
+				if (!character) {
+					std::cerr << "ERR invalid " << arg.substr(2) << " \"" << argv[i] << "\"\n";
+					return ExitErrInvalidDialectArg;
+				}
+
+				if ("--delimiter" == arg) {
+					loadOptions.dialect.delimiter = *character;
+				} else {
+					loadOptions.dialect.quote = *character;
+				}
+			} else if ("--stats" == arg) {
+				stats = true;
+			} else if ("--no-cache" == arg) {
+				loadOptions.cache = CacheMode::Off;
+			} else if ("--stream" == arg) {
+				stream = true;
+			} else if ("--storage" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR --storage option requires a storage type - float, double or long-double\n";
+					return ExitErrMissingStorageType;
+				}
+
+				auto parsedStorage = parseStorageType(argv[i]);
+
+				if (!parsedStorage) {
+					std::cerr << "ERR unrecognised storage type \"" << argv[i] << "\"\n";
+					return ExitErrUnrecognisedStorageType;
+				}
+
+				storage = *parsedStorage;
+			} else if ("--all-pairs" == arg) {
+				batch = true;
+				control.reset();
+			} else if ("--control" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR --control option requires a column index or name\n";
+					return ExitErrMissingControlColumn;
+				}
+
+				control = argv[i];
+
+				if (control->empty()) {
+					std::cerr << "ERR invalid control column \"" << argv[i] << "\"\n";
+					return ExitErrInvalidControlColumn;
+				}
+
+				batch = true;
+			} else if ("--files" == arg || "--glob" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR " << arg << " option requires " << ("--files" == arg ? "the path to a list of files" : "a pattern") << "\n";
+					return ExitErrMissingFileList;
+				}
+
+				if (!dataFilePaths) {
+					dataFilePaths.emplace();
+				}
+
+				if ("--files" == arg) {
+					if (!readPathList(argv[i], *dataFilePaths)) {
+						std::cerr << "ERR could not open file list \"" << argv[i] << "\"\n";
+						return ExitErrNoFiles;
+					}
+				} else if (!expandGlob(argv[i], *dataFilePaths)) {
+					std::cerr << "ERR --glob is not supported on this platform\n";
+					return ExitErrNoFiles;
+				}
+			} else if ("-j" == arg || "--threads" == arg) {
+				++i;
+
+				if (i >= argc) {
+					std::cerr << "ERR " << arg << " option requires a number of threads\n";
+					return ExitErrMissingThreadCount;
+				}
+
+				auto threads = parseThreadCount(argv[i]);
+
+				if (!threads) {
+					std::cerr << "ERR invalid thread count \"" << argv[i] << "\"\n";
+					return ExitErrInvalidThreadCount;
+				}
+
+				loadOptions.threads = *threads;
 			} else {
 				// first unrecognised arg is data file path
 				dataFilePath = arg;
@@ -144,22 +1183,134 @@ int main(int argc, char ** argv)
 		}
 	}
 
+	const StatsReport statsReport(stats);
+
+	if (loadOptions.dialect.delimiter == loadOptions.dialect.quote) {
+		std::cerr << "ERR the delimiter and the quote must be different characters\n";
+		return ExitErrInvalidDialectArg;
+	}
+
+	if (permutation || bootstrap) {
+		const char * incompatible = (dataFilePaths ? "--files or --glob" : (batch ? "--all-pairs or --control" : (stream ? "--stream" : (follow ? "--follow" : nullptr))));
+
+		if (incompatible) {
+			std::cerr << "ERR " << (permutation ? "--permutations, --exact and --tolerance" : "--bootstrap and --confidence") << " can't be used with " << incompatible << "\n";
+			return ExitErrIncompatibleOptions;
+		}
+	}
+
+	if (columns && stream) {
+		std::cerr << "ERR --columns can't be used with --stream\n";
+		return ExitErrInvalidColumns;
+	}
+
+	if (follow) {
+		const char * incompatible = (stream ? "--stream" : (dataFilePaths ? "--files or --glob" : (batch ? "--all-pairs or --control" : nullptr)));
+
+		if (incompatible) {
+			std::cerr << "ERR --follow can't be used with " << incompatible << "\n";
+			return ExitErrIncompatibleOptions;
+		}
+
+		if (dataFilePath && "-" == *dataFilePath) {
+			std::cerr << "ERR --follow requires a data file; it can't follow stdin\n";
+			return ExitErrIncompatibleOptions;
+		}
+	}
+
+	if (columns && !batch && 2 != columns->size()) {
+		std::cerr << "ERR --columns requires exactly two columns unless used with --all-pairs or --control\n";
+		return ExitErrInvalidColumns;
+	}
+
+	// only the columns being tested are parsed, unless every column is to be echoed
+	if (batch) {
+		if (columns) {
+			if (control && std::find(columns->cbegin(), columns->cend(), *control) == columns->cend()) {
+				columns->insert(columns->begin(), *control);
+			}
+
+			selectColumns(loadOptions, *columns);
+		}
+	} else if (columns) {
+		selectColumns(loadOptions, *columns);
+	} else if (!echo || follow || dataFilePaths) {
+		loadOptions.columns = ConcreteTTest::Columns;
+	}
+
+	if (permutation) {
+		permutation->threads = loadOptions.threads;
+		permutation->seed = seed;
+	}
+
+	if (bootstrap) {
+		bootstrap->threads = loadOptions.threads;
+		bootstrap->seed = seed;
+	}
+
+	if (dataFilePaths) {
+		if (dataFilePaths->empty()) {
+			std::cerr << "No data files found.\n";
+			return ExitErrNoFiles;
+		}
+
+		switch (storage) {
+			case StorageType::Float:
+				return runFiles<FloatStorageTTest>(*dataFilePaths, type, loadOptions, pValues);
+
+			case StorageType::Double:
+				return runFiles<DoubleStorageTTest>(*dataFilePaths, type, loadOptions, pValues);
+
+			default:
+				return runFiles<ConcreteTTest>(*dataFilePaths, type, loadOptions, pValues);
+		}
+	}
+
 	if (!dataFilePath) {
 		std::cerr << "No data file provided.\n";
 		return ExitErrNoDataFile;
 	}
 
-	// read and output the data
-	auto data = ConcreteTTest::DataFileType(*dataFilePath);
-	
-	if (data.isEmpty()) {
-		std::cerr << "No data in data file (or data file does not exist or could not be opened).\n";
-		return ExitErrEmptyDataFile;
+	if (follow) {
+		switch (storage) {
+			case StorageType::Float:
+				return runFollow<FloatStorageTTest>(*dataFilePath, type, loadOptions, pValues, followInterval);
+
+			case StorageType::Double:
+				return runFollow<DoubleStorageTTest>(*dataFilePath, type, loadOptions, pValues, followInterval);
+
+			default:
+				return runFollow<ConcreteTTest>(*dataFilePath, type, loadOptions, pValues, followInterval);
+		}
 	}
-	
-	std::cout << std::dec << std::fixed << std::left << std::setfill(' ') << std::setprecision(3) << data;
 
-	// output the calculated statistic - note we don't need the data any longer so we move it into the temporary test object
-	std::cout << "t = " << std::setprecision(6) << ConcreteTTest(std::move(data), type).t() << "\n";
-	return ExitOk;
+	if (stream) {
+		switch (storage) {
+			case StorageType::Float:
+				return runStream<FloatStorageTTest>(*dataFilePath, type, loadOptions, pValues);
+
+			case StorageType::Double:
+				return runStream<DoubleStorageTTest>(*dataFilePath, type, loadOptions, pValues);
+
+			default:
+				return runStream<ConcreteTTest>(*dataFilePath, type, loadOptions, pValues);
+		}
+	}
+
+	switch (storage) {
+		case StorageType::Float:
+			return batch
+				? runBatch<FloatStorageTTest>(*dataFilePath, type, loadOptions, control, pValues)
+				: runTest<FloatStorageTTest>(*dataFilePath, type, loadOptions, echo, pValues, permutation, bootstrap);
+
+		case StorageType::Double:
+			return batch
+				? runBatch<DoubleStorageTTest>(*dataFilePath, type, loadOptions, control, pValues)
+				: runTest<DoubleStorageTTest>(*dataFilePath, type, loadOptions, echo, pValues, permutation, bootstrap);
+
+		default:
+			return batch
+				? runBatch<ConcreteTTest>(*dataFilePath, type, loadOptions, control, pValues)
+				: runTest<ConcreteTTest>(*dataFilePath, type, loadOptions, echo, pValues, permutation, bootstrap);
+	}
 }
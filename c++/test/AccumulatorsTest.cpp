@@ -0,0 +1,123 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Accumulators.h"
+#include "TTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::loadData;
+
+namespace
+{
+    /**
+     * A test storing doubles that sums pairwise, so uses the vectorised kernels.
+     */
+    using PairwiseTTest = TTest<double, PairwiseSum<double>>;
+
+    /**
+     * Generate rows of two columns of test values, with roughly one cell in ten missing.
+     *
+     * The row count is deliberately not a multiple of the pairwise block size so that a partial block is exercised.
+     */
+    std::vector<std::vector<double>> testRows(std::size_t count, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> first(1000.0, 10.0);
+        std::normal_distribution<double> second(1001.0, 12.0);
+        std::uniform_int_distribution<int> missing(0, 9);
+        std::vector<std::vector<double>> rows;
+
+        for (std::size_t row = 0; row < count; ++row) {
+            const auto x = first(rng);
+            const auto y = second(rng);
+            rows.push_back({0 == missing(rng) ? NAN : x, 0 == missing(rng) ? NAN : y});
+        }
+
+        return rows;
+    }
+}
+
+TEST(AccumulatorsTest, testPairwiseIsAccurate)
+{
+    // 0.1 isn't exact in binary, so a naive float sum of a million of them is out by about 1%
+    constexpr std::size_t count = 1'000'000;
+    NaiveSum<float> naive;
+    PairwiseSum<float> pairwise;
+    long double exact = 0;
+
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        naive.add(0.1F);
+        pairwise.add(0.1F);
+        exact += 0.1F;
+    }
+
+    EXPECT_GT(std::abs(naive.value() - exact) / exact, 1e-3L);
+    EXPECT_LT(std::abs(pairwise.value() - exact) / exact, 1e-5L);
+
+    PairwiseSum<double> empty;
+    EXPECT_EQ(0.0, empty.value());
+}
+
+TEST(AccumulatorsTest, testAddPartialMatchesAdd)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<double> values(PairwiseSum<double>::PartialSize * 13);
+
+    for (auto & value : values) {
+        value = distribution(rng);
+    }
+
+    PairwiseSum<double> byValue;
+    PairwiseSum<double> byPartial;
+
+    for (const auto value : values) {
+        byValue.add(value);
+    }
+
+    // whole blocks summed elsewhere take the same place in the tree as the blocks add() fills
+    forEachPartial<PairwiseSum<double>>(values.size(), [&byPartial, &values](std::size_t offset, std::size_t size) {
+        double block = 0;
+
+        for (std::size_t idx = offset; idx < offset + size; ++idx) {
+            block += values[idx];
+        }
+
+        byPartial.addPartial(block);
+    });
+
+    EXPECT_EQ(byValue.value(), byPartial.value());
+
+    // a naive sum takes a single partial, however long the range
+    std::size_t parts = 0;
+    forEachPartial<NaiveSum<double>>(values.size(), [&parts](std::size_t, std::size_t size) {
+        ++parts;
+        EXPECT_EQ(PairwiseSum<double>::PartialSize * 13, size);
+    });
+
+    EXPECT_EQ(1U, parts);
+}
+
+TEST(AccumulatorsTest, testPairwiseTTestMatchesLongDouble)
+{
+    const auto rows = testRows(PairwiseSum<double>::PartialSize * 5 + 321, 3);
+    const auto data = loadData<PairwiseTTest::DataFileType>(rows);
+    const auto expectedData = loadData<TTest<long double>::DataFileType>(rows);
+
+    for (const auto col : {0, 1}) {
+        for (const auto pow : {1.0, 2.0}) {
+            const auto expected = static_cast<double>(expectedData.columnSum(col, pow));
+            EXPECT_NEAR(expected, data.columnSum(col, pow), 1e-12 * expected);
+        }
+    }
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        const auto expected = TTest<long double>(expectedData, type).result();
+        const auto actual = PairwiseTTest(data, type).result();
+        EXPECT_NEAR(static_cast<double>(expected.t), actual.t, 1e-9);
+        EXPECT_NEAR(static_cast<double>(expected.degreesOfFreedom), actual.degreesOfFreedom, 1e-6);
+    }
+}
@@ -0,0 +1,166 @@
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "BatchTTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::writeTemporaryFile;
+
+namespace
+{
+    /**
+     * Convenience alias for the concrete type of the batch being tested.
+     */
+    using TestBatch = BatchTTest<double>;
+
+    /**
+     * Convenience alias for the single-pair test the batch is checked against.
+     */
+    using TestTTest = TestBatch::TestType;
+
+    /**
+     * The number of rows and columns in the generated data.
+     */
+    constexpr const int RowCount = 200;
+    constexpr const int ColumnCount = 5;
+
+    /**
+     * Generate a table of values, with each column offset slightly from the one before.
+     */
+    std::vector<std::vector<double>> generateData()
+    {
+        std::mt19937 rng(42);
+        std::normal_distribution<double> distribution(50.0, 5.0);
+        std::vector<std::vector<double>> rows(RowCount, std::vector<double>(ColumnCount));
+
+        for (auto & row : rows) {
+            for (int col = 0; col < ColumnCount; ++col) {
+                row[col] = distribution(rng) + col * 0.5;
+            }
+        }
+
+        return rows;
+    }
+
+    /**
+     * Render some of the columns of a table of values as CSV.
+     */
+    std::string toCsv(const std::vector<std::vector<double>> & rows, const std::vector<int> & columns)
+    {
+        std::ostringstream csv;
+        csv.precision(17);
+
+        for (std::size_t row = 0; row < rows.size(); ++row) {
+            if (0 < row) {
+                csv << "\n";
+            }
+
+            for (std::size_t idx = 0; idx < columns.size(); ++idx) {
+                csv << (0 < idx ? "," : "") << rows[row][columns[idx]];
+            }
+        }
+
+        return csv.str();
+    }
+
+    /**
+     * Fixture providing the generated data as a loaded DataFile.
+     */
+    class BatchTTestTest : public ::testing::Test
+    {
+        protected:
+            void SetUp() override
+            {
+                m_rows = generateData();
+                m_path = writeTemporaryFile(toCsv(m_rows, {0, 1, 2, 3, 4}));
+            }
+
+            void TearDown() override
+            {
+                std::filesystem::remove(m_path);
+            }
+
+            /**
+             * Calculate t for a pair of columns with a standalone TTest on a two-column file.
+             */
+            double singleT(int first, int second, TTestType type) const
+            {
+                const auto path = writeTemporaryFile(toCsv(m_rows, {first, second}));
+                const auto t = TestTTest(TestTTest::DataFileType(path), type).t();
+                std::filesystem::remove(path);
+                return t;
+            }
+
+            std::vector<std::vector<double>> m_rows;
+            std::string m_path;
+    };
+}
+
+TEST(BatchTTestPairsTest, allPairs)
+{
+    const auto pairs = TestBatch::allPairs(4);
+    ASSERT_EQ(6, pairs.size());
+    const std::vector<std::pair<long, long>> expected = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+
+    for (std::size_t idx = 0; idx < pairs.size(); ++idx) {
+        EXPECT_EQ(expected[idx].first, pairs[idx].first);
+        EXPECT_EQ(expected[idx].second, pairs[idx].second);
+    }
+
+    EXPECT_TRUE(TestBatch::allPairs(1).empty());
+}
+
+TEST(BatchTTestPairsTest, allVersusControl)
+{
+    const auto pairs = TestBatch::allVersusControl(4, 2);
+    ASSERT_EQ(3, pairs.size());
+    const std::vector<long> expected = {0, 1, 3};
+
+    for (std::size_t idx = 0; idx < pairs.size(); ++idx) {
+        EXPECT_EQ(2, pairs[idx].first);
+        EXPECT_EQ(expected[idx], pairs[idx].second);
+    }
+}
+
+TEST_F(BatchTTestTest, matchesSingleTests)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired}) {
+        const TestBatch batch(TestBatch::DataFileType(m_path), type);
+        const auto results = batch.run(TestBatch::allPairs(ColumnCount));
+        ASSERT_EQ(ColumnCount * (ColumnCount - 1) / 2, results.size());
+
+        for (const auto & result : results) {
+            EXPECT_DOUBLE_EQ(singleT(static_cast<int>(result.first), static_cast<int>(result.second), type), result.t);
+        }
+    }
+}
+
+TEST_F(BatchTTestTest, threadCountDoesNotAffectResults)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired}) {
+        const TestBatch batch(TestBatch::DataFileType(m_path), type);
+        const auto pairs = TestBatch::allPairs(ColumnCount);
+        const auto expected = batch.run(pairs, 1);
+        const auto actual = batch.run(pairs, 4);
+        ASSERT_EQ(expected.size(), actual.size());
+
+        for (std::size_t idx = 0; idx < expected.size(); ++idx) {
+            EXPECT_EQ(expected[idx].first, actual[idx].first);
+            EXPECT_EQ(expected[idx].second, actual[idx].second);
+            EXPECT_EQ(expected[idx].t, actual[idx].t);
+        }
+    }
+}
+
+TEST_F(BatchTTestTest, invalidColumnThrows)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired}) {
+        const TestBatch batch(TestBatch::DataFileType(m_path), type);
+        EXPECT_THROW(static_cast<void>(batch.run({{0, ColumnCount}}, 2)), std::invalid_argument);
+    }
+}
@@ -0,0 +1,183 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Bootstrap.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::loadData;
+
+namespace
+{
+    /**
+     * Convenience alias for the concrete type of the bootstrap being tested.
+     */
+    using TestBootstrap = MeanDifferenceBootstrap<double>;
+
+    /**
+     * Generate two columns of pseudo-random data.
+     *
+     * The first column is uniform on [0, 10), the second is exponential with mean 2, so it is skewed to the right.
+     *
+     * @param rows The number of rows.
+     * @param shift An amount to add to each value in the first column.
+     */
+    std::vector<std::vector<double>> generateData(std::size_t rows, double shift = 0)
+    {
+        Xoshiro256StarStar rng(12345);
+        std::vector<std::vector<double>> data;
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            const auto uniform = static_cast<double>(rng() >> 11) / 9007199254740992.0;
+            const auto exponential = -2 * std::log1p(-static_cast<double>(rng() >> 11) / 9007199254740992.0);
+            data.push_back({uniform * 10 + shift, exponential});
+        }
+
+        return data;
+    }
+
+    /**
+     * The variance of a column of generated data, with divisor n.
+     */
+    double populationVariance(const std::vector<std::vector<double>> & data, std::size_t col)
+    {
+        double mean = 0;
+
+        for (const auto & row : data) {
+            mean += row[col];
+        }
+
+        mean /= static_cast<double>(data.size());
+        double sumSquaredDeviations = 0;
+
+        for (const auto & row : data) {
+            sumSquaredDeviations += (row[col] - mean) * (row[col] - mean);
+        }
+
+        return sumSquaredDeviations / static_cast<double>(data.size());
+    }
+}
+
+TEST(BootstrapTest, testMeanDifference)
+{
+    const auto data = generateData(100);
+    double expected = 0;
+
+    for (const auto & row : data) {
+        expected += row[0] - row[1];
+    }
+
+    expected /= 100;
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        const auto result = TestBootstrap(loadData(data), type).run();
+        EXPECT_NEAR(expected, result.meanDifference, 1e-12);
+        EXPECT_EQ(10000U, result.replicates);
+        EXPECT_LT(result.percentile.lower, result.meanDifference);
+        EXPECT_GT(result.percentile.upper, result.meanDifference);
+        EXPECT_LT(result.bca.lower, result.meanDifference);
+        EXPECT_GT(result.bca.upper, result.meanDifference);
+    }
+}
+
+TEST(BootstrapTest, testUnpairedStandardError)
+{
+    // the bootstrap standard error of a difference of independent means is √(σ₁²/n₁ + σ₂²/n₂), using the sample's population variances
+    const auto data = generateData(400);
+    const auto expected = std::sqrt((populationVariance(data, 0) + populationVariance(data, 1)) / 400);
+    BootstrapOptions options;
+    options.replicates = 20000;
+    const auto result = TestBootstrap(loadData(data), TTestType::Unpaired).run(options);
+
+    EXPECT_NEAR(expected, result.standardError, expected * 0.03);
+    EXPECT_NEAR(0.0, result.bias, expected * 0.05);
+
+    // with 400 values per column the distribution is close to normal, so the percentile interval is close to the normal interval
+    EXPECT_NEAR(result.meanDifference - 1.959964 * expected, result.percentile.lower, expected * 0.1);
+    EXPECT_NEAR(result.meanDifference + 1.959964 * expected, result.percentile.upper, expected * 0.1);
+}
+
+TEST(BootstrapTest, testPairedStandardError)
+{
+    std::vector<std::vector<double>> differences;
+
+    for (const auto & row : generateData(400)) {
+        differences.push_back({row[0] - row[1], 0.0});
+    }
+
+    const auto expected = std::sqrt(populationVariance(differences, 0) / 400);
+    BootstrapOptions options;
+    options.replicates = 20000;
+    const auto result = TestBootstrap(loadData(generateData(400)), TTestType::Paired).run(options);
+
+    EXPECT_NEAR(expected, result.standardError, expected * 0.03);
+
+    // resampling pairs is the same as resampling their differences
+    const auto differenceResult = TestBootstrap(loadData(differences), TTestType::Paired).run(options);
+    EXPECT_NEAR(differenceResult.percentile.lower, result.percentile.lower, 1e-9);
+    EXPECT_NEAR(differenceResult.percentile.upper, result.percentile.upper, 1e-9);
+    EXPECT_NEAR(differenceResult.bca.lower, result.bca.lower, 1e-9);
+    EXPECT_NEAR(differenceResult.bca.upper, result.bca.upper, 1e-9);
+}
+
+TEST(BootstrapTest, testShiftInvariance)
+{
+    BootstrapOptions options;
+    options.replicates = 2000;
+    const auto result = TestBootstrap(loadData(generateData(50)), TTestType::Welch).run(options);
+    const auto shifted = TestBootstrap(loadData(generateData(50, 3.0)), TTestType::Welch).run(options);
+
+    EXPECT_NEAR(result.meanDifference + 3.0, shifted.meanDifference, 1e-9);
+    EXPECT_NEAR(result.standardError, shifted.standardError, 1e-9);
+    EXPECT_NEAR(result.percentile.lower + 3.0, shifted.percentile.lower, 1e-9);
+    EXPECT_NEAR(result.percentile.upper + 3.0, shifted.percentile.upper, 1e-9);
+    EXPECT_NEAR(result.bca.lower + 3.0, shifted.bca.lower, 1e-9);
+    EXPECT_NEAR(result.bca.upper + 3.0, shifted.bca.upper, 1e-9);
+}
+
+TEST(BootstrapTest, testBcaCorrectsForSkew)
+{
+    // the second column is skewed to the right, so the difference is skewed to the left and BCa moves both ends of the interval down
+    BootstrapOptions options;
+    options.replicates = 20000;
+    const auto result = TestBootstrap(loadData(generateData(30)), TTestType::Unpaired).run(options);
+
+    EXPECT_LT(result.bca.lower, result.percentile.lower);
+    EXPECT_LT(result.bca.upper, result.percentile.upper);
+}
+
+TEST(BootstrapTest, testIndependentOfThreadCount)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired}) {
+        const TestBootstrap bootstrap(loadData(generateData(77)), type);
+        BootstrapOptions options;
+        options.replicates = 1001;
+        options.seed = 99;
+        options.threads = 1;
+        const auto expected = bootstrap.run(options);
+        options.threads = 4;
+        const auto actual = bootstrap.run(options);
+
+        EXPECT_EQ(expected.standardError, actual.standardError);
+        EXPECT_EQ(expected.percentile.lower, actual.percentile.lower);
+        EXPECT_EQ(expected.percentile.upper, actual.percentile.upper);
+        EXPECT_EQ(expected.bca.lower, actual.bca.lower);
+        EXPECT_EQ(expected.bca.upper, actual.bca.upper);
+
+        options.seed = 100;
+        EXPECT_NE(expected.standardError, bootstrap.run(options).standardError);
+    }
+}
+
+TEST(BootstrapTest, testTooFewValues)
+{
+    const auto result = TestBootstrap(loadData({{1.0, 2.0}, {3.0, NAN}}), TTestType::Unpaired).run();
+    EXPECT_TRUE(std::isnan(result.standardError));
+    EXPECT_TRUE(std::isnan(result.percentile.lower));
+    EXPECT_TRUE(std::isnan(result.bca.upper));
+
+    BootstrapOptions options;
+    options.confidence = 1.0;
+    EXPECT_TRUE(std::isnan(TestBootstrap(loadData(generateData(10)), TTestType::Unpaired).run(options).percentile.lower));
+}
@@ -0,0 +1,220 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+
+#include "TTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::temporaryPath;
+using TestFiles::writeTemporaryFile;
+
+namespace
+{
+    /**
+     * The result of running the t-test binary.
+     */
+    struct Output
+    {
+        int exitCode;
+        std::vector<std::string> lines;
+    };
+
+    /**
+     * Write a list of paths, one per line, to a new temporary file.
+     *
+     * @return The path to the list.
+     */
+    std::string writePathList(const std::vector<std::string> & paths)
+    {
+        std::ostringstream list;
+
+        for (const auto & path : paths) {
+            list << path << '\n';
+        }
+
+        auto path = temporaryPath(".txt");
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << list.str();
+        return path;
+    }
+
+    /**
+     * Generate the CSV content for a data file with two columns whose second column is offset from the first.
+     *
+     * Different offsets give different values for t, so the lines for different files can be told apart.
+     */
+    std::string twoColumnCsv(int rowCount, double offset)
+    {
+        std::ostringstream csv;
+
+        for (int row = 0; row < rowCount; ++row) {
+            csv << (row % 7) << ',' << ((row * 3) % 11) + offset << '\n';
+        }
+
+        return csv.str();
+    }
+
+    /**
+     * Fetch the line that the t-test binary outputs for a data file that can be tested.
+     */
+    std::string expectedLine(const std::string & path)
+    {
+        std::ostringstream line;
+        line << path << '\t' << std::fixed << std::setprecision(6) << TTest<long double>(DataFile<long double>(path), TTestType::Unpaired).t();
+        return line.str();
+    }
+
+    /**
+     * Run the t-test binary through the shell and capture its standard output.
+     *
+     * The binary is run with --no-cache so that it doesn't leave caches beside the temporary files.
+     *
+     * @param args The args for the binary, as they would be typed at the shell.
+     */
+    Output run(const std::string & args)
+    {
+        const auto command = std::string("\"") + T_TEST_BINARY + "\" --no-cache " + args + " 2>/dev/null";
+        auto * pipe = ::popen(command.c_str(), "r");
+        Output output{-1, {}};
+
+        if (!pipe) {
+            return output;
+        }
+
+        std::string content;
+        char buffer[4096];
+
+        for (auto size = std::fread(buffer, 1, sizeof(buffer), pipe); 0 < size; size = std::fread(buffer, 1, sizeof(buffer), pipe)) {
+            content.append(buffer, size);
+        }
+
+        const auto status = ::pclose(pipe);
+        output.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        std::istringstream in(content);
+
+        for (std::string line; std::getline(in, line);) {
+            output.lines.push_back(line);
+        }
+
+        return output;
+    }
+
+    /**
+     * Quote a path for the shell.
+     */
+    std::string quoted(const std::string & path)
+    {
+        return "'" + path + "'";
+    }
+}
+
+TEST(CommandLineTest, testFilesKeepsOrderWithThreads)
+{
+    std::vector<std::string> paths;
+
+    // the larger files come first so that, with several threads, later files tend to finish before earlier ones
+    for (int idx = 0; idx < 12; ++idx) {
+        paths.push_back(writeTemporaryFile(twoColumnCsv(20000 - idx * 1500, idx * 0.25)));
+    }
+
+    const auto list = writePathList(paths);
+    const auto output = run("-j 4 --files " + quoted(list));
+
+    EXPECT_EQ(0, output.exitCode);
+    ASSERT_EQ(paths.size(), output.lines.size());
+
+    for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+        EXPECT_EQ(expectedLine(paths[idx]), output.lines[idx]);
+        std::filesystem::remove(paths[idx]);
+    }
+
+    std::filesystem::remove(list);
+}
+
+TEST(CommandLineTest, testFilesReportsBadFileWithoutAborting)
+{
+    const auto first = writeTemporaryFile(twoColumnCsv(50, 1.0));
+    const auto missing = temporaryPath();
+    const auto oneColumn = writeTemporaryFile("1\n2\n3\n");
+    const auto last = writeTemporaryFile(twoColumnCsv(60, 2.0));
+    const auto list = writePathList({first, missing, oneColumn, last});
+    const auto output = run("-j 2 --files " + quoted(list));
+
+    // any failure gives a non-zero exit status, but every file still gets its line
+    EXPECT_NE(0, output.exitCode);
+    ASSERT_EQ(4U, output.lines.size());
+    EXPECT_EQ(expectedLine(first), output.lines[0]);
+    EXPECT_EQ(0U, output.lines[1].find(missing + "\tERR "));
+    EXPECT_EQ(oneColumn + "\tERR data file has fewer than two columns", output.lines[2]);
+    EXPECT_EQ(expectedLine(last), output.lines[3]);
+
+    for (const auto & path : {first, oneColumn, last, list}) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(CommandLineTest, testFilesReadsListFromStdin)
+{
+    const auto first = writeTemporaryFile(twoColumnCsv(40, 0.5));
+    const auto second = writeTemporaryFile(twoColumnCsv(30, 1.5));
+    const auto list = writePathList({first, second});
+    const auto output = run("--files - < " + quoted(list));
+
+    EXPECT_EQ(0, output.exitCode);
+    ASSERT_EQ(2U, output.lines.size());
+    EXPECT_EQ(expectedLine(first), output.lines[0]);
+    EXPECT_EQ(expectedLine(second), output.lines[1]);
+
+    for (const auto & path : {first, second, list}) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(CommandLineTest, testGlobTestsMatchingFilesInOrder)
+{
+    const auto dir = std::filesystem::path(temporaryPath(""));
+    std::filesystem::create_directory(dir);
+    std::vector<std::string> paths;
+
+    for (const auto * name : {"a.csv", "b.csv", "c.csv"}) {
+        paths.push_back((dir / name).string());
+        std::ofstream(paths.back(), std::ios::binary | std::ios::trunc) << twoColumnCsv(25, static_cast<double>(paths.size()));
+    }
+
+    // doesn't match the pattern, so isn't tested
+    std::ofstream(dir / "d.txt", std::ios::binary | std::ios::trunc) << twoColumnCsv(25, 0.0);
+
+    const auto output = run("-j 3 --glob " + quoted((dir / "*.csv").string()));
+
+    EXPECT_EQ(0, output.exitCode);
+    ASSERT_EQ(paths.size(), output.lines.size());
+
+    for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+        EXPECT_EQ(expectedLine(paths[idx]), output.lines[idx]);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(CommandLineTest, testStreamHonoursStorage)
+{
+    const auto path = writeTemporaryFile(twoColumnCsv(500, 0.75));
+
+    for (const auto * storage : {"float", "double", "long-double"}) {
+        const auto output = run(std::string("--stream -p -t welch --storage ") + storage + " " + quoted(path));
+        const auto loaded = run(std::string("--quiet -p -t welch --storage ") + storage + " " + quoted(path));
+
+        // nothing is stored, but the calculation is done at the precision the storage type accumulates in
+        EXPECT_EQ(0, output.exitCode) << storage;
+        ASSERT_EQ(4U, output.lines.size()) << storage;
+        EXPECT_EQ(loaded.lines, output.lines) << storage;
+    }
+
+    std::filesystem::remove(path);
+}
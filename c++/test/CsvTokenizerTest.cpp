@@ -0,0 +1,197 @@
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "CsvTokenizer.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * The instruction sets to check against the scalar reference scanner.
+     */
+    constexpr const Kernels::InstructionSet VectorInstructionSets[] = {
+        Kernels::InstructionSet::Avx2,
+        Kernels::InstructionSet::Avx512,
+    };
+
+    /**
+     * The dialects to check: the default, tab-separated without quoting, and semicolon-separated with single quotes.
+     */
+    const Csv::Dialect TestDialects[] = {
+        {',', '"'},
+        {'\t', '\0'},
+        {';', '\''},
+    };
+
+    /**
+     * A structural character: its position and whether it is a line end.
+     */
+    using Structural = std::pair<std::size_t, bool>;
+
+    /**
+     * Scan some content and collect the structural characters.
+     */
+    std::vector<Structural> structurals(std::string_view content, const Csv::Dialect & dialect, Kernels::InstructionSet set)
+    {
+        std::vector<Structural> found;
+
+        Csv::scan(content, dialect, [&found](std::size_t pos, bool isLineEnd) {
+            found.emplace_back(pos, isLineEnd);
+        }, set);
+
+        return found;
+    }
+
+    /**
+     * Scan some content, skipping the rest of each record after its first few fields, and collect the structural characters.
+     */
+    std::vector<Structural> leadingStructurals(std::string_view content, const Csv::Dialect & dialect, std::size_t fieldCount, Kernels::InstructionSet set)
+    {
+        std::vector<Structural> found;
+        std::size_t field = 0;
+
+        Csv::scan(content, dialect, [&found, &field, fieldCount](std::size_t pos, bool isLineEnd) -> bool {
+            found.emplace_back(pos, isLineEnd);
+            field = (isLineEnd ? 0 : field + 1);
+            return fieldCount <= field;
+        }, set);
+
+        return found;
+    }
+
+    /**
+     * Generate random CSV-like content, dense with structural characters and quotes of every dialect.
+     */
+    std::string randomContent(std::size_t size, unsigned int seed)
+    {
+        static constexpr std::string_view Alphabet = ",,;;\t\t\n\n\"\"''1234.5- ";
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<std::size_t> character(0, Alphabet.size() - 1);
+        std::string content(size, '\0');
+
+        for (auto & ch : content) {
+            ch = Alphabet[character(rng)];
+        }
+
+        return content;
+    }
+
+    /**
+     * Split a record into its fields.
+     */
+    std::vector<std::string> fields(std::string_view record, const Csv::Dialect & dialect = {})
+    {
+        std::vector<std::string> found;
+
+        Csv::forEachField(record, dialect, [&found](std::string_view field) {
+            found.emplace_back(field);
+        });
+
+        return found;
+    }
+}
+
+TEST(CsvTokenizerTest, testScanFindsStructuralCharacters)
+{
+    // the delimiter and line end inside the quotes are part of the field
+    const std::string_view content = "1,\"2,\n3\",4\n\"\"\"5\",6";
+    const std::vector<Structural> expected = {{1, false}, {8, false}, {10, true}, {16, false}};
+
+    EXPECT_EQ(expected, structurals(content, {}, Kernels::InstructionSet::Scalar));
+
+    // with quoting off every delimiter and line end is structural
+    EXPECT_EQ(6, structurals(content, {',', '\0'}, Kernels::InstructionSet::Scalar).size());
+
+    // skipping the rest of each record after its first field leaves only the line ends
+    const std::vector<Structural> leading = {{1, false}, {10, true}, {16, false}};
+    EXPECT_EQ(leading, leadingStructurals(content, {}, 1, Kernels::InstructionSet::Scalar));
+
+    for (const auto set : VectorInstructionSets) {
+        if (Csv::isSupported(set)) {
+            EXPECT_EQ(expected, structurals(content, {}, set));
+        }
+    }
+}
+
+TEST(CsvTokenizerTest, testVectorScannersMatchScalar)
+{
+    // lengths either side of the block size, so that the scalar tail and quotes spanning blocks are exercised
+    for (const std::size_t size : {0, 1, 31, 32, 63, 64, 65, 127, 128, 129, 1000, 4099}) {
+        for (unsigned int seed = 0; seed < 8; ++seed) {
+            const auto content = randomContent(size, seed);
+
+            for (const auto & dialect : TestDialects) {
+                const auto expected = structurals(content, dialect, Kernels::InstructionSet::Scalar);
+                const auto expectedLeading = leadingStructurals(content, dialect, 1 + seed % 3, Kernels::InstructionSet::Scalar);
+
+                for (const auto set : VectorInstructionSets) {
+                    if (Csv::isSupported(set)) {
+                        ASSERT_EQ(expected, structurals(content, dialect, set)) << "size " << size << ", seed " << seed << ", delimiter " << static_cast<int>(dialect.delimiter);
+                        ASSERT_EQ(expectedLeading, leadingStructurals(content, dialect, 1 + seed % 3, set)) << "size " << size << ", seed " << seed << ", delimiter " << static_cast<int>(dialect.delimiter);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(CsvTokenizerTest, testForEachField)
+{
+    EXPECT_EQ((std::vector<std::string>{""}), fields(""));
+    EXPECT_EQ((std::vector<std::string>{"1", "", "3"}), fields("1,,3"));
+    EXPECT_EQ((std::vector<std::string>{"\"a,b\"", " 2"}), fields("\"a,b\", 2"));
+    EXPECT_EQ((std::vector<std::string>{"1,5", "2"}), fields("1,5;2", {';', '"'}));
+    EXPECT_EQ((std::vector<std::string>{"\"x", "y\""}), fields("\"x\ty\"", {'\t', '\0'}));
+}
+
+TEST(CsvTokenizerTest, testUnquote)
+{
+    const Csv::Dialect dialect;
+
+    EXPECT_EQ("1.5", Csv::unquote("1.5", dialect));
+    EXPECT_EQ("1.5", Csv::unquote("\"1.5\"", dialect));
+    EXPECT_EQ(" 1.5", Csv::unquote("  \" 1.5\"\r", dialect));
+    EXPECT_EQ("", Csv::unquote("\"\"", dialect));
+    EXPECT_EQ("\"", Csv::unquote("\"", dialect));
+    EXPECT_EQ("\"1.5", Csv::unquote("\"1.5", dialect));
+    EXPECT_EQ(" 1.5 ", Csv::unquote(" 1.5 ", dialect));
+    EXPECT_EQ("\"1.5\"", Csv::unquote("\"1.5\"", {',', '\0'}));
+}
+
+TEST(CsvTokenizerTest, testFindLineEnd)
+{
+    const Csv::Dialect dialect;
+    const std::string_view content = "\"a\nb\",1\n2\n";
+
+    EXPECT_FALSE(Csv::endsInsideQuotes(content, dialect));
+    EXPECT_TRUE(Csv::endsInsideQuotes(content.substr(0, 3), dialect));
+    EXPECT_EQ(7, Csv::findLineEnd(content, dialect));
+    EXPECT_EQ(2, Csv::findLineEnd(content, {',', '\0'}));
+
+    // starting inside the quoted field
+    EXPECT_EQ(7, Csv::findLineEnd(content, dialect, 1, true));
+    EXPECT_EQ(std::string_view::npos, Csv::findLineEnd("\"\n\n", dialect));
+}
+
+TEST(CsvTokenizerTest, testReadRecord)
+{
+    std::istringstream in("1,\"a\nb\"\n2,3\n\"open\nto the end");
+    std::string record;
+
+    EXPECT_EQ(8, Csv::readRecord(in, {}, record));
+    EXPECT_EQ("1,\"a\nb\"", record);
+    EXPECT_EQ(4, Csv::readRecord(in, {}, record));
+    EXPECT_EQ("2,3", record);
+
+    // a quoted field that is never closed runs to the end of the stream
+    EXPECT_EQ(16, Csv::readRecord(in, {}, record));
+    EXPECT_EQ("\"open\nto the end", record);
+    EXPECT_TRUE(in.eof());
+}
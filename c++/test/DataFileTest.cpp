@@ -0,0 +1,1210 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "DataFile.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::toCsv;
+using TestFiles::writeTemporaryFile;
+
+namespace
+{
+    /**
+     * The value type to use when testing the DataFile class.
+     */
+    using ValueType = long double;
+
+    /**
+     * Convenience alias for the concrete type of the DataFile being tested.
+     */
+    using TestDataFile = DataFile<ValueType>;
+
+    /**
+     * Amount by which floating-point tests for equality are allowed to vary.
+     *
+     * Testing floats for equality is prone to false failures because float representation is inherently imprecise. This is the maximum amount an actual
+     * float value is permitted to vary from its expected value in order to pass testing.
+     */
+    constexpr const ValueType FloatEqualityDelta = 0.000001L;
+
+    /**
+     * The test data.
+     *
+     * This is the data that appears in the DataFile used for testing.
+     */
+    const std::vector<std::vector<ValueType>> TestData = {
+        {12.0L, 14.0L,},
+        {12.0L, 14.0L,},
+        {12.0L, 14.0L,},
+        {15.0L, 14.0L,},
+        {13.0L, 16.0L,},
+        {12.0L, 15.0L,},
+        {13.0L, 18.0L,},
+        {14.0L, 17.0L,},
+        {15.0L, 14.0L,},
+        {15.0L, 13.0L,},
+        {14.0L, 15.0L,},
+        {13.0L, 14.0L,},
+    };
+
+    // meta-information about the test data
+    //
+    // this is used to guide the tests and to provided expected data for calculations (sums, counts, means, etc.)
+    // if the data in the above array changes, this meta-information must be checked and updated otherwise the test is
+    // not valid
+    constexpr const TestDataFile::IndexType TestDataRowCount = 12;
+    constexpr const TestDataFile::IndexType TestDataColumnCount = 2;
+
+    // items (total, by-row and by-column)
+    constexpr const TestDataFile::IndexType TestDataItemCount = 24;
+    constexpr const TestDataFile::IndexType TestDataColumnItemCount[] = {12, 12,};
+
+    // sums (total, by-row and by-column)
+    constexpr const ValueType TestDataSum = 338;
+    constexpr const ValueType TestDataRowSum[] = {26, 26, 26, 29, 29, 27, 31, 31, 29, 28, 29, 27,};
+    constexpr const ValueType TestDataColumnSum[] = {160, 178,};
+    constexpr const ValueType TestDataColumnSumSquares[] = {2150, 2664,};
+
+    // extremes by column
+    constexpr const ValueType TestDataColumnMin[] = {12, 13,};
+    constexpr const ValueType TestDataColumnMax[] = {15, 18,};
+
+    // means (total, by-row and by-column)
+    constexpr const ValueType TestDataArithmeticMean = 14.0833333L;
+    constexpr const ValueType TestDataRowArithmeticMean[] = {13, 13, 13, 14.5, 14.5, 13.5, 15.5, 15.5, 14.5, 14, 14.5, 13.5,};
+    constexpr const ValueType TestDataColumnArithmeticMean[] = {13.33333333L, 14.83333333L,};
+
+    /**
+     * Test fixture providing a DataFile loaded from the test data.
+     */
+    class DataFileTest : public ::testing::Test
+    {
+        protected:
+            void SetUp() override
+            {
+                m_path = writeTemporaryFile(toCsv(TestData));
+            }
+
+            void TearDown() override
+            {
+                std::filesystem::remove(m_path);
+            }
+
+            [[nodiscard]] TestDataFile dataFile() const
+            {
+                return TestDataFile(m_path);
+            }
+
+            std::string m_path;
+    };
+}
+
+TEST_F(DataFileTest, testRowCount)
+{
+    EXPECT_EQ(TestDataRowCount, dataFile().rowCount());
+}
+
+TEST_F(DataFileTest, testColumnCount)
+{
+    EXPECT_EQ(TestDataColumnCount, dataFile().columnCount());
+}
+
+TEST_F(DataFileTest, testIsEmpty)
+{
+    EXPECT_FALSE(dataFile().isEmpty());
+}
+
+TEST_F(DataFileTest, testItemCount)
+{
+    EXPECT_EQ(TestDataItemCount, dataFile().itemCount());
+}
+
+TEST_F(DataFileTest, testRowItemCount)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType row = 0; row < TestDataRowCount; ++row) {
+        EXPECT_EQ(TestDataColumnCount, data.rowItemCount(row)) << "Item count for row " << row << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnItemCount)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        EXPECT_EQ(TestDataColumnItemCount[col], data.columnItemCount(col)) << "Item count for column " << col << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testSum)
+{
+    EXPECT_NEAR(TestDataSum, dataFile().sum(), FloatEqualityDelta);
+}
+
+TEST_F(DataFileTest, testRowSum)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType row = 0; row < TestDataRowCount; ++row) {
+        EXPECT_NEAR(TestDataRowSum[row], data.rowSum(row), FloatEqualityDelta) << "Sum for row " << row << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnSum)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        EXPECT_NEAR(TestDataColumnSum[col], data.columnSum(col), FloatEqualityDelta) << "Sum for column " << col << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnSumSquares)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        EXPECT_NEAR(TestDataColumnSumSquares[col], data.columnSum(col, 2.0), FloatEqualityDelta) << "Sum of squares for column " << col << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnMinMax)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        EXPECT_EQ(TestDataColumnMin[col], data.columnMin(col)) << "Minimum for column " << col << " is not correct";
+        EXPECT_EQ(TestDataColumnMax[col], data.columnMax(col)) << "Maximum for column " << col << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnSummary)
+{
+    const auto & data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        // the first call calculates the summary, the second comes from the cache; a copy of the DataFile takes the cache with it
+        const auto first = data.columnSummary(col);
+        const auto second = data.columnSummary(col);
+        const auto copied = TestDataFile(data).columnSummary(col);
+
+        for (const auto & summary : {second, copied}) {
+            EXPECT_EQ(first.count, summary.count);
+            EXPECT_EQ(first.sum, summary.sum);
+            EXPECT_EQ(first.sumSquares, summary.sumSquares);
+            EXPECT_EQ(first.min, summary.min);
+            EXPECT_EQ(first.max, summary.max);
+        }
+
+        EXPECT_EQ(TestDataColumnItemCount[col], first.count);
+        EXPECT_NEAR(TestDataColumnSum[col], first.sum, FloatEqualityDelta);
+    }
+
+    EXPECT_THROW(static_cast<void>(data.columnSummary(TestDataColumnCount)), std::invalid_argument);
+}
+
+TEST_F(DataFileTest, testMean)
+{
+    EXPECT_NEAR(TestDataArithmeticMean, dataFile().mean(), FloatEqualityDelta);
+}
+
+TEST_F(DataFileTest, testRowMean)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType row = 0; row < TestDataRowCount; ++row) {
+        EXPECT_NEAR(TestDataRowArithmeticMean[row], data.rowMean(row), FloatEqualityDelta) << "Mean for row " << row << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testColumnMean)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+        EXPECT_NEAR(TestDataColumnArithmeticMean[col], data.columnMean(col), FloatEqualityDelta) << "Mean for column " << col << " is not correct";
+    }
+}
+
+TEST_F(DataFileTest, testItem)
+{
+    auto data = dataFile();
+
+    for (TestDataFile::IndexType row = 0; row < TestDataRowCount; ++row) {
+        for (TestDataFile::IndexType col = 0; col < TestDataColumnCount; ++col) {
+            EXPECT_NEAR(TestData[row][col], data.item(row, col), FloatEqualityDelta) << "Item at R" << row << ", C" << col << " is not correct";
+        }
+    }
+
+    EXPECT_THROW(data.item(TestDataRowCount, 0), std::invalid_argument);
+    EXPECT_THROW(data.item(0, TestDataColumnCount), std::invalid_argument);
+    EXPECT_THROW(data.item(-1, 0), std::invalid_argument);
+}
+
+TEST(DataFileRaggedTest, testRaggedRows)
+{
+    auto path = writeTemporaryFile("1,2\n3,4,5\n,6\n7");
+    auto data = TestDataFile(path);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(4, data.rowCount());
+    ASSERT_EQ(3, data.columnCount());
+
+    EXPECT_EQ(3, data.columnItemCount(0));
+    EXPECT_EQ(3, data.columnItemCount(1));
+    EXPECT_EQ(1, data.columnItemCount(2));
+    EXPECT_EQ(2, data.rowItemCount(0));
+    EXPECT_EQ(3, data.rowItemCount(1));
+    EXPECT_EQ(1, data.rowItemCount(2));
+    EXPECT_EQ(1, data.rowItemCount(3));
+
+    EXPECT_TRUE(std::isnan(data.item(0, 2)));
+    EXPECT_TRUE(std::isnan(data.item(2, 0)));
+    EXPECT_NEAR(5.0L, data.item(1, 2), FloatEqualityDelta);
+    EXPECT_NEAR(11.0L, data.columnSum(0), FloatEqualityDelta);
+    EXPECT_NEAR(12.0L, data.columnSum(1), FloatEqualityDelta);
+    EXPECT_NEAR(1.0L + 4.0L + 9.0L + 16.0L + 25.0L, data.rowSum(0, 2.0) + data.rowSum(1, 2.0), FloatEqualityDelta);
+
+    // missing cells don't affect the extremes
+    EXPECT_EQ(1.0L, data.columnMin(0));
+    EXPECT_EQ(7.0L, data.columnMax(0));
+    EXPECT_EQ(5.0L, data.columnMin(2));
+    EXPECT_EQ(5.0L, data.columnMax(2));
+}
+
+TEST(DataFileParallelLoadTest, testParallelLoadIsIdentical)
+{
+    // large enough to be split into several chunks, with ragged rows and unparseable cells scattered through it
+    std::string csv;
+
+    for (int row = 0; row < 60000; ++row) {
+        csv += std::to_string(row * 0.37) + "," + std::to_string(row % 7 == 0 ? 0.0 : 100.0 / row);
+
+        if (0 == row % 11) {
+            csv += ",extra";
+        } else if (0 == row % 13) {
+            csv += "," + std::to_string(row) + "," + std::to_string(-row);
+        }
+
+        csv += "\n";
+    }
+
+    auto path = writeTemporaryFile(csv);
+    auto single = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1});
+    auto parallel = TestDataFile(path, LoadOptions{LoadMode::Mapped, 4});
+    auto streamed = TestDataFile(path, LoadOptions{LoadMode::Stream, 4});
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(single.rowCount(), parallel.rowCount());
+    ASSERT_EQ(single.columnCount(), parallel.columnCount());
+    ASSERT_EQ(single.rowCount(), streamed.rowCount());
+    ASSERT_EQ(single.columnCount(), streamed.columnCount());
+
+    for (TestDataFile::IndexType row = 0; row < single.rowCount(); ++row) {
+        for (TestDataFile::IndexType col = 0; col < single.columnCount(); ++col) {
+            const auto & expected = single.item(row, col);
+
+            if (std::isnan(expected)) {
+                ASSERT_TRUE(std::isnan(parallel.item(row, col))) << "Item at R" << row << ", C" << col << " should be empty";
+                ASSERT_TRUE(std::isnan(streamed.item(row, col))) << "Item at R" << row << ", C" << col << " should be empty";
+            } else {
+                ASSERT_EQ(expected, parallel.item(row, col)) << "Item at R" << row << ", C" << col << " differs";
+                ASSERT_EQ(expected, streamed.item(row, col)) << "Item at R" << row << ", C" << col << " differs";
+            }
+        }
+    }
+
+    for (TestDataFile::IndexType col = 0; col < single.columnCount(); ++col) {
+        EXPECT_EQ(single.columnItemCount(col), parallel.columnItemCount(col));
+    }
+}
+
+namespace
+{
+    /**
+     * Assert that two DataFiles hold identical content.
+     */
+    void expectIdentical(const TestDataFile & expected, const TestDataFile & actual)
+    {
+        ASSERT_EQ(expected.rowCount(), actual.rowCount());
+        ASSERT_EQ(expected.columnCount(), actual.columnCount());
+
+        for (TestDataFile::IndexType row = 0; row < expected.rowCount(); ++row) {
+            for (TestDataFile::IndexType col = 0; col < expected.columnCount(); ++col) {
+                if (std::isnan(expected.item(row, col))) {
+                    ASSERT_TRUE(std::isnan(actual.item(row, col))) << "Item at R" << row << ", C" << col << " should be empty";
+                } else {
+                    ASSERT_EQ(expected.item(row, col), actual.item(row, col)) << "Item at R" << row << ", C" << col << " differs";
+                }
+            }
+        }
+
+        for (TestDataFile::IndexType col = 0; col < expected.columnCount(); ++col) {
+            EXPECT_EQ(expected.columnItemCount(col), actual.columnItemCount(col));
+            EXPECT_EQ(expected.columnSum(col), actual.columnSum(col));
+        }
+    }
+
+    /**
+     * Append some content to a file.
+     */
+    void appendToFile(const std::string & path, const std::string & content)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::app) << content;
+    }
+}
+
+TEST_F(DataFileTest, testAppendRow)
+{
+    auto data = dataFile();
+
+    // make sure the summaries are cached before appending
+    const auto sum = data.columnSum(0);
+    const auto max = data.columnMax(1);
+    data.appendRow({1000.0, NAN});
+
+    ASSERT_EQ(TestDataRowCount + 1, data.rowCount());
+    ASSERT_EQ(TestDataColumnCount, data.columnCount());
+    EXPECT_NEAR(sum + 1000.0L, data.columnSum(0), FloatEqualityDelta);
+    EXPECT_EQ(1000.0L, data.columnMax(0));
+    EXPECT_EQ(max, data.columnMax(1));
+    EXPECT_EQ(TestDataRowCount, data.columnItemCount(1));
+    EXPECT_TRUE(std::isnan(data.item(TestDataRowCount, 1)));
+
+    // a wider row adds columns that are empty for the existing rows
+    data.appendRow({1.0, 2.0, 3.0, 4.0});
+    ASSERT_EQ(4, data.columnCount());
+    EXPECT_EQ(1, data.columnItemCount(3));
+    EXPECT_EQ(4.0L, data.columnSum(3));
+    EXPECT_TRUE(std::isnan(data.item(0, 3)));
+    EXPECT_TRUE(std::isnan(data.item(TestDataRowCount, 2)));
+}
+
+TEST_F(DataFileTest, testAppendLine)
+{
+    auto data = dataFile();
+    data.appendLine("5,,7");
+
+    ASSERT_EQ(TestDataRowCount + 1, data.rowCount());
+    EXPECT_EQ(5.0L, data.item(TestDataRowCount, 0));
+    EXPECT_TRUE(std::isnan(data.item(TestDataRowCount, 1)));
+    EXPECT_EQ(7.0L, data.item(TestDataRowCount, 2));
+    EXPECT_EQ(2, data.rowItemCount(TestDataRowCount));
+}
+
+TEST(DataFileRefreshTest, testRefreshMatchesReload)
+{
+    auto path = writeTemporaryFile("1,2\n3,4\n5,");
+
+    for (const auto mode : {LoadMode::Mapped, LoadMode::Stream}) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "1,2\n3,4\n5,";
+        auto data = TestDataFile(path, LoadOptions{mode, 1});
+        ASSERT_EQ(3, data.rowCount());
+        EXPECT_EQ(3, data.refresh());
+
+        // complete the partly-written final line and add a wider row
+        appendToFile(path, "6\n7,8,9");
+        EXPECT_EQ(2, data.refresh());
+        expectIdentical(TestDataFile(path), data);
+
+        // extend the final line, so that its extra column goes away and comes back
+        appendToFile(path, "0\n10");
+        EXPECT_EQ(3, data.refresh());
+        expectIdentical(TestDataFile(path), data);
+
+        // a trailing newline is an empty row
+        appendToFile(path, "\n");
+        EXPECT_EQ(4, data.refresh());
+        expectIdentical(TestDataFile(path), data);
+        appendToFile(path, "11,12");
+        EXPECT_EQ(5, data.refresh());
+        expectIdentical(TestDataFile(path), data);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileRefreshTest, testRefreshDiscardsAppendedRows)
+{
+    auto path = writeTemporaryFile("1,2\n3,4");
+    auto data = TestDataFile(path);
+    data.appendRow({100.0, 200.0});
+    appendToFile(path, "\n5,6");
+
+    EXPECT_EQ(1, data.refresh());
+    expectIdentical(TestDataFile(path), data);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileRefreshTest, testRefreshReloadsShrunkFile)
+{
+    auto path = writeTemporaryFile("1,2\n3,4\n5,6");
+    auto data = TestDataFile(path);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "7,8,9";
+
+    EXPECT_EQ(0, data.refresh());
+    expectIdentical(TestDataFile(path), data);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileCacheTest, testCacheMatchesSource)
+{
+    auto path = writeTemporaryFile("1,2\n3,4,5\n,6\n7\n8.5,-9");
+    const auto cachePath = Cache::defaultPath<ValueType>(path);
+    const auto parsed = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Update});
+
+    EXPECT_FALSE(parsed.isFromCache());
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+
+    for (const auto & cacheMode : {CacheMode::Read, CacheMode::Update}) {
+        const auto cached = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, cacheMode});
+        EXPECT_TRUE(cached.isFromCache());
+        EXPECT_TRUE(cached.column(0).isBorrowed());
+        expectIdentical(parsed, cached);
+    }
+
+    // other value types have their own cache
+    EXPECT_FALSE(DataFile<float>(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read}).isFromCache());
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileCacheTest, testStaleCacheIsRebuilt)
+{
+    auto path = writeTemporaryFile("1,2\n3,4");
+    const auto cachePath = Cache::defaultPath<ValueType>(path);
+    EXPECT_FALSE(TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Update}).isFromCache());
+
+    appendToFile(path, "\n5,6");
+    const auto reparsed = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Update});
+    EXPECT_FALSE(reparsed.isFromCache());
+    EXPECT_EQ(3, reparsed.rowCount());
+
+    const auto cached = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read});
+    EXPECT_TRUE(cached.isFromCache());
+    expectIdentical(reparsed, cached);
+
+    // a source with the same size but a different modification time is stale too
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(10));
+    EXPECT_FALSE(TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read}).isFromCache());
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileCacheTest, testMalformedCacheIsIgnored)
+{
+    auto path = writeTemporaryFile("1,2\n3,4");
+    const auto cachePath = path + ".cache";
+    ASSERT_TRUE(TestDataFile(path).writeCache(cachePath));
+    const auto size = std::filesystem::file_size(cachePath);
+
+    // a truncated cache
+    std::filesystem::resize_file(cachePath, size - 1);
+    const auto truncated = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read, cachePath});
+    EXPECT_FALSE(truncated.isFromCache());
+    EXPECT_EQ(2, truncated.rowCount());
+
+    // not a cache at all
+    std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << "1,2\n3,4";
+    EXPECT_FALSE(TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read, cachePath}).isFromCache());
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileCacheTest, testModifyingCachedData)
+{
+    auto path = writeTemporaryFile("1,2\n3,4\n5,");
+    const auto cachePath = path + ".cache";
+    ASSERT_TRUE(TestDataFile(path).writeCache(cachePath));
+    auto data = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read, cachePath});
+    ASSERT_TRUE(data.isFromCache());
+
+    // the cache remembers where the final line is so the data can still be refreshed
+    appendToFile(path, "6\n7,8");
+    EXPECT_EQ(2, data.refresh());
+    expectIdentical(TestDataFile(path), data);
+    EXPECT_FALSE(data.column(0).isBorrowed());
+
+    // modified data doesn't match its source, so it can't be cached
+    data.appendRow({9.0});
+    EXPECT_EQ(10.0L + 9.0L + 6.0L, data.columnSum(0));
+    EXPECT_FALSE(data.writeCache(cachePath));
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileCacheTest, testConcurrentWritersDontCollide)
+{
+    auto path = writeTemporaryFile("1,2\n3,4\n5,6\n7,8");
+    const auto cachePath = path + ".cache";
+    const auto data = TestDataFile(path);
+    std::vector<std::thread> writers;
+    std::vector<char> written(8, 0);
+
+    // each writer has its own temporary file, so every one of them completes its cache and replaces the last
+    for (std::size_t idx = 0; idx < written.size(); ++idx) {
+        writers.emplace_back([&data, &cachePath, &written, idx]() {
+            written[idx] = data.writeCache(cachePath);
+        });
+    }
+
+    for (auto & writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(written.cend(), std::find(written.cbegin(), written.cend(), 0));
+    const auto cached = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read, cachePath});
+    EXPECT_TRUE(cached.isFromCache());
+    expectIdentical(data, cached);
+
+    // nothing is left behind alongside the cache
+    EXPECT_NE(Cache::temporaryPath(cachePath), Cache::temporaryPath(cachePath));
+
+    for (const auto & entry : std::filesystem::directory_iterator(std::filesystem::path(cachePath).parent_path())) {
+        EXPECT_NE(0, entry.path().string().rfind(cachePath + ".tmp", 0));
+    }
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataItemParserTest, testTryParseDataItem)
+{
+    double value = 0.0;
+    EXPECT_EQ(DataItemStatus::Ok, tryParseDataItem(" 1.5\t", value));
+    EXPECT_EQ(1.5, value);
+    EXPECT_EQ(DataItemStatus::Empty, tryParseDataItem("", value));
+    EXPECT_EQ(DataItemStatus::Empty, tryParseDataItem("  ", value));
+    EXPECT_EQ(DataItemStatus::Invalid, tryParseDataItem("x", value));
+    EXPECT_EQ(DataItemStatus::TrailingCharacters, tryParseDataItem("2.5x", value));
+    EXPECT_EQ(DataItemStatus::OutOfRange, tryParseDataItem("1e999", value));
+    EXPECT_EQ(1.5, value);
+
+    int integer = 0;
+    EXPECT_EQ(DataItemStatus::Ok, tryParseDataItem("-7 ", integer));
+    EXPECT_EQ(-7, integer);
+    EXPECT_EQ(DataItemStatus::OutOfRange, tryParseDataItem("99999999999", integer));
+    EXPECT_EQ(DataItemStatus::TrailingCharacters, tryParseDataItem("7.5", integer));
+
+    EXPECT_THROW(defaultDataItemParser<double>(""), std::invalid_argument);
+    EXPECT_EQ(3.25, defaultDataItemParser<double>("3.25"));
+}
+
+TEST(DataFileParseReportTest, testEmptyCellsAreNotErrors)
+{
+    const auto path = writeTemporaryFile("1,,3\n,5\n6,7,");
+    const TestDataFile data(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(3, data.rowCount());
+    EXPECT_EQ(3, data.parseReport().emptyCount);
+    EXPECT_EQ(0, data.parseReport().errorCount);
+    EXPECT_TRUE(data.parseReport().errors.empty());
+    EXPECT_TRUE(std::isnan(data.item(0, 1)));
+}
+
+TEST(DataFileParseReportTest, testErrorsAreLoggedWithPosition)
+{
+    const auto path = writeTemporaryFile("1,2\n3,abc\n4x,5\n6,1e99999");
+    const TestDataFile data(path);
+    std::filesystem::remove(path);
+    const auto & report = data.parseReport();
+
+    EXPECT_EQ(3, report.errorCount);
+    ASSERT_EQ(3, report.errors.size());
+    EXPECT_EQ(1, report.errors[0].row);
+    EXPECT_EQ(1, report.errors[0].column);
+    EXPECT_EQ(DataItemStatus::Invalid, report.errors[0].status);
+    EXPECT_EQ("abc", report.errors[0].text);
+    EXPECT_EQ(2, report.errors[1].row);
+    EXPECT_EQ(0, report.errors[1].column);
+    EXPECT_EQ(DataItemStatus::TrailingCharacters, report.errors[1].status);
+    EXPECT_EQ(DataItemStatus::OutOfRange, report.errors[2].status);
+    EXPECT_TRUE(std::isnan(data.item(1, 1)));
+
+    std::ostringstream out;
+    report.write(out);
+    EXPECT_EQ(0, out.str().find("ERR invalid numeric value \"abc\" at row 1, column 1\n"));
+}
+
+TEST(DataFileParseReportTest, testLogIsBounded)
+{
+    std::string content;
+
+    for (int row = 0; row < 50; ++row) {
+        content += (0 == row ? "" : "\n") + std::to_string(row) + ",bad" + std::string(100, 'x');
+    }
+
+    const auto path = writeTemporaryFile(content);
+    LoadOptions options;
+    options.errorLogLimit = 4;
+    const TestDataFile data(path, options);
+    const auto & report = data.parseReport();
+
+    EXPECT_EQ(50, report.errorCount);
+    ASSERT_EQ(4, report.errors.size());
+    EXPECT_EQ(3, report.errors.back().row);
+    EXPECT_EQ(ParseError::MaxTextLength, report.errors.back().text.size());
+
+    std::ostringstream out;
+    report.write(out);
+    EXPECT_NE(std::string::npos, out.str().find("ERR 46 more values could not be parsed\n"));
+
+    options.errorLogLimit = 0;
+    const TestDataFile unlogged(path, options);
+    std::filesystem::remove(path);
+    EXPECT_EQ(50, unlogged.parseReport().errorCount);
+    EXPECT_TRUE(unlogged.parseReport().errors.empty());
+}
+
+TEST(DataFileParseReportTest, testParallelLoadReportIsIdentical)
+{
+    // large enough to be split into several chunks
+    std::string content;
+
+    for (int row = 0; row < 40000; ++row) {
+        content += (0 == row ? "" : "\n") + std::to_string(row) + (0 == row % 1000 ? ",oops" : ",1.5") + (0 == row % 3 ? "," : "");
+    }
+
+    const auto path = writeTemporaryFile(content);
+    LoadOptions options;
+    options.errorLogLimit = 25;
+    const TestDataFile serial(path, options);
+    options.threads = 4;
+    const TestDataFile parallel(path, options);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(serial.parseReport().emptyCount, parallel.parseReport().emptyCount);
+    EXPECT_EQ(40, parallel.parseReport().errorCount);
+    ASSERT_EQ(25, parallel.parseReport().errors.size());
+
+    for (std::size_t idx = 0; idx < parallel.parseReport().errors.size(); ++idx) {
+        EXPECT_EQ(idx * 1000, parallel.parseReport().errors[idx].row);
+        EXPECT_EQ(serial.parseReport().errors[idx].row, parallel.parseReport().errors[idx].row);
+    }
+}
+
+TEST(DataFileParseReportTest, testRefreshReportsAppendedRows)
+{
+    const auto path = writeTemporaryFile("1,2\n3,x");
+    TestDataFile data(path);
+    EXPECT_EQ(1, data.parseReport().errorCount);
+
+    appendToFile(path, "\n4,5\ny,6");
+    data.refresh();
+    std::filesystem::remove(path);
+
+    // the final line is parsed again, so its error is reported again along with the new one
+    ASSERT_EQ(2, data.parseReport().errors.size());
+    EXPECT_EQ(1, data.parseReport().errors[0].row);
+    EXPECT_EQ(3, data.parseReport().errors[1].row);
+    EXPECT_EQ(0, data.parseReport().errors[1].column);
+}
+
+namespace
+{
+    /**
+     * A custom parser that only accepts "one" and "two".
+     */
+    double wordParser(const std::string_view & item)
+    {
+        if ("one" == item) {
+            return 1.0;
+        } else if ("two" == item) {
+            return 2.0;
+        }
+
+        throw std::invalid_argument("not a word");
+    }
+}
+
+TEST(DataFileParseReportTest, testCustomParser)
+{
+    const auto path = writeTemporaryFile("one,two\n,three");
+    const DataFile<double, wordParser> data(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(2.0, data.item(0, 1));
+    EXPECT_EQ(1, data.parseReport().emptyCount);
+    EXPECT_EQ(1, data.parseReport().errorCount);
+    EXPECT_EQ(DataItemStatus::Invalid, data.parseReport().errors.front().status);
+}
+
+namespace
+{
+    /**
+     * Assert that a column of one DataFile holds the same cells as a column of another.
+     */
+    void expectSameColumn(const TestDataFile & expected, TestDataFile::IndexType expectedCol, const TestDataFile & actual, TestDataFile::IndexType actualCol)
+    {
+        ASSERT_EQ(expected.rowCount(), actual.rowCount());
+
+        for (TestDataFile::IndexType row = 0; row < expected.rowCount(); ++row) {
+            if (std::isnan(expected.item(row, expectedCol))) {
+                ASSERT_TRUE(std::isnan(actual.item(row, actualCol))) << "Item at R" << row << ", C" << actualCol << " should be empty";
+            } else {
+                ASSERT_EQ(expected.item(row, expectedCol), actual.item(row, actualCol)) << "Item at R" << row << ", C" << actualCol << " differs";
+            }
+        }
+    }
+
+    /**
+     * Make load options that select some columns.
+     */
+    LoadOptions selecting(std::vector<std::size_t> columns, LoadMode mode = LoadMode::Mapped, unsigned int threads = 1)
+    {
+        LoadOptions options{mode, threads};
+        options.columns = std::move(columns);
+        return options;
+    }
+}
+
+TEST(DataFileProjectionTest, testSelectedColumnsMatchFullLoad)
+{
+    auto path = writeTemporaryFile("1,2,3,4\n5,6\n,8,9,10,11\n12");
+    const auto full = TestDataFile(path);
+
+    for (const auto mode : {LoadMode::Mapped, LoadMode::Stream}) {
+        // out of order, repeated, and one column that no row reaches
+        const auto selected = TestDataFile(path, selecting({3, 0, 3, 7}, mode));
+
+        ASSERT_EQ(4, selected.rowCount());
+        ASSERT_EQ(4, selected.columnCount());
+        expectSameColumn(full, 3, selected, 0);
+        expectSameColumn(full, 0, selected, 1);
+        expectSameColumn(full, 3, selected, 2);
+        EXPECT_EQ(0, selected.columnItemCount(3));
+        EXPECT_EQ(3, selected.sourceColumn(0));
+        EXPECT_EQ(7, selected.sourceColumn(3));
+        EXPECT_THROW((void) selected.sourceColumn(4), std::invalid_argument);
+    }
+
+    EXPECT_EQ(2, full.sourceColumn(2));
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileProjectionTest, testUnselectedCellsAreNotParsed)
+{
+    auto path = writeTemporaryFile("1,x,2,y\n3,,oops,z\n5");
+    const auto data = TestDataFile(path, selecting({2, 0}));
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(1, data.columnItemCount(0));
+    EXPECT_EQ(3, data.columnItemCount(1));
+    EXPECT_EQ(0, data.parseReport().emptyCount);
+    EXPECT_EQ(1, data.parseReport().errorCount);
+    ASSERT_EQ(1, data.parseReport().errors.size());
+
+    // errors are reported by their column in the file
+    EXPECT_EQ(1, data.parseReport().errors.front().row);
+    EXPECT_EQ(2, data.parseReport().errors.front().column);
+}
+
+TEST(DataFileProjectionTest, testParallelLoadAndRefreshAreIdentical)
+{
+    std::string content;
+
+    for (int row = 0; row < 30000; ++row) {
+        content += (0 == row ? "" : "\n") + std::to_string(row) + "," + std::to_string(row * 0.5) + (0 == row % 7 ? "" : ",-1," + std::to_string(row % 13));
+    }
+
+    auto path = writeTemporaryFile(content);
+    const auto serial = TestDataFile(path, selecting({3, 1}));
+    const auto parallel = TestDataFile(path, selecting({3, 1}, LoadMode::Mapped, 4));
+    expectIdentical(serial, parallel);
+
+    auto refreshed = TestDataFile(path, selecting({3, 1}));
+    appendToFile(path, "7\n1,2,3,4,5\n6");
+    EXPECT_EQ(serial.rowCount() - 1, refreshed.refresh());
+    expectIdentical(TestDataFile(path, selecting({3, 1})), refreshed);
+    EXPECT_EQ(2, refreshed.columnCount());
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileProjectionTest, testSelectionHasItsOwnCache)
+{
+    auto path = writeTemporaryFile("1,2,3\n4,5,6");
+    auto options = selecting({2, 0});
+    options.cache = CacheMode::Update;
+    const auto parsed = TestDataFile(path, options);
+    const auto cachePath = Cache::defaultPath<ValueType>(path, {2, 0});
+
+    EXPECT_NE(Cache::defaultPath<ValueType>(path), cachePath);
+    EXPECT_EQ(cachePath, parsed.cachePath());
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+
+    options.cache = CacheMode::Read;
+    const auto cached = TestDataFile(path, options);
+    EXPECT_TRUE(cached.isFromCache());
+    expectIdentical(parsed, cached);
+
+    // the whole file doesn't come from the selection's cache
+    EXPECT_FALSE(TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read}).isFromCache());
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileProjectionTest, testSelectionIsPickedFromWholeFileCache)
+{
+    auto path = writeTemporaryFile("1,2,3\n4,,6\n7,8");
+    const auto whole = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Update});
+    const auto parsed = TestDataFile(path, selecting({2, 5, 0}));
+    auto options = selecting({2, 5, 0});
+    options.cache = CacheMode::Update;
+    const auto picked = TestDataFile(path, options);
+
+    EXPECT_TRUE(picked.isFromCache());
+    EXPECT_TRUE(picked.column(0).isBorrowed());
+    expectIdentical(parsed, picked);
+
+    // it didn't need a cache of its own
+    EXPECT_FALSE(std::filesystem::exists(picked.cachePath()));
+
+    // a refresh reads on from the cached data as it does from parsed data
+    auto refreshed = picked;
+    appendToFile(path, "9\n10,11,12");
+    EXPECT_EQ(2, refreshed.refresh());
+    expectIdentical(TestDataFile(path, selecting({2, 5, 0})), refreshed);
+
+    std::filesystem::remove(whole.cachePath());
+    std::filesystem::remove(path);
+
+    // the whole file's cache has no Text columns, so it can't serve a selection that has one
+    path = writeTemporaryFile("1,2,3\n4,,6\n7,8");
+    const auto untyped = TestDataFile(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Update});
+    options.cache = CacheMode::Read;
+    options.schema = {ColumnType::Text};
+    EXPECT_FALSE(TestDataFile(path, options).isFromCache());
+
+    // unless the Text column isn't in the file
+    options.schema = {ColumnType::Real, ColumnType::Text};
+    EXPECT_TRUE(TestDataFile(path, options).isFromCache());
+
+    std::filesystem::remove(untyped.cachePath());
+    std::filesystem::remove(path);
+}
+
+TEST(DataItemParserTest, testParseIntegerDataItem)
+{
+    for (const auto * item : {"0", "42", " -17 ", "123456789012345678", "9223372036854775807", "99999999999999999999", "-0", "1.5", "1e3", "+4", "", "x"}) {
+        double expected = -1.0;
+        double actual = -1.0;
+        const auto expectedStatus = parseDataItem<double, defaultDataItemParser<double>>(item, expected);
+        const auto actualStatus = parseIntegerDataItem<double, defaultDataItemParser<double>>(item, actual);
+
+        EXPECT_EQ(expectedStatus, actualStatus) << "Parsing \"" << item << "\"";
+        EXPECT_EQ(expected, actual) << "Parsing \"" << item << "\"";
+        EXPECT_EQ(std::signbit(expected), std::signbit(actual)) << "Parsing \"" << item << "\"";
+    }
+
+    EXPECT_TRUE(isWholeNumber(" -12 "));
+    EXPECT_FALSE(isWholeNumber("1.0"));
+    EXPECT_FALSE(isWholeNumber("-"));
+    EXPECT_FALSE(isWholeNumber("1234567890123456789"));
+}
+
+TEST(DataItemParserTest, testIsHeaderLine)
+{
+    EXPECT_TRUE((isHeaderLine<double, defaultDataItemParser<double>>("before,after")));
+    EXPECT_TRUE((isHeaderLine<double, defaultDataItemParser<double>>("\"id\",,label")));
+    EXPECT_FALSE((isHeaderLine<double, defaultDataItemParser<double>>("name,1")));
+    EXPECT_FALSE((isHeaderLine<double, defaultDataItemParser<double>>(" , ")));
+    EXPECT_FALSE((isHeaderLine<double, defaultDataItemParser<double>>("")));
+    EXPECT_EQ("label", headerName(" \"label\" "));
+}
+
+TEST(DataFileHeaderTest, testHeaderIsDetected)
+{
+    auto path = writeTemporaryFile("\"first\", second ,first\n1,2,3\n4,5");
+
+    for (const auto mode : {LoadMode::Mapped, LoadMode::Stream}) {
+        const auto data = TestDataFile(path, LoadOptions{mode, 1});
+
+        EXPECT_TRUE(data.hasHeader());
+        ASSERT_EQ(2, data.rowCount());
+        EXPECT_EQ(0, data.parseReport().errorCount);
+        EXPECT_EQ(1.0L, data.item(0, 0));
+        EXPECT_EQ("second", data.columnName(1));
+        EXPECT_EQ("first", data.columnName(2));
+        EXPECT_EQ(1, data.columnIndex("second"));
+        EXPECT_EQ(0, data.columnIndex("first"));
+        EXPECT_FALSE(data.columnIndex("third"));
+    }
+
+    LoadOptions options;
+    options.header = HeaderMode::Absent;
+    const auto headless = TestDataFile(path, options);
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(headless.hasHeader());
+    EXPECT_EQ(3, headless.rowCount());
+    EXPECT_EQ(3, headless.parseReport().errorCount);
+    EXPECT_TRUE(headless.columnName(0).empty());
+}
+
+TEST(DataFileHeaderTest, testHeaderModes)
+{
+    auto path = writeTemporaryFile("1,2\n3,4");
+    LoadOptions options;
+    options.header = HeaderMode::Present;
+    const auto data = TestDataFile(path, options);
+    const auto detected = TestDataFile(path);
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(data.hasHeader());
+    EXPECT_EQ(1, data.rowCount());
+    EXPECT_EQ("2", data.columnName(1));
+    EXPECT_FALSE(detected.hasHeader());
+    EXPECT_EQ(2, detected.rowCount());
+
+    // a header with no data
+    path = writeTemporaryFile("a,b");
+    const auto empty = TestDataFile(path);
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(empty.hasHeader());
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_EQ(0, empty.rowCount());
+}
+
+TEST(DataFileHeaderTest, testSelectColumnsByName)
+{
+    std::string content = "a,b,c";
+
+    for (int row = 0; row < 20000; ++row) {
+        content += "\n" + std::to_string(row) + "," + std::to_string(row * 0.25) + "," + std::to_string(-row);
+    }
+
+    auto path = writeTemporaryFile(content);
+    const auto full = TestDataFile(path);
+    LoadOptions options{LoadMode::Mapped, 4, CacheMode::Update};
+    options.columns = {1};
+    options.columnNames = {"c", "missing", "a"};
+    const auto selected = TestDataFile(path, options);
+
+    ASSERT_EQ(4, selected.columnCount());
+    expectSameColumn(full, 1, selected, 0);
+    expectSameColumn(full, 2, selected, 1);
+    expectSameColumn(full, 0, selected, 3);
+    EXPECT_EQ(0, selected.columnItemCount(2));
+    EXPECT_EQ(-1, selected.sourceColumn(2));
+    EXPECT_EQ(3, selected.columnIndex("a"));
+    EXPECT_EQ("c", selected.columnName(1));
+    EXPECT_TRUE(selected.columnName(2).empty());
+
+    // the names are resolved before the cache is looked for
+    options.cache = CacheMode::Read;
+    const auto cached = TestDataFile(path, options);
+    EXPECT_TRUE(cached.isFromCache());
+    EXPECT_TRUE(cached.hasHeader());
+    EXPECT_EQ(1, cached.columnIndex("c"));
+    expectIdentical(selected, cached);
+
+    std::filesystem::remove(cached.cachePath());
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileHeaderTest, testSchema)
+{
+    auto path = writeTemporaryFile("id,value,label\n1,2.5,x\n-0,3,y\n9007199254740993,,z\n4.5,1e2,");
+    LoadOptions options;
+    options.schema = {ColumnType::Integer, ColumnType::Infer, ColumnType::Text};
+    const auto data = TestDataFile(path, options);
+    options.schema = {ColumnType::Real, ColumnType::Real, ColumnType::Real};
+    const auto real = TestDataFile(path, options);
+    std::filesystem::remove(path);
+
+    // cells of Integer columns that aren't whole numbers still parse, and every value matches a Real column
+    expectSameColumn(real, 0, data, 0);
+    expectSameColumn(real, 1, data, 1);
+    EXPECT_TRUE(std::signbit(data.item(1, 0)));
+    EXPECT_EQ(4.5L, data.item(3, 0));
+
+    // Text columns are not parsed, so they are empty without any errors
+    EXPECT_EQ(0, data.columnItemCount(2));
+    EXPECT_EQ(0, data.parseReport().errorCount);
+    EXPECT_EQ(3, real.parseReport().errorCount);
+}
+
+TEST(DataFileHeaderTest, testCacheMatchesHeaderMode)
+{
+    auto path = writeTemporaryFile("1,2\n3,4\n5,6");
+    LoadOptions options{LoadMode::Mapped, 1, CacheMode::Update};
+    options.header = HeaderMode::Present;
+    const auto headed = TestDataFile(path, options);
+    ASSERT_EQ(2, headed.rowCount());
+
+    // the first line is data this time, so the cache of the file without it can't be used
+    options.header = HeaderMode::Absent;
+    options.cache = CacheMode::Read;
+    const auto headless = TestDataFile(path, options);
+    EXPECT_FALSE(headless.isFromCache());
+    EXPECT_EQ(3, headless.rowCount());
+
+    options.header = HeaderMode::Present;
+    const auto cached = TestDataFile(path, options);
+    EXPECT_TRUE(cached.isFromCache());
+    expectIdentical(headed, cached);
+
+    std::filesystem::remove(headed.cachePath());
+    std::filesystem::remove(path);
+}
+
+TEST(DataFileHeaderTest, testCacheMatchesSchema)
+{
+    auto path = writeTemporaryFile("1,2\n3,4");
+    LoadOptions options{LoadMode::Mapped, 1, CacheMode::Update};
+    const auto untyped = TestDataFile(path, options);
+    ASSERT_EQ(2, untyped.columnItemCount(0));
+
+    // a Text column has no values, so the cache of the parsed column can't be used
+    options.schema = {ColumnType::Text, ColumnType::Real};
+    options.cache = CacheMode::Read;
+    const auto text = TestDataFile(path, options);
+    EXPECT_FALSE(text.isFromCache());
+    EXPECT_EQ(0, text.columnItemCount(0));
+
+    // nor can the cache with the Text column be used without it
+    options.cache = CacheMode::Update;
+    EXPECT_FALSE(TestDataFile(path, options).isFromCache());
+    options.cache = CacheMode::Read;
+    const auto cachedText = TestDataFile(path, options);
+    EXPECT_TRUE(cachedText.isFromCache());
+    expectIdentical(text, cachedText);
+    options.schema = {};
+    EXPECT_FALSE(TestDataFile(path, options).isFromCache());
+
+    // the other column types parse the same values, so they can share a cache
+    options.schema = {ColumnType::Integer, ColumnType::Real, ColumnType::Text};
+    EXPECT_FALSE(TestDataFile(path, options).isFromCache());
+    options.schema = {ColumnType::Text, ColumnType::Integer};
+    EXPECT_TRUE(TestDataFile(path, options).isFromCache());
+
+    std::filesystem::remove(untyped.cachePath());
+    std::filesystem::remove(path);
+}
+
+namespace
+{
+    /**
+     * Options for loading a file written in a given dialect.
+     */
+    LoadOptions withDialect(Csv::Dialect dialect, LoadMode mode = LoadMode::Mapped, unsigned int threads = 1)
+    {
+        LoadOptions options{mode, threads};
+        options.dialect = dialect;
+        return options;
+    }
+}
+
+TEST(DataFileDialectTest, testDelimiters)
+{
+    const auto csv = "a,b\n" + toCsv(TestData);
+    auto path = writeTemporaryFile(csv);
+    const auto expected = TestDataFile(path);
+    std::filesystem::remove(path);
+
+    for (const auto delimiter : {'\t', ';'}) {
+        auto content = csv;
+        std::replace(content.begin(), content.end(), ',', delimiter);
+        path = writeTemporaryFile(content);
+
+        for (const auto mode : {LoadMode::Mapped, LoadMode::Stream}) {
+            const auto data = TestDataFile(path, withDialect({delimiter, '"'}, mode));
+            EXPECT_TRUE(data.hasHeader());
+            EXPECT_EQ(1, data.columnIndex("b"));
+            expectIdentical(expected, data);
+        }
+
+        // read as CSV, each line is a single cell that isn't a number
+        const auto comma = TestDataFile(path);
+        std::filesystem::remove(path);
+        EXPECT_EQ(1, comma.columnCount());
+        EXPECT_EQ(0, comma.columnItemCount(0));
+    }
+}
+
+TEST(DataFileDialectTest, testQuotedFields)
+{
+    // quoted numbers, a quoted delimiter in a header name and quoted text spanning lines
+    std::string content = "\"x,1\",y,note";
+
+    for (int row = 0; row < 30000; ++row) {
+        content += "\n\"" + std::to_string(row * 0.5) + "\"," + std::to_string(-row);
+
+        if (0 == row % 7) {
+            content += ",\"spans\n\"\"two\"\", lines\"";
+        }
+    }
+
+    auto path = writeTemporaryFile(content);
+    LoadOptions options{LoadMode::Mapped, 1};
+    options.schema = {ColumnType::Infer, ColumnType::Infer, ColumnType::Text};
+    const auto single = TestDataFile(path, options);
+
+    ASSERT_EQ(30000, single.rowCount());
+    EXPECT_EQ(0, single.parseReport().errorCount);
+    EXPECT_EQ(0, single.columnIndex("x,1"));
+    EXPECT_EQ(1.5L, single.item(3, 0));
+    EXPECT_EQ(-7.0L, single.item(7, 1));
+
+    options.threads = 4;
+    expectIdentical(single, TestDataFile(path, options));
+    options.mode = LoadMode::Stream;
+    expectIdentical(single, TestDataFile(path, options));
+
+    // a record appended with a line end inside a quoted field is read whole by a refresh
+    options.mode = LoadMode::Mapped;
+    auto refreshed = TestDataFile(path, options);
+    appendToFile(path, "\n\"1\",\"2\",\"3\n4\"\n5,6");
+    EXPECT_EQ(29999, refreshed.refresh());
+    expectIdentical(TestDataFile(path, options), refreshed);
+    ASSERT_EQ(30002, refreshed.rowCount());
+    EXPECT_EQ(2.0L, refreshed.item(30000, 1));
+
+    // with quoting off, the quotes are part of the cells
+    const auto unquoted = TestDataFile(path, withDialect({',', '\0'}));
+    std::filesystem::remove(path);
+    EXPECT_LT(30002, unquoted.rowCount());
+    EXPECT_LT(0, unquoted.parseReport().errorCount);
+}
+
+TEST(DataFileDialectTest, testDialectHasItsOwnCache)
+{
+    auto path = writeTemporaryFile("1;2\n3;4");
+    auto options = withDialect({';', '"'});
+    options.cache = CacheMode::Update;
+    const auto semicolon = TestDataFile(path, options);
+    options.dialect = {};
+    const auto comma = TestDataFile(path, options);
+
+    EXPECT_NE(semicolon.cachePath(), comma.cachePath());
+    EXPECT_EQ(2, semicolon.columnCount());
+    EXPECT_EQ(1, comma.columnCount());
+
+    options.dialect = {';', '"'};
+    options.cache = CacheMode::Read;
+    const auto cached = TestDataFile(path, options);
+    EXPECT_TRUE(cached.isFromCache());
+    expectIdentical(semicolon, cached);
+
+    std::filesystem::remove(semicolon.cachePath());
+    std::filesystem::remove(comma.cachePath());
+    std::filesystem::remove(path);
+}
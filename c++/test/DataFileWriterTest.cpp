@@ -0,0 +1,141 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "DataFileWriter.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::temporaryPath;
+
+namespace
+{
+    /**
+     * Format a DataFile the way the t-test CLI used to: each item through the stream with std::fixed and std::setprecision().
+     */
+    template<class DataFileType>
+    std::string streamFormatted(const DataFileType & data, int precision)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(precision);
+
+        for (typename DataFileType::IndexType row = 0; row < data.rowCount(); ++row) {
+            for (typename DataFileType::IndexType col = 0; col < data.columnCount(); ++col) {
+                out << data.item(row, col) << "  ";
+            }
+
+            out << "\n";
+        }
+
+        return out.str();
+    }
+
+    /**
+     * Format a DataFile with a DataFileWriter.
+     */
+    template<class DataFileType>
+    std::string writerFormatted(const DataFileType & data, int precision, std::size_t bufferSize = DataFileWriter::DefaultBufferSize)
+    {
+        std::ostringstream out;
+        EXPECT_TRUE(DataFileWriter(precision, bufferSize).write(out, data));
+        return out.str();
+    }
+
+    /**
+     * Assert that a DataFileWriter matches stream formatting for some CSV content.
+     */
+    template<class T>
+    void expectMatchesStream(const std::string & content)
+    {
+        const auto path = temporaryPath();
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        const DataFile<T> data(path);
+        std::filesystem::remove(path);
+
+        for (const auto precision : {0, 3, 6, 12}) {
+            EXPECT_EQ(streamFormatted(data, precision), writerFormatted(data, precision)) << "Output with precision " << precision << " differs";
+        }
+
+        // a tiny buffer is flushed part-way through most rows
+        EXPECT_EQ(streamFormatted(data, 3), writerFormatted(data, 3, 1));
+    }
+
+    /**
+     * Generate CSV content with a mix of magnitudes, signs, rounding boundaries, empty cells and ragged rows.
+     */
+    std::string mixedContent()
+    {
+        std::mt19937_64 rng(19);
+        std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+        std::uniform_int_distribution<int> exponent(-12, 12);
+        std::ostringstream out;
+        out << std::setprecision(17) << "0.0005,-0.0005,0.0015,2.5,-2.5,1e300,-1e-300,\n";
+
+        for (int row = 0; row < 2000; ++row) {
+            const auto width = 1 + row % 5;
+
+            for (int col = 0; col < width; ++col) {
+                if (0 < col) {
+                    out << ",";
+                }
+
+                if (0 != (row + col) % 11) {
+                    out << mantissa(rng) * std::pow(10.0, exponent(rng));
+                }
+            }
+
+            out << "\n";
+        }
+
+        out << "1,2,3";
+        return out.str();
+    }
+}
+
+TEST(DataFileWriterTest, testMatchesStreamForFloat)
+{
+    expectMatchesStream<float>(mixedContent());
+}
+
+TEST(DataFileWriterTest, testMatchesStreamForDouble)
+{
+    expectMatchesStream<double>(mixedContent());
+}
+
+TEST(DataFileWriterTest, testMatchesStreamForLongDouble)
+{
+    expectMatchesStream<long double>(mixedContent() + "\n1e4000,-1e4000,1e-4000");
+}
+
+TEST(DataFileWriterTest, testMatchesStreamForIntegers)
+{
+    expectMatchesStream<int>("1,-2,3\n2147483647,-2147483648\n,5,x\n0");
+}
+
+TEST(DataFileWriterTest, testEmptyDataFile)
+{
+    const DataFile<double> data;
+    EXPECT_EQ("", writerFormatted(data, 3));
+}
+
+TEST(DataFileWriterTest, testReusesWriter)
+{
+    const auto path = temporaryPath();
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "1.25,2.5\n-3,";
+    const DataFile<double> data(path);
+    std::filesystem::remove(path);
+
+    DataFileWriter writer(2);
+    std::ostringstream first;
+    std::ostringstream second;
+    EXPECT_TRUE(writer.write(first, data));
+    EXPECT_TRUE(writer.write(second, data));
+    EXPECT_EQ("1.25  2.50  \n-3.00  nan  \n", first.str());
+    EXPECT_EQ(first.str(), second.str());
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+
+#include "Distributions.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * π, for the closed forms of the t distribution's CDF.
+     */
+    constexpr const double Pi = 3.14159265358979323846;
+
+    /**
+     * Amount by which calculated probabilities are allowed to vary from their exact values.
+     */
+    constexpr const double ProbabilityDelta = 1e-12;
+}
+
+TEST(DistributionsTest, testLogGamma)
+{
+    // Γ(n) = (n - 1)! for integers, and Γ(1/2) = √π
+    EXPECT_NEAR(0.0, logGamma(1.0), 1e-14);
+    EXPECT_NEAR(0.0, logGamma(2.0), 1e-14);
+    EXPECT_NEAR(std::log(120.0), logGamma(6.0), 1e-13);
+    EXPECT_NEAR(std::log(3628800.0), logGamma(11.0), 1e-12);
+    EXPECT_NEAR(0.5 * std::log(Pi), logGamma(0.5), 1e-14);
+    EXPECT_NEAR(std::lgamma(0.1), logGamma(0.1), 1e-13);
+    EXPECT_NEAR(std::lgamma(123.456), logGamma(123.456), 1e-10);
+}
+
+TEST(DistributionsTest, testRegularisedIncompleteBeta)
+{
+    for (const auto x : {0.0, 0.001, 0.1, 0.25, 0.5, 0.75, 0.9, 0.999, 1.0}) {
+        // closed forms for small shape parameters
+        EXPECT_NEAR(x, regularisedIncompleteBeta(1.0, 1.0, x), ProbabilityDelta) << "x = " << x;
+        EXPECT_NEAR(std::pow(x, 3.5), regularisedIncompleteBeta(3.5, 1.0, x), ProbabilityDelta) << "x = " << x;
+        EXPECT_NEAR(1 - std::pow(1 - x, 4.0), regularisedIncompleteBeta(1.0, 4.0, x), ProbabilityDelta) << "x = " << x;
+
+        // symmetry: I_x(a, b) = 1 - I_(1-x)(b, a)
+        EXPECT_NEAR(1 - regularisedIncompleteBeta(7.5, 2.25, 1 - x), regularisedIncompleteBeta(2.25, 7.5, x), ProbabilityDelta) << "x = " << x;
+    }
+
+    EXPECT_TRUE(std::isnan(regularisedIncompleteBeta(0.0, 1.0, 0.5)));
+    EXPECT_TRUE(std::isnan(regularisedIncompleteBeta(1.0, 1.0, 1.5)));
+    EXPECT_TRUE(std::isnan(regularisedIncompleteBeta(1.0, 1.0, std::nan(""))));
+}
+
+TEST(DistributionsTest, testStudentsTTwoTailedP)
+{
+    for (const auto t : {0.0, 0.5, 1.0, 2.0, 2.5, 10.0, 100.0}) {
+        // 1 degree of freedom is the Cauchy distribution; 2 degrees of freedom also has a simple closed form
+        EXPECT_NEAR(1 - 2 * std::atan(t) / Pi, studentsTTwoTailedP(t, 1.0), ProbabilityDelta) << "t = " << t;
+        EXPECT_NEAR(1 - t / std::sqrt(2 + t * t), studentsTTwoTailedP(t, 2.0), ProbabilityDelta) << "t = " << t;
+
+        // the distribution is symmetric
+        EXPECT_EQ(studentsTTwoTailedP(t, 7.3), studentsTTwoTailedP(-t, 7.3)) << "t = " << t;
+    }
+
+    // tabulated critical values
+    EXPECT_NEAR(0.05, studentsTTwoTailedP(2.228138851986274, 10.0), 1e-12);
+    EXPECT_NEAR(0.01, studentsTTwoTailedP(2.818756060596369, 22.0), 1e-9);
+
+    // approaches the normal distribution for many degrees of freedom
+    EXPECT_NEAR(0.05, studentsTTwoTailedP(1.959963984540054, 1e9), 1e-8);
+
+    EXPECT_EQ(0.0, studentsTTwoTailedP(std::numeric_limits<double>::infinity(), 5.0));
+    EXPECT_TRUE(std::isnan(studentsTTwoTailedP(std::nan(""), 5.0)));
+    EXPECT_TRUE(std::isnan(studentsTTwoTailedP(1.0, 0.0)));
+}
+
+TEST(DistributionsTest, testStandardNormal)
+{
+    EXPECT_NEAR(0.5, standardNormalCdf(0.0), ProbabilityDelta);
+    EXPECT_NEAR(0.975, standardNormalCdf(1.959963984540054), ProbabilityDelta);
+    EXPECT_NEAR(0.0013498980316301, standardNormalCdf(-3.0), ProbabilityDelta);
+
+    EXPECT_EQ(0.0, standardNormalQuantile(0.5));
+    EXPECT_NEAR(1.959963984540054, standardNormalQuantile(0.975), 1e-13);
+    EXPECT_NEAR(-2.326347874040841, standardNormalQuantile(0.01), 1e-13);
+    EXPECT_NEAR(-8.222082216130435, standardNormalQuantile(1e-16), 1e-11);
+
+    // inverse of the CDF across both the central and tail regions of the approximation
+    for (const auto p : {1e-10, 0.001, 0.02, 0.03, 0.3, 0.7, 0.97, 0.98, 0.999}) {
+        EXPECT_NEAR(p, standardNormalCdf(standardNormalQuantile(p)), p * 1e-12) << "p = " << p;
+    }
+
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), standardNormalQuantile(0.0));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), standardNormalQuantile(1.0));
+    EXPECT_TRUE(std::isnan(standardNormalQuantile(1.5)));
+}
@@ -0,0 +1,154 @@
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "FloatParser.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Check that the fast parser either leaves an item alone or converts it exactly as std::from_chars() does.
+     *
+     * @return true if the fast parser converted the item.
+     */
+    template<class T>
+    bool expectMatchesFromChars(const std::string & item)
+    {
+        T fast{};
+
+        if (!FloatParser::tryParse(item, fast)) {
+            return false;
+        }
+
+        T expected{};
+        const auto result = std::from_chars(item.data(), item.data() + item.size(), expected);
+        EXPECT_TRUE(std::errc() == result.ec && item.data() + item.size() == result.ptr) << "\"" << item << "\" is not a whole number";
+        EXPECT_EQ(expected, fast) << "\"" << item << "\" with " << sizeof(T) << "-byte type";
+        EXPECT_EQ(std::signbit(expected), std::signbit(fast)) << "\"" << item << "\" with " << sizeof(T) << "-byte type";
+        return true;
+    }
+
+    /**
+     * Check an item against std::from_chars() for every floating-point type.
+     */
+    void expectAllMatchFromChars(const std::string & item)
+    {
+        expectMatchesFromChars<float>(item);
+        expectMatchesFromChars<double>(item);
+        expectMatchesFromChars<long double>(item);
+    }
+
+    /**
+     * Generate a random item for the differential test.
+     *
+     * Items are drawn from several families: shortest round-trip representations of arbitrary doubles and floats (which cover every exponent, including
+     * subnormals), short decimals as found in data files, and random digit strings with arbitrary decimal points and exponents.
+     */
+    std::string randomItem(std::mt19937_64 & rng)
+    {
+        char buffer[64];
+
+        switch (rng() % 4) {
+            case 0: {
+                double value;
+                const auto bits = rng();
+                std::memcpy(&value, &bits, sizeof(value));
+                return std::isnan(value) ? "nan" : std::string(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            }
+
+            case 1: {
+                float value;
+                const auto bits = static_cast<std::uint32_t>(rng());
+                std::memcpy(&value, &bits, sizeof(value));
+                return std::isnan(value) ? "nan" : std::string(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            }
+
+            case 2: {
+                std::normal_distribution<double> distribution(0.0, std::pow(10.0, static_cast<double>(rng() % 12)));
+                return std::string(buffer, static_cast<std::size_t>(std::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(rng() % 8), distribution(rng))));
+            }
+
+            default: {
+                std::string item(1 + rng() % 21, '0');
+
+                for (auto & ch : item) {
+                    ch = static_cast<char>('0' + rng() % 10);
+                }
+
+                if (0 == rng() % 2) {
+                    item.insert(rng() % item.size(), ".");
+                }
+
+                if (0 == rng() % 2) {
+                    item += "e" + std::to_string(static_cast<int>(rng() % 700) - 350);
+                }
+
+                return (0 == rng() % 2 ? "-" : "") + item;
+            }
+        }
+    }
+}
+
+TEST(FloatParserTest, testDecompose)
+{
+    FloatParser::Decimal decimal;
+
+    ASSERT_TRUE(FloatParser::decompose("-0012.5000e-3", decimal));
+    EXPECT_TRUE(decimal.negative);
+    EXPECT_EQ(125000, decimal.significand);
+    EXPECT_EQ(-7, decimal.exponent);
+
+    ASSERT_TRUE(FloatParser::decompose(".25", decimal));
+    EXPECT_EQ(25, decimal.significand);
+    EXPECT_EQ(-2, decimal.exponent);
+
+    ASSERT_TRUE(FloatParser::decompose("7.", decimal));
+    EXPECT_EQ(7, decimal.significand);
+    EXPECT_EQ(0, decimal.exponent);
+
+    ASSERT_TRUE(FloatParser::decompose("0.000000000000000000000001234567890123456789", decimal));
+    EXPECT_EQ(1234567890123456789U, decimal.significand);
+
+    // not in the syntax std::from_chars() accepts, or too many significant digits
+    for (const auto * item : {"", "-", ".", "+1", "1e", "1e+", "e5", "1.5x", "0x10", "inf", "nan", "1 2", "--1", "12345678901234567890"}) {
+        EXPECT_FALSE(FloatParser::decompose(item, decimal)) << "\"" << item << "\"";
+    }
+}
+
+TEST(FloatParserTest, testEdgeCases)
+{
+    for (const auto * item : {
+        "0", "-0", "0.0", "-0.000", "0e400", "1", "-1", "0.1", "0.2", "0.3", "1e22", "1e23", "1e-22", "1e-23", "123456789012345678", "9007199254740992",
+        "9007199254740993", "9007199254740995", "18014398509481986", "16777217", "16777219", "33554434", "1.7976931348623157e308", "1.7976931348623159e308",
+        "2.2250738585072014e-308", "2.2250738585072011e-308", "4.9e-324", "3.4028235e38", "3.4028236e38", "1.17549435e-38", "1.4e-45", "1e-400", "1e400",
+        "7.2057594037927933e16", "9223372036854775807", "9999999999999999999", "0.1e-99999", "5e-324", "8.98846567431158e307",
+    }) {
+        expectAllMatchFromChars(item);
+    }
+}
+
+TEST(FloatParserTest, testConvertsTypicalItems)
+{
+    // short decimals must take the fast path for every type, or there is no point to it
+    for (const auto * item : {"12.375", "-4.1e-3", "100", "0.001", "98765.4321"}) {
+        EXPECT_TRUE(expectMatchesFromChars<float>(item)) << "\"" << item << "\"";
+        EXPECT_TRUE(expectMatchesFromChars<double>(item)) << "\"" << item << "\"";
+        EXPECT_TRUE(expectMatchesFromChars<long double>(item)) << "\"" << item << "\"";
+    }
+}
+
+TEST(FloatParserTest, testMatchesFromChars)
+{
+    std::mt19937_64 rng(42);
+
+    for (int idx = 0; idx < 200000 && !::testing::Test::HasFailure(); ++idx) {
+        expectAllMatchFromChars(randomItem(rng));
+    }
+}
@@ -0,0 +1,164 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "IncrementalTTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::toCsv;
+using TestFiles::writeTemporaryCsv;
+
+namespace
+{
+    /**
+     * Convenience alias for the concrete type of the incremental test being tested.
+     */
+    using TestIncrementalTTest = IncrementalTTest<double>;
+
+    /**
+     * Test data, with every cell present.
+     */
+    const std::vector<std::vector<double>> TestData = {
+        {12.1, 11.0}, {14.3, 13.9}, {11.8, 12.5}, {15.2, 13.1}, {13.0, 12.2},
+        {12.7, 12.9}, {16.1, 14.0}, {14.4, 13.2}, {13.3, 13.6}, {15.0, 13.8},
+    };
+
+    /**
+     * Test data with cells missing from either column, so some rows are incomplete pairs.
+     */
+    const std::vector<std::vector<double>> RaggedData = {
+        {12.1, 11.0}, {14.3, NAN}, {11.8, 12.5}, {NAN, 13.1}, {13.0, 12.2},
+        {12.7, 12.9}, {16.1, 14.0}, {NAN, NAN}, {13.3, 13.6}, {15.0, 13.8}, {14.2, NAN},
+    };
+
+    /**
+     * Run the single test on a file, for comparison.
+     */
+    TTestResult<double> expectedResult(const std::string & path, TTestType type)
+    {
+        return TTest<double>(TTest<double>::DataFileType(path), type).result();
+    }
+
+    /**
+     * Assert that two results match to within rounding.
+     */
+    void expectResultsMatch(const TTestResult<double> & expected, const TTestResult<double> & actual)
+    {
+        EXPECT_NEAR(expected.t, actual.t, 1e-9);
+        EXPECT_NEAR(expected.degreesOfFreedom, actual.degreesOfFreedom, 1e-9);
+        EXPECT_NEAR(expected.twoTailedP, actual.twoTailedP, 1e-9);
+    }
+}
+
+TEST(IncrementalTTestTest, testAppendRowMatchesTTest)
+{
+    const auto path = writeTemporaryCsv({TestData.begin(), TestData.begin() + 3});
+    TestIncrementalTTest test(TestIncrementalTTest::DataFileType(path), TTestType::Paired);
+    EXPECT_EQ(3, test.rowCount());
+
+    for (auto row = TestData.begin() + 3; row != TestData.end(); ++row) {
+        test.appendRow((*row)[0], (*row)[1]);
+    }
+
+    ASSERT_EQ(static_cast<TestIncrementalTTest::IndexType>(TestData.size()), test.rowCount());
+    const auto full = writeTemporaryCsv(TestData);
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        test.setType(type);
+        expectResultsMatch(expectedResult(full, type), test.result());
+        EXPECT_NEAR(TTest<double>(TTest<double>::DataFileType(full), type).t(), test.t(), 1e-9);
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(full);
+}
+
+TEST(IncrementalTTestTest, testUpdatePicksUpAppendedData)
+{
+    const auto path = writeTemporaryCsv({TestData.begin(), TestData.begin() + 5});
+    TestIncrementalTTest test(TestIncrementalTTest::DataFileType(path), TTestType::Welch);
+    auto data = test.dataPtr();
+
+    data->appendRow({TestData[5][0], TestData[5][1]});
+    data->appendLine("16.1,14");
+    EXPECT_EQ(2, test.update());
+    EXPECT_EQ(0, test.update());
+
+    const auto expected = writeTemporaryCsv({TestData.begin(), TestData.begin() + 7});
+    expectResultsMatch(expectedResult(expected, TTestType::Welch), test.result());
+    std::filesystem::remove(path);
+    std::filesystem::remove(expected);
+}
+
+TEST(IncrementalTTestTest, testRefreshFollowsGrowingFile)
+{
+    const auto path = writeTemporaryCsv({TestData.begin(), TestData.begin() + 4});
+    TestIncrementalTTest test(TestIncrementalTTest::DataFileType(path), TTestType::Paired);
+
+    // nothing to read yet
+    EXPECT_EQ(4, test.refresh());
+
+    // finish the final line ("15.2,13.1" becomes "15.2,13.15") and write part of another
+    std::ofstream(path, std::ios::binary | std::ios::app) << "5\n13,12.";
+    EXPECT_EQ(3, test.refresh());
+    EXPECT_EQ(5, test.rowCount());
+    EXPECT_EQ(5, test.data().rowCount());
+
+    std::ofstream(path, std::ios::binary | std::ios::app) << "2\n" << toCsv({TestData.begin() + 5, TestData.end()});
+    EXPECT_EQ(4, test.refresh());
+    EXPECT_EQ(10, test.rowCount());
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        test.setType(type);
+        expectResultsMatch(expectedResult(path, type), test.result());
+    }
+
+    // replacing the file rebuilds the moments
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << toCsv({TestData.begin(), TestData.begin() + 2});
+    EXPECT_EQ(0, test.refresh());
+    EXPECT_EQ(2, test.rowCount());
+    test.setType(TTestType::Welch);
+    expectResultsMatch(expectedResult(path, TTestType::Welch), test.result());
+    std::filesystem::remove(path);
+}
+
+TEST(IncrementalTTestTest, testMissingCellsMatchTTest)
+{
+    const auto path = writeTemporaryCsv({RaggedData.begin(), RaggedData.begin() + 4});
+    TestIncrementalTTest test(TestIncrementalTTest::DataFileType(path), TTestType::Paired);
+
+    for (auto row = RaggedData.begin() + 4; row != RaggedData.end(); ++row) {
+        test.appendRow((*row)[0], (*row)[1]);
+    }
+
+    const auto full = writeTemporaryCsv(RaggedData);
+    StreamingTTest<double> streaming;
+    ASSERT_TRUE(streaming.read(full));
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        test.setType(type);
+        streaming.setType(type);
+        const auto expected = expectedResult(full, type);
+        ASSERT_FALSE(std::isnan(expected.t));
+        expectResultsMatch(expected, test.result());
+        expectResultsMatch(expected, streaming.result());
+    }
+
+    // only the seven complete pairs count
+    test.setType(TTestType::Paired);
+    EXPECT_NEAR(6.0, test.result().degreesOfFreedom, 1e-12);
+
+    // a missing first value doesn't shorten the pairs that TTest reads
+    const auto leading = writeTemporaryCsv({{NAN, 1.0}, {2.0, 1.5}, {4.0, 2.0}, {3.5, 3.0}, {5.0, 3.5}});
+    TestIncrementalTTest leadingTest(TestIncrementalTTest::DataFileType(leading), TTestType::Paired);
+    expectResultsMatch(expectedResult(leading, TTestType::Paired), leadingTest.result());
+    EXPECT_NEAR(3.0, leadingTest.result().degreesOfFreedom, 1e-12);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(full);
+    std::filesystem::remove(leading);
+}
@@ -0,0 +1,93 @@
+// compiled into its own executable so that the instrumented and uninstrumented versions of the inline functions never meet in one program
+#define STATISTICS_INSTRUMENTATION 1
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "TTest.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Test fixture providing a small data file with one unparseable cell.
+     */
+    class InstrumentationTest : public ::testing::Test
+    {
+        protected:
+            void SetUp() override
+            {
+                m_path = (std::filesystem::temp_directory_path() / "t-test-instrumentation-test.csv").string();
+                std::ofstream(m_path, std::ios::binary | std::ios::trunc) << "1.5,2.5\n2.5,x\n3.5,4.5,5.5";
+                Instrumentation::reset();
+            }
+
+            void TearDown() override
+            {
+                std::filesystem::remove(Cache::defaultPath<double>(m_path));
+                std::filesystem::remove(m_path);
+            }
+
+            std::string m_path;
+    };
+}
+
+TEST_F(InstrumentationTest, testParseCounters)
+{
+    const DataFile<double> data(m_path);
+
+    EXPECT_EQ(std::filesystem::file_size(m_path), Instrumentation::value(Instrumentation::Counter::BytesRead));
+    EXPECT_EQ(3, Instrumentation::value(Instrumentation::Counter::RowsParsed));
+    EXPECT_EQ(7, Instrumentation::value(Instrumentation::Counter::CellsParsed));
+    EXPECT_EQ(1, Instrumentation::value(Instrumentation::Counter::ParseErrors));
+    EXPECT_EQ(0, Instrumentation::value(Instrumentation::Counter::CacheLoads));
+    EXPECT_EQ(1, Instrumentation::calls(Instrumentation::Phase::Load));
+    EXPECT_EQ(1, Instrumentation::calls(Instrumentation::Phase::Parse));
+    EXPECT_LE(Instrumentation::elapsed(Instrumentation::Phase::Parse), Instrumentation::elapsed(Instrumentation::Phase::Load));
+}
+
+TEST_F(InstrumentationTest, testCacheCounters)
+{
+    const LoadOptions options{LoadMode::Mapped, 1, CacheMode::Update};
+    static_cast<void>(DataFile<double>(m_path, options));
+    EXPECT_EQ(1, Instrumentation::calls(Instrumentation::Phase::CacheWrite));
+
+    Instrumentation::reset();
+    const DataFile<double> data(m_path, options);
+    EXPECT_TRUE(data.isFromCache());
+    EXPECT_EQ(1, Instrumentation::value(Instrumentation::Counter::CacheLoads));
+    EXPECT_EQ(0, Instrumentation::value(Instrumentation::Counter::RowsParsed));
+    EXPECT_EQ(1, Instrumentation::calls(Instrumentation::Phase::CacheRead));
+    EXPECT_EQ(0, Instrumentation::calls(Instrumentation::Phase::Parse));
+}
+
+TEST_F(InstrumentationTest, testSummariesAreCountedOnce)
+{
+    const TTest<double> test(TTest<double>::DataFileType(m_path), TTestType::Welch);
+    static_cast<void>(test.t());
+    static_cast<void>(test.t());
+
+    // the summaries are cached, so only the first t calculates them
+    EXPECT_EQ(2, Instrumentation::value(Instrumentation::Counter::SummariesCalculated));
+    EXPECT_EQ(2, Instrumentation::calls(Instrumentation::Phase::Statistic));
+    EXPECT_EQ(2, Instrumentation::calls(Instrumentation::Phase::Summary));
+}
+
+TEST_F(InstrumentationTest, testReport)
+{
+    static_cast<void>(DataFile<double>(m_path));
+    std::ostringstream out;
+    Instrumentation::report(out);
+    const auto report = out.str();
+
+    EXPECT_NE(std::string::npos, report.find("stats: rows parsed           3\n"));
+    EXPECT_NE(std::string::npos, report.find("stats: parse errors          1\n"));
+    EXPECT_NE(std::string::npos, report.find("stats: parse time"));
+
+    // phases that weren't entered are left out
+    EXPECT_EQ(std::string::npos, report.find("statistic time"));
+}
@@ -0,0 +1,96 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Kernels.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * The instruction sets to check against the scalar reference kernels.
+     */
+    constexpr const Kernels::InstructionSet VectorInstructionSets[] = {
+        Kernels::InstructionSet::Avx2,
+        Kernels::InstructionSet::Avx512,
+    };
+
+    /**
+     * Generate test values, with roughly one in ten missing.
+     *
+     * The lengths used in the tests are deliberately not multiples of any vector width so that the tail handling is exercised.
+     */
+    template<class T>
+    std::vector<T> testValues(std::size_t count, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<T> distribution(50.0, 10.0);
+        std::uniform_int_distribution<int> missing(0, 9);
+        std::vector<T> values(count);
+
+        for (auto & value : values) {
+            value = (0 == missing(rng) ? NAN : distribution(rng));
+        }
+
+        return values;
+    }
+
+    /**
+     * Check every supported vector instruction set against the scalar kernels for one value type.
+     */
+    template<class T>
+    void checkKernels(T relativeTolerance)
+    {
+        for (const std::size_t count : {0, 1, 3, 7, 15, 17, 31, 33, 100, 1001}) {
+            const auto first = testValues<T>(count, static_cast<unsigned int>(count));
+            const auto second = testValues<T>(count, static_cast<unsigned int>(count) + 1);
+            std::vector<T> dense(first.size());
+            std::transform(first.cbegin(), first.cend(), dense.begin(), [](T value) { return std::isnan(value) ? T(1) : value; });
+
+            const auto expectedSum = Kernels::Scalar::sum(first.data(), count);
+            const auto expectedSumSquares = Kernels::Scalar::sumSquares(first.data(), count);
+            const auto expectedDeviations = Kernels::Scalar::sumSquaredDeviations(first.data(), count, T(49.5));
+            const auto expectedDifferences = Kernels::Scalar::differenceSums(first.data(), second.data(), count);
+            std::size_t completePairs = 0;
+
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                completePairs += (!std::isnan(first[idx]) && !std::isnan(second[idx]) ? 1 : 0);
+            }
+
+            EXPECT_EQ(completePairs, expectedDifferences.count) << "count " << count;
+
+            for (const auto set : VectorInstructionSets) {
+                if (!Kernels::isSupported(set)) {
+                    continue;
+                }
+
+                EXPECT_NEAR(expectedSum, Kernels::sum(first.data(), count, set), std::abs(expectedSum) * relativeTolerance) << "count " << count;
+                EXPECT_NEAR(expectedSumSquares, Kernels::sumSquares(first.data(), count, set), expectedSumSquares * relativeTolerance) << "count " << count;
+                EXPECT_NEAR(expectedDeviations, Kernels::sumSquaredDeviations(first.data(), count, T(49.5), set), expectedDeviations * relativeTolerance) << "count " << count;
+
+                // both inputs have missing values, and the paired kernel skips a pair with either missing
+                const auto differences = Kernels::differenceSums(first.data(), second.data(), count, set);
+                EXPECT_EQ(expectedDifferences.count, differences.count) << "count " << count;
+                EXPECT_NEAR(expectedDifferences.sum, differences.sum, std::abs(expectedDifferences.sumSquares) * relativeTolerance) << "count " << count;
+                EXPECT_NEAR(expectedDifferences.sumSquares, differences.sumSquares, expectedDifferences.sumSquares * relativeTolerance) << "count " << count;
+
+                const auto denseDifferences = Kernels::differenceSums(dense.data(), dense.data(), count, set);
+                EXPECT_EQ(count, denseDifferences.count);
+                EXPECT_EQ(T(0), denseDifferences.sum);
+                EXPECT_EQ(T(0), denseDifferences.sumSquares);
+            }
+        }
+    }
+}
+
+TEST(KernelsTest, testDoubleKernelsMatchScalar)
+{
+    checkKernels<double>(1e-12);
+}
+
+TEST(KernelsTest, testFloatKernelsMatchScalar)
+{
+    checkKernels<float>(1e-4f);
+}
@@ -0,0 +1,243 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "PermutationTTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::loadData;
+
+namespace
+{
+    /**
+     * Convenience alias for the concrete type of the permutation test being tested.
+     */
+    using TestPermutationTTest = PermutationTTest<double>;
+
+    /**
+     * Paired test data: small enough that all 2^10 sign assignments can be enumerated by brute force.
+     */
+    const std::vector<std::vector<double>> PairedData = {
+        {12.1, 11.0}, {14.3, 13.9}, {11.8, 12.5}, {15.2, 13.1}, {13.0, 12.2},
+        {12.7, 12.9}, {16.1, 14.0}, {14.4, 13.2}, {13.3, 13.6}, {15.0, 13.8},
+    };
+
+    /**
+     * Unpaired test data: the first column has 5 values and the second 7, so there are C(12, 5) = 792 label assignments.
+     */
+    const std::vector<std::vector<double>> UnpairedData = {
+        {12.1, 14.0}, {14.3, 15.9}, {11.8, 13.5}, {13.2, 16.1}, {12.0, 14.2}, {NAN, 13.1}, {NAN, 17.0},
+    };
+
+    /**
+     * Calculate unpaired |t| directly from two groups of values, with the variance pooled (Student's test) or not (the other unpaired tests).
+     */
+    double unpairedT(const std::vector<double> & first, const std::vector<double> & second, bool pooled)
+    {
+        const auto moments = [](const std::vector<double> & values) {
+            double mean = 0;
+
+            for (const auto value : values) {
+                mean += value;
+            }
+
+            mean /= static_cast<double>(values.size());
+            double sumSquaredDeviations = 0;
+
+            for (const auto value : values) {
+                sumSquaredDeviations += (value - mean) * (value - mean);
+            }
+
+            return std::make_pair(mean, sumSquaredDeviations);
+        };
+
+        const auto [mean1, ssd1] = moments(first);
+        const auto [mean2, ssd2] = moments(second);
+        const auto n1 = static_cast<double>(first.size());
+        const auto n2 = static_cast<double>(second.size());
+        const auto standardError = (pooled
+            ? std::sqrt((ssd1 + ssd2) / (n1 + n2 - 2) * (1 / n1 + 1 / n2))
+            : std::sqrt(ssd1 / (n1 - 1) / n1 + ssd2 / (n2 - 1) / n2));
+        return std::abs(mean1 - mean2) / standardError;
+    }
+
+    /**
+     * Brute-force exact p-value for the paired test, enumerating every sign assignment.
+     */
+    double bruteForcePairedP()
+    {
+        std::vector<double> differences;
+
+        for (const auto & row : PairedData) {
+            differences.push_back(row[0] - row[1]);
+        }
+
+        const auto n = static_cast<double>(differences.size());
+
+        const auto t = [&differences, n](unsigned int signs) {
+            double sum = 0;
+            double sumSquares = 0;
+
+            for (std::size_t idx = 0; idx < differences.size(); ++idx) {
+                const auto difference = ((signs >> idx) & 1U) ? -differences[idx] : differences[idx];
+                sum += difference;
+                sumSquares += difference * difference;
+            }
+
+            return std::abs(sum / n) / std::sqrt((sumSquares - sum * sum / n) / (n - 1) / n);
+        };
+
+        const auto observed = t(0);
+        const auto total = 1U << differences.size();
+        unsigned int extreme = 0;
+
+        for (unsigned int signs = 0; signs < total; ++signs) {
+            extreme += (t(signs) >= observed * (1 - 1e-9));
+        }
+
+        return static_cast<double>(extreme) / total;
+    }
+
+    /**
+     * Brute-force exact p-value for the unpaired test, enumerating every assignment of labels.
+     */
+    double bruteForceUnpairedP(bool pooled)
+    {
+        std::vector<double> values;
+        std::size_t n1 = 0;
+
+        for (std::size_t col = 0; col < 2; ++col) {
+            for (const auto & row : UnpairedData) {
+                if (!std::isnan(row[col])) {
+                    values.push_back(row[col]);
+                }
+            }
+
+            if (0 == col) {
+                n1 = values.size();
+            }
+        }
+
+        const auto t = [&values, pooled](unsigned int mask) {
+            std::vector<double> first;
+            std::vector<double> second;
+
+            for (std::size_t idx = 0; idx < values.size(); ++idx) {
+                (((mask >> idx) & 1U) ? first : second).push_back(values[idx]);
+            }
+
+            return unpairedT(first, second, pooled);
+        };
+
+        const auto observed = t((1U << n1) - 1);
+        unsigned int total = 0;
+        unsigned int extreme = 0;
+
+        for (unsigned int mask = 0; mask < (1U << values.size()); ++mask) {
+            if (static_cast<std::size_t>(__builtin_popcount(mask)) != n1) {
+                continue;
+            }
+
+            ++total;
+            extreme += (t(mask) >= observed * (1 - 1e-9));
+        }
+
+        return static_cast<double>(extreme) / total;
+    }
+}
+
+TEST(PermutationTTestTest, testExactPaired)
+{
+    const TestPermutationTTest test(loadData(PairedData), TTestType::Paired);
+    PermutationOptions options;
+    options.mode = PermutationMode::Exact;
+    options.threads = 3;
+    const auto result = test.run(options);
+
+    EXPECT_TRUE(result.exact);
+    EXPECT_EQ(1024U, result.permutations);
+    EXPECT_DOUBLE_EQ(bruteForcePairedP(), result.p);
+    EXPECT_NEAR(TTest<double>(loadData(PairedData), TTestType::Paired).t(), result.t, 1e-12);
+}
+
+TEST(PermutationTTestTest, testExactUnpaired)
+{
+    for (const auto type : {TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        const TestPermutationTTest test(loadData(UnpairedData), type);
+        PermutationOptions options;
+        options.mode = PermutationMode::Exact;
+        const auto result = test.run(options);
+
+        EXPECT_TRUE(result.exact);
+        EXPECT_EQ(792U, result.permutations);
+        EXPECT_DOUBLE_EQ(bruteForceUnpairedP(TTestType::Student == type), result.p);
+        EXPECT_NEAR(TTest<double>(loadData(UnpairedData), type).t(), result.t, 1e-12);
+    }
+}
+
+TEST(PermutationTTestTest, testAutoModeChoosesExact)
+{
+    const TestPermutationTTest test(loadData(UnpairedData), TTestType::Unpaired);
+    PermutationOptions options;
+    options.exactLimit = 792;
+    EXPECT_TRUE(test.run(options).exact);
+
+    options.exactLimit = 791;
+    EXPECT_FALSE(test.run(options).exact);
+}
+
+TEST(PermutationTTestTest, testMonteCarloApproximatesExact)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        const TestPermutationTTest test(loadData(TTestType::Paired == type ? PairedData : UnpairedData), type);
+        PermutationOptions options;
+        options.mode = PermutationMode::MonteCarlo;
+        options.permutations = 50000;
+        options.seed = 7;
+        const auto result = test.run(options);
+        const auto exact = (TTestType::Paired == type ? bruteForcePairedP() : bruteForceUnpairedP(TTestType::Student == type));
+
+        EXPECT_FALSE(result.exact);
+        EXPECT_EQ(options.permutations, result.permutations);
+        EXPECT_NEAR(exact, result.p, result.halfWidth);
+    }
+}
+
+TEST(PermutationTTestTest, testMonteCarloIsIndependentOfThreadCount)
+{
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired}) {
+        const TestPermutationTTest test(loadData(TTestType::Paired == type ? PairedData : UnpairedData), type);
+        PermutationOptions options;
+        options.mode = PermutationMode::MonteCarlo;
+        options.permutations = 10001;
+        options.seed = 42;
+        options.threads = 1;
+        const auto expected = test.run(options);
+        options.threads = 4;
+        const auto actual = test.run(options);
+
+        EXPECT_EQ(expected.extreme, actual.extreme);
+        EXPECT_EQ(expected.permutations, actual.permutations);
+        EXPECT_EQ(expected.p, actual.p);
+    }
+}
+
+TEST(PermutationTTestTest, testEarlyStopping)
+{
+    const TestPermutationTTest test(loadData(UnpairedData), TTestType::Unpaired);
+    PermutationOptions options;
+    options.mode = PermutationMode::MonteCarlo;
+    options.permutations = 1000000;
+    options.tolerance = 0.01;
+    const auto result = test.run(options);
+
+    EXPECT_LT(result.permutations, options.permutations);
+    EXPECT_LE(result.halfWidth, 0.01);
+}
+
+TEST(PermutationTTestTest, testTooFewValues)
+{
+    const TestPermutationTTest test(loadData({{1.0, 2.0}}), TTestType::Unpaired);
+    EXPECT_TRUE(std::isnan(test.run().p));
+}
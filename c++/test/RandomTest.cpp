@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Random.h"
+
+using namespace Statistics;
+
+TEST(RandomTest, testPhiloxKnownAnswers)
+{
+    // known-answer vectors from the Random123 distribution
+    EXPECT_EQ((Philox4x32::Counter{0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U}), Philox4x32::block({0, 0, 0, 0}, {0, 0}));
+    EXPECT_EQ((Philox4x32::Counter{0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU}),
+              Philox4x32::block({0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU}, {0xffffffffU, 0xffffffffU}));
+    EXPECT_EQ((Philox4x32::Counter{0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U}),
+              Philox4x32::block({0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U}, {0xa4093822U, 0x299f31d0U}));
+}
+
+TEST(RandomTest, testPhiloxStream)
+{
+    Philox4x32 rng(0x0123456789abcdefULL, 7);
+    std::vector<std::uint32_t> values;
+
+    for (int idx = 0; idx < 10; ++idx) {
+        values.push_back(rng());
+    }
+
+    // the stream is the blocks for successive counters, with the stream number in the upper half of the counter and the seed as the key
+    const auto first = Philox4x32::block({0, 0, 7, 0}, {0x89abcdefU, 0x01234567U});
+    const auto second = Philox4x32::block({1, 0, 7, 0}, {0x89abcdefU, 0x01234567U});
+    EXPECT_EQ(first[0], values[0]);
+    EXPECT_EQ(first[3], values[3]);
+    EXPECT_EQ(second[0], values[4]);
+
+    // skipping ahead gives the same values as stepping through them
+    for (std::uint64_t skip : {0, 1, 3, 4, 5}) {
+        Philox4x32 skipped(0x0123456789abcdefULL, 7);
+        skipped();
+        skipped.discard(skip);
+        EXPECT_EQ(values[1 + skip], skipped()) << "skip = " << skip;
+    }
+
+    EXPECT_NE(values[0], Philox4x32(0x0123456789abcdefULL, 8)());
+}
+
+TEST(RandomTest, testXoshiroBelow)
+{
+    Xoshiro256StarStar rng(1, 2);
+    std::vector<int> counts(5, 0);
+
+    for (int idx = 0; idx < 50000; ++idx) {
+        const auto value = rng.below(5);
+        ASSERT_LT(value, 5U);
+        ++counts[value];
+    }
+
+    for (const auto count : counts) {
+        EXPECT_NEAR(10000, count, 500);
+    }
+
+    EXPECT_NE(Xoshiro256StarStar(1, 2)(), Xoshiro256StarStar(1, 3)());
+    EXPECT_EQ(Xoshiro256StarStar(1, 2)(), Xoshiro256StarStar(1, 2)());
+}
+
+TEST(RandomTest, testPhiloxIndices)
+{
+    const Philox4x32::Counter counter = {0xfffffff0U, 3, 5, 0};
+    const Philox4x32::Key key = {11, 13};
+
+    for (const std::uint32_t bound : {1U, 2U, 7U, 1000003U, 0xffffffffU}) {
+        // an odd number of blocks beyond a multiple of the vector width, so the vectorised kernels finish with the scalar one
+        std::vector<std::uint32_t> expected(202);
+        Philox4x32::indices(counter, key, bound, expected.data(), expected.size(), Kernels::InstructionSet::Scalar);
+
+        for (std::size_t idx = 0; idx < expected.size(); idx += 2) {
+            auto blockCounter = counter;
+            blockCounter[0] += static_cast<std::uint32_t>(idx / 2);
+            const auto block = Philox4x32::block(blockCounter, key);
+            ASSERT_EQ(static_cast<std::uint32_t>(((static_cast<std::uint64_t>(block[0]) << 32 | block[1]) * static_cast<unsigned __int128>(bound)) >> 64), expected[idx]);
+            ASSERT_LT(expected[idx + 1], bound);
+        }
+
+        for (const auto set : {Kernels::InstructionSet::Avx2, Kernels::InstructionSet::Avx512}) {
+            if (!Kernels::isSupported(set)) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> actual(expected.size());
+            Philox4x32::indices(counter, key, bound, actual.data(), actual.size(), set);
+            EXPECT_EQ(expected, actual) << "bound = " << bound << ", instruction set = " << static_cast<int>(set);
+        }
+    }
+}
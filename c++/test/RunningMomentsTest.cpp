@@ -0,0 +1,135 @@
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "RunningMoments.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Test values, including missing ones.
+     */
+    const std::vector<double> TestValues = {3.5, 1.25, NAN, 9.0, 4.75, -2.5, NAN, 7.125, 0.5};
+
+    /**
+     * Calculate the mean and the sum of squared deviations from it in two passes, skipping NaN values.
+     */
+    std::pair<double, double> twoPassMoments(const std::vector<double> & values)
+    {
+        double sum = 0;
+        double count = 0;
+
+        for (const auto value : values) {
+            if (!std::isnan(value)) {
+                sum += value;
+                ++count;
+            }
+        }
+
+        const auto mean = sum / count;
+        double sumSquaredDeviations = 0;
+
+        for (const auto value : values) {
+            if (!std::isnan(value)) {
+                sumSquaredDeviations += (value - mean) * (value - mean);
+            }
+        }
+
+        return {mean, sumSquaredDeviations};
+    }
+}
+
+TEST(RunningMomentsTest, testAddMatchesTwoPass)
+{
+    RunningMoments<double> moments;
+    EXPECT_EQ(0, moments.count());
+    EXPECT_EQ(0.0, moments.mean());
+    EXPECT_TRUE(std::isnan(moments.variance()));
+
+    for (const auto value : TestValues) {
+        moments.add(value);
+    }
+
+    const auto [mean, sumSquaredDeviations] = twoPassMoments(TestValues);
+    EXPECT_EQ(7, moments.count());
+    EXPECT_NEAR(mean, moments.mean(), 1e-12);
+    EXPECT_NEAR(mean * 7, moments.sum(), 1e-12);
+    EXPECT_NEAR(sumSquaredDeviations, moments.sumSquaredDeviations(), 1e-12);
+    EXPECT_NEAR(sumSquaredDeviations / 6, moments.variance(), 1e-12);
+
+    // one value has a mean but no variance
+    RunningMoments<double> single;
+    single.add(2.5);
+    EXPECT_EQ(2.5, single.mean());
+    EXPECT_TRUE(std::isnan(single.variance()));
+}
+
+TEST(RunningMomentsTest, testLargeOffsetIsStable)
+{
+    // the naive sum-of-squares formula loses every significant digit of the variance here
+    RunningMoments<double> moments;
+
+    for (const auto value : {4.0, 7.0, 13.0, 16.0}) {
+        moments.add(1e9 + value);
+    }
+
+    EXPECT_EQ(1e9 + 10.0, moments.mean());
+    EXPECT_NEAR(30.0, moments.variance(), 1e-6);
+}
+
+TEST(RunningMomentsTest, testMergeMatchesSingleAccumulator)
+{
+    RunningMoments<double> expected;
+    RunningMoments<double> first;
+    RunningMoments<double> second;
+
+    for (std::size_t idx = 0; idx < TestValues.size(); ++idx) {
+        expected.add(TestValues[idx]);
+        (idx < 4 ? first : second).add(TestValues[idx]);
+    }
+
+    first.merge(second);
+    EXPECT_EQ(expected.count(), first.count());
+    EXPECT_NEAR(expected.mean(), first.mean(), 1e-12);
+    EXPECT_NEAR(expected.sumSquaredDeviations(), first.sumSquaredDeviations(), 1e-12);
+
+    // merging with nothing, either way round, is a copy
+    RunningMoments<double> empty;
+    empty.merge(first);
+    EXPECT_EQ(first.count(), empty.count());
+    EXPECT_EQ(first.mean(), empty.mean());
+    first.merge(RunningMoments<double>());
+    EXPECT_EQ(expected.count(), first.count());
+}
+
+TEST(RunningMomentsTest, testRemove)
+{
+    RunningMoments<double> moments;
+    RunningMoments<double> expected;
+
+    for (const auto value : {3.5, 1.25, 9.0, 4.75}) {
+        moments.add(value);
+    }
+
+    moments.remove(9.0);
+    moments.remove(1.25);
+    moments.remove(NAN);
+    expected.add(3.5);
+    expected.add(4.75);
+
+    EXPECT_EQ(2U, moments.count());
+    EXPECT_NEAR(expected.mean(), moments.mean(), 1e-12);
+    EXPECT_NEAR(expected.variance(), moments.variance(), 1e-12);
+
+    moments.remove(3.5);
+    EXPECT_EQ(1U, moments.count());
+    EXPECT_EQ(4.75, moments.mean());
+    EXPECT_EQ(0.0, moments.sumSquaredDeviations());
+
+    moments.remove(4.75);
+    EXPECT_EQ(0U, moments.count());
+    EXPECT_EQ(0.0, moments.mean());
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "TTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::toCsv;
+using TestFiles::writeTemporaryCsv;
+
+namespace
+{
+    /**
+     * Convenience alias for the concrete type of the streaming test being tested.
+     */
+    using TestStreamingTTest = StreamingTTest<double>;
+
+    /**
+     * Test data with cells missing from either column, so some rows are incomplete pairs.
+     */
+    const std::vector<std::vector<double>> TestData = {
+        {12.1, 11.0}, {14.3, NAN}, {11.8, 12.5}, {NAN, 13.1}, {13.0, 12.2},
+        {12.7, 12.9}, {16.1, 14.0}, {NAN, NAN}, {13.3, 13.6}, {15.0, 13.8, 99.0}, {14.2, NAN},
+    };
+
+    /**
+     * Assert that two results match to within rounding.
+     */
+    void expectResultsMatch(const TTestResult<double> & expected, const TTestResult<double> & actual)
+    {
+        EXPECT_NEAR(expected.t, actual.t, 1e-9);
+        EXPECT_NEAR(expected.degreesOfFreedom, actual.degreesOfFreedom, 1e-9);
+        EXPECT_NEAR(expected.twoTailedP, actual.twoTailedP, 1e-9);
+    }
+}
+
+TEST(StreamingTTestTest, testReadMatchesTTest)
+{
+    const auto path = writeTemporaryCsv(TestData);
+    const TTest<double>::DataFileType data(path);
+    TestStreamingTTest test;
+    ASSERT_TRUE(test.read(path));
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(9, test.moments1().count());
+    EXPECT_EQ(8, test.moments2().count());
+    EXPECT_EQ(7, test.differenceMoments().count());
+
+    for (const auto type : {TTestType::Paired, TTestType::Unpaired, TTestType::Welch, TTestType::Student}) {
+        test.setType(type);
+        const TTest<double> expected(data, type);
+        expectResultsMatch(expected.result(), test.result());
+        EXPECT_NEAR(expected.t(), test.t(), 1e-9);
+    }
+}
+
+TEST(StreamingTTestTest, testReadStream)
+{
+    std::istringstream in(toCsv(TestData));
+    TestStreamingTTest expected;
+
+    for (const auto & row : TestData) {
+        expected.addRow(row[0], row[1]);
+    }
+
+    TestStreamingTTest test;
+    test.read(in);
+    EXPECT_EQ(expected.differenceMoments().count(), test.differenceMoments().count());
+    EXPECT_EQ(expected.t(), test.t());
+}
+
+TEST(StreamingTTestTest, testHeaderAndDialect)
+{
+    std::istringstream comma("before,after\n" + toCsv(TestData));
+    TestStreamingTTest expected;
+    expected.read(comma);
+
+    auto content = "\"before\";\"after\"\n" + toCsv(TestData);
+    std::replace(content.begin(), content.end(), ',', ';');
+    std::istringstream semicolon(content);
+    TestStreamingTTest test(TTestType::Paired, {';', '"'});
+    test.read(semicolon);
+
+    EXPECT_EQ(7, test.differenceMoments().count());
+    EXPECT_EQ(expected.t(), test.t());
+
+    // read as CSV, each line is a single cell that isn't a number
+    std::istringstream wrongDialect(content);
+    TestStreamingTTest commaTest;
+    commaTest.read(wrongDialect);
+    EXPECT_EQ(0, commaTest.moments1().count());
+}
+
+TEST(StreamingTTestTest, testRemoveRowReversesAddRow)
+{
+    TestStreamingTTest test(TTestType::Welch);
+    TestStreamingTTest expected(TTestType::Welch);
+
+    for (const auto & row : TestData) {
+        test.addRow(row[0], row[1]);
+        expected.addRow(row[0], row[1]);
+    }
+
+    test.addRow(40.0, NAN);
+    test.addRow(1.0, 2.0);
+    test.removeRow(40.0, NAN);
+    test.removeRow(1.0, 2.0);
+    expectResultsMatch(expected.result(), test.result());
+    EXPECT_EQ(expected.differenceMoments().count(), test.differenceMoments().count());
+
+    test.reset();
+    EXPECT_EQ(0, test.moments1().count());
+    EXPECT_EQ(0, test.differenceMoments().count());
+}
+
+TEST(StreamingTTestTest, testMissingFile)
+{
+    TestStreamingTTest test;
+    EXPECT_FALSE(test.read(TestFiles::temporaryPath()));
+    EXPECT_EQ(0, test.moments1().count());
+}
@@ -0,0 +1,204 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <gtest/gtest.h>
+
+#include "DataFile.h"
+#include "RunningMoments.h"
+#include "SyntheticData.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::temporaryPath;
+
+namespace
+{
+    /**
+     * Generate the CSV for some options.
+     */
+    std::string csv(const SyntheticDataOptions & options)
+    {
+        std::ostringstream out;
+        EXPECT_TRUE(SyntheticData(options).writeCsv(out));
+        return out.str();
+    }
+
+    /**
+     * Assert that data mapped from a generated cache is identical to the data parsed from the generated CSV.
+     */
+    template<class T>
+    void expectCacheMatchesCsv(const SyntheticDataOptions & options)
+    {
+        const auto path = temporaryPath();
+        const auto cachePath = Cache::defaultPath<T>(path);
+        ASSERT_TRUE(SyntheticData(options).writeCsvAndCache<T>(path));
+
+        const DataFile<T> cached(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Read});
+        const DataFile<T> parsed(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Off});
+        EXPECT_TRUE(cached.isFromCache());
+        ASSERT_EQ(parsed.rowCount(), cached.rowCount());
+        ASSERT_EQ(parsed.columnCount(), cached.columnCount());
+
+        for (long col = 0; col < parsed.columnCount(); ++col) {
+            const auto & expected = parsed.column(col);
+            const auto & actual = cached.column(col);
+
+            for (std::size_t row = 0; row < expected.size(); ++row) {
+                ASSERT_EQ(expected.isValid(row), actual.isValid(row)) << "Validity of R" << row << ", C" << col << " differs";
+
+                if (expected.isValid(row)) {
+                    ASSERT_EQ(expected[row], actual[row]) << "Item at R" << row << ", C" << col << " differs";
+                }
+            }
+        }
+
+        // the cache also records where the final line is, so the data can be refreshed
+        std::ofstream(path, std::ios::binary | std::ios::app) << "5";
+        auto refreshed = DataFile<T>(path, LoadOptions{LoadMode::Mapped, 1, CacheMode::Off});
+        auto data = cached;
+        data.refresh();
+        EXPECT_EQ(refreshed.rowCount(), data.rowCount());
+        EXPECT_EQ(refreshed.columnItemCount(0), data.columnItemCount(0));
+        EXPECT_EQ(refreshed.columnSum(0), data.columnSum(0));
+
+        std::filesystem::remove(cachePath);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(SyntheticDataTest, testIndependentOfThreadCount)
+{
+    // more than one block, so that the blocks are generated concurrently
+    SyntheticDataOptions options;
+    options.rows = SyntheticData::BlockRows * 2 + 123;
+    options.columns = 3;
+    options.missing = 0.1;
+    options.ragged = 0.1;
+    options.seed = 42;
+    options.threads = 1;
+    const auto expected = csv(options);
+
+    options.threads = 3;
+    EXPECT_EQ(expected, csv(options));
+
+    options.seed = 43;
+    EXPECT_NE(expected, csv(options));
+}
+
+TEST(SyntheticDataTest, testCsvMatchesValues)
+{
+    SyntheticDataOptions options;
+    options.rows = 500;
+    options.columns = 4;
+    options.missing = 0.2;
+    options.ragged = 0.3;
+    options.precision = 4;
+    const SyntheticData data(options);
+    const auto path = temporaryPath();
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << csv(options);
+    const DataFile<double> parsed(path);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(500, parsed.rowCount());
+    ASSERT_EQ(4, parsed.columnCount());
+
+    for (std::uint64_t row = 0; row < options.rows; ++row) {
+        for (std::uint32_t col = 0; col < options.columns; ++col) {
+            const auto expected = data.value(row, col);
+
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(parsed.item(static_cast<long>(row), col)));
+            } else {
+                EXPECT_NEAR(expected, parsed.item(static_cast<long>(row), col), 0.5e-4);
+            }
+        }
+    }
+}
+
+TEST(SyntheticDataTest, testCacheMatchesCsv)
+{
+    SyntheticDataOptions options;
+    options.rows = SyntheticData::BlockRows + 1000;
+    options.columns = 3;
+    options.missing = 0.05;
+    options.ragged = 0.05;
+    options.threads = 2;
+    expectCacheMatchesCsv<double>(options);
+    expectCacheMatchesCsv<float>(options);
+
+    options.rows = 1;
+    expectCacheMatchesCsv<long double>(options);
+}
+
+TEST(SyntheticDataTest, testMissingAndRaggedDensity)
+{
+    SyntheticDataOptions options;
+    options.rows = 20000;
+    options.columns = 5;
+    options.missing = 0.25;
+    options.ragged = 0.1;
+    const SyntheticData data(options);
+    std::uint64_t shortRows = 0;
+    std::uint64_t cells = 0;
+    std::uint64_t missingCells = 0;
+
+    for (std::uint64_t row = 0; row < options.rows; ++row) {
+        const auto width = data.rowWidth(row);
+        EXPECT_LE(1U, width);
+        EXPECT_GE(options.columns, width);
+        shortRows += (width < options.columns);
+
+        for (std::uint32_t col = 0; col < width; ++col) {
+            ++cells;
+            missingCells += std::isnan(data.value(row, col));
+        }
+    }
+
+    EXPECT_EQ(options.columns, data.rowWidth(0));
+    EXPECT_NEAR(0.1, static_cast<double>(shortRows) / options.rows, 0.01);
+    EXPECT_NEAR(0.25, static_cast<double>(missingCells) / cells, 0.01);
+}
+
+TEST(SyntheticDataTest, testDistributions)
+{
+    SyntheticDataOptions options;
+    options.rows = 100000;
+    options.columns = 2;
+    options.location = 10.0;
+    options.scale = 2.0;
+    options.shift = 5.0;
+
+    const auto moments = [&options](SyntheticDistribution distribution) {
+        options.distribution = distribution;
+        const SyntheticData data(options);
+        RunningMoments<double> first;
+        RunningMoments<double> second;
+        double min = INFINITY;
+
+        for (std::uint64_t row = 0; row < options.rows; ++row) {
+            first.add(data.value(row, 0));
+            second.add(data.value(row, 1));
+            min = std::min(min, data.value(row, 0));
+        }
+
+        EXPECT_NEAR(5.0, second.mean() - first.mean(), 0.05);
+        return std::make_tuple(first.mean(), std::sqrt(first.variance()), min);
+    };
+
+    const auto [normalMean, normalSd, normalMin] = moments(SyntheticDistribution::Normal);
+    EXPECT_NEAR(10.0, normalMean, 0.03);
+    EXPECT_NEAR(2.0, normalSd, 0.03);
+
+    const auto [uniformMean, uniformSd, uniformMin] = moments(SyntheticDistribution::Uniform);
+    EXPECT_NEAR(11.0, uniformMean, 0.03);
+    EXPECT_NEAR(2.0 / std::sqrt(12.0), uniformSd, 0.01);
+    EXPECT_LE(10.0, uniformMin);
+
+    const auto [exponentialMean, exponentialSd, exponentialMin] = moments(SyntheticDistribution::Exponential);
+    EXPECT_NEAR(12.0, exponentialMean, 0.03);
+    EXPECT_NEAR(2.0, exponentialSd, 0.05);
+    EXPECT_LE(10.0, exponentialMin);
+}
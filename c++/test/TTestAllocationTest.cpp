@@ -0,0 +1,163 @@
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "TTest.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * The number of heap allocations made by the process so far.
+     */
+    std::atomic<std::size_t> allocationCount(0);
+
+    /**
+     * Helper for the replacement allocation functions.
+     */
+    void * countedAllocation(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        // aligned_alloc() requires the size to be a multiple of the alignment
+        size = (0 == size ? alignment : (size + alignment - 1) / alignment * alignment);
+        void * ptr = std::aligned_alloc(alignment, size);
+
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+}
+
+void * operator new(std::size_t size)
+{
+    return countedAllocation(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return countedAllocation(size);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocation(size, static_cast<std::size_t>(alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocation(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    /**
+     * Convenience alias for the t-test being tested.
+     */
+    using TestTTest = TTest<long double>;
+
+    /**
+     * The number of times t is calculated when checking for allocations.
+     */
+    constexpr const int Repetitions = 100;
+
+    /**
+     * Test fixture providing a t-test with a few thousand rows of paired data.
+     */
+    class TTestAllocationTest : public ::testing::Test
+    {
+        protected:
+            void SetUp() override
+            {
+                m_path = (std::filesystem::temp_directory_path() / "t-test-allocation-test.csv").string();
+                std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+
+                for (int row = 0; row < 5000; ++row) {
+                    out << (0 == row ? "" : "\n") << (10.0 + (row % 17) * 0.25) << "," << (11.0 + (row % 13) * 0.5);
+                }
+            }
+
+            void TearDown() override
+            {
+                std::filesystem::remove(m_path);
+            }
+
+            /**
+             * Count the heap allocations made while calculating t repeatedly, once the test is warmed up.
+             */
+            [[nodiscard]] std::size_t steadyStateAllocations(const TTestType & type) const
+            {
+                const TestTTest test(TestTTest::DataFileType(m_path), type);
+
+                // warm up: anything allocated lazily on first use doesn't count
+                volatile auto t = test.t();
+                const auto before = allocationCount.load();
+
+                for (int idx = 0; idx < Repetitions; ++idx) {
+                    t = test.t();
+                }
+
+                static_cast<void>(t);
+                return allocationCount.load() - before;
+            }
+
+            std::string m_path;
+    };
+}
+
+TEST_F(TTestAllocationTest, testPairedTDoesNotAllocate)
+{
+    EXPECT_EQ(0, steadyStateAllocations(TTestType::Paired));
+}
+
+TEST_F(TTestAllocationTest, testUnpairedTDoesNotAllocate)
+{
+    EXPECT_EQ(0, steadyStateAllocations(TTestType::Unpaired));
+}
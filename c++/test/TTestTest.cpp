@@ -0,0 +1,138 @@
+#include <cmath>
+#include <filesystem>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Accumulators.h"
+#include "TTest.h"
+#include "TestFiles.h"
+
+using namespace Statistics;
+using TestFiles::writeTemporaryCsv;
+
+namespace
+{
+    /**
+     * Paired data with a gap in the first column near the start, so the first column has fewer items than there are complete pairs after the gap.
+     */
+    const std::vector<std::vector<double>> LeadingGapData = {
+        {NAN, 1.0}, {2.0, 1.5}, {4.0, 2.0}, {3.5, 3.0}, {5.0, 3.5}, {7.0, 4.0}, {6.5, 6.0},
+    };
+
+    /**
+     * Calculate paired t from the complete pairs in some rows in two passes.
+     */
+    double twoPassPairedT(const std::vector<std::vector<double>> & rows)
+    {
+        std::vector<double> differences;
+
+        for (const auto & row : rows) {
+            if (!std::isnan(row[0]) && !std::isnan(row[1])) {
+                differences.push_back(row[0] - row[1]);
+            }
+        }
+
+        const auto n = static_cast<double>(differences.size());
+        double mean = 0;
+
+        for (const auto difference : differences) {
+            mean += difference / n;
+        }
+
+        double sumSquaredDeviations = 0;
+
+        for (const auto difference : differences) {
+            sumSquaredDeviations += (difference - mean) * (difference - mean);
+        }
+
+        return mean * std::sqrt(n) / std::sqrt(sumSquaredDeviations / (n - 1));
+    }
+
+    /**
+     * Check that the paired test for some rows uses every complete pair, whatever the accumulator.
+     *
+     * @tparam TestClass The TTest instantiation to check.
+     */
+    template<class TestClass>
+    void expectAllCompletePairs(const std::vector<std::vector<double>> & rows, std::size_t completePairs)
+    {
+        const auto path = writeTemporaryCsv(rows);
+        const auto result = TestClass(typename TestClass::DataFileType(path), TTestType::Paired).result();
+        std::filesystem::remove(path);
+
+        EXPECT_NEAR(static_cast<double>(completePairs - 1), static_cast<double>(result.degreesOfFreedom), 1e-12);
+        EXPECT_NEAR(std::abs(twoPassPairedT(rows)), static_cast<double>(result.t), 1e-9);
+    }
+}
+
+TEST(TTestTest, testPairedLeadingGapKeepsTrailingPairs)
+{
+    // the first column has 6 items, but all 6 complete pairs run to the last row
+    expectAllCompletePairs<TTest<long double>>(LeadingGapData, 6);
+    expectAllCompletePairs<TTest<double, PairwiseSum<double>>>(LeadingGapData, 6);
+}
+
+TEST(TTestTest, testPairedSkipsIncompletePairs)
+{
+    const std::vector<std::vector<double>> rows = {
+        {12.1, 11.0}, {14.3, NAN}, {11.8, 12.5}, {NAN, 13.1}, {13.0, 12.2}, {12.7, 12.9}, {16.1, 14.0}, {NAN, NAN}, {13.3, 13.6},
+    };
+
+    expectAllCompletePairs<TTest<long double>>(rows, 6);
+    expectAllCompletePairs<TTest<double, PairwiseSum<double>>>(rows, 6);
+}
+
+TEST(TTestTest, testUnpairedAndStudentDifferForUnequalGroups)
+{
+    // four values with a small spread against nine with a large one, so pooling the variance makes a clear difference
+    const std::vector<double> first = {10.1, 10.4, 9.8, 10.2};
+    const std::vector<double> second = {8.0, 13.5, 6.2, 14.9, 9.1, 12.7, 5.4, 15.8, 7.3};
+    std::vector<std::vector<double>> rows;
+
+    for (std::size_t row = 0; row < second.size(); ++row) {
+        rows.push_back({row < first.size() ? first[row] : NAN, second[row]});
+    }
+
+    const auto moments = [](const std::vector<double> & values) {
+        double mean = 0;
+
+        for (const auto value : values) {
+            mean += value / static_cast<double>(values.size());
+        }
+
+        double sumSquaredDeviations = 0;
+
+        for (const auto value : values) {
+            sumSquaredDeviations += (value - mean) * (value - mean);
+        }
+
+        return std::make_pair(mean, sumSquaredDeviations);
+    };
+
+    const auto [mean1, ssd1] = moments(first);
+    const auto [mean2, ssd2] = moments(second);
+    const auto n1 = static_cast<double>(first.size());
+    const auto n2 = static_cast<double>(second.size());
+    const auto unpooledT = std::abs(mean1 - mean2) / std::sqrt(ssd1 / (n1 - 1) / n1 + ssd2 / (n2 - 1) / n2);
+    const auto pooledT = std::abs(mean1 - mean2) / std::sqrt((ssd1 + ssd2) / (n1 + n2 - 2) * (1 / n1 + 1 / n2));
+
+    const auto path = writeTemporaryCsv(rows);
+    const TTest<double>::DataFileType data(path);
+    std::filesystem::remove(path);
+    const auto unpaired = TTest<double>(data, TTestType::Unpaired).result();
+    const auto welch = TTest<double>(data, TTestType::Welch).result();
+    const auto student = TTest<double>(data, TTestType::Student).result();
+
+    // Unpaired keeps the unpooled statistic, with n1 + n2 - 2 degrees of freedom
+    EXPECT_NEAR(unpooledT, unpaired.t, 1e-12);
+    EXPECT_NEAR(11.0, unpaired.degreesOfFreedom, 1e-12);
+
+    // Welch's test has the same statistic but fewer degrees of freedom
+    EXPECT_NEAR(unpooledT, welch.t, 1e-12);
+    EXPECT_LT(welch.degreesOfFreedom, 11.0);
+
+    // Student's test pools the variance, which weights the larger, more spread group more heavily and so gives a noticeably smaller t
+    EXPECT_NEAR(pooledT, student.t, 1e-12);
+    EXPECT_NEAR(11.0, student.degreesOfFreedom, 1e-12);
+    EXPECT_GT(unpaired.t, 1.2 * student.t);
+}
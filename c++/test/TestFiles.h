@@ -0,0 +1,98 @@
+#ifndef STATISTICS_TEST_TESTFILES_H
+#define STATISTICS_TEST_TESTFILES_H
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DataFile.h"
+
+/**
+ * Temporary files of test data, shared by the test suites.
+ */
+namespace TestFiles
+{
+    /**
+     * Fetch a path for a new temporary file.
+     *
+     * Every call gives a different path, whichever suite it comes from.
+     *
+     * @param extension The extension for the file, including the dot.
+     */
+    inline std::string temporaryPath(const std::string & extension = ".csv")
+    {
+        static int fileNumber = 0;
+        return (std::filesystem::temp_directory_path() / ("t-test-test-" + std::to_string(fileNumber++) + extension)).string();
+    }
+
+    /**
+     * Format rows of values as CSV. NaN values are written as empty cells.
+     *
+     * Values are written with enough digits to parse back to the same double.
+     *
+     * @param rows The rows. They need not all be the same width.
+     */
+    template<class T = double>
+    std::string toCsv(const std::vector<std::vector<T>> & rows)
+    {
+        std::ostringstream csv;
+        csv.precision(17);
+
+        for (std::size_t row = 0; row < rows.size(); ++row) {
+            csv << (0 < row ? "\n" : "");
+
+            for (std::size_t col = 0; col < rows[row].size(); ++col) {
+                csv << (0 < col ? "," : "");
+
+                if (!std::isnan(rows[row][col])) {
+                    csv << rows[row][col];
+                }
+            }
+        }
+
+        return csv.str();
+    }
+
+    /**
+     * Write some content to a new temporary file.
+     *
+     * @param content The content to write.
+     * @return The path to the file.
+     */
+    inline std::string writeTemporaryFile(const std::string & content)
+    {
+        auto path = temporaryPath();
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        return path;
+    }
+
+    /**
+     * Write rows of values to a new temporary CSV file. See toCsv().
+     *
+     * @return The path to the file.
+     */
+    template<class T = double>
+    std::string writeTemporaryCsv(const std::vector<std::vector<T>> & rows)
+    {
+        return writeTemporaryFile(toCsv(rows));
+    }
+
+    /**
+     * Load rows of values into a DataFile, by way of a temporary file that is removed again.
+     *
+     * @tparam DataFileType The type of DataFile to load.
+     */
+    template<class DataFileType = Statistics::DataFile<double>>
+    DataFileType loadData(const std::vector<std::vector<double>> & rows)
+    {
+        const auto path = writeTemporaryCsv(rows);
+        auto data = DataFileType(path);
+        std::filesystem::remove(path);
+        return data;
+    }
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "DataFile.h"
+
+using namespace Statistics;
+
+namespace
+{
+    /**
+     * Build a column of 200 cells in which every cell whose index is a multiple of 3 or 7 is empty, and the others hold their index.
+     */
+    Column<double> testColumn()
+    {
+        Column<double> column;
+
+        for (int idx = 0; idx < 200; ++idx) {
+            if (0 == idx % 3 || 0 == idx % 7) {
+                column.appendMissing();
+            } else {
+                column.append(idx);
+            }
+        }
+
+        return column;
+    }
+}
+
+TEST(ColumnViewTest, testMatchesColumn)
+{
+    const auto column = testColumn();
+    const auto view = column.view();
+
+    ASSERT_EQ(column.size(), view.size());
+    EXPECT_EQ(column.data(), view.data());
+    EXPECT_EQ(0, view.bitOffset());
+
+    for (std::size_t idx = 0; idx < view.size(); ++idx) {
+        EXPECT_EQ(column.isValid(idx), view.isValid(idx)) << "Validity of cell " << idx << " differs";
+
+        if (column.isValid(idx)) {
+            EXPECT_EQ(column[idx], view[idx]);
+        }
+    }
+
+    std::size_t count = 0;
+
+    for (const auto & value : view) {
+        count += !std::isnan(value);
+    }
+
+    EXPECT_EQ(column.validCount(), count);
+}
+
+TEST(ColumnViewTest, testSubview)
+{
+    const auto column = testColumn();
+
+    // offsets either side of the validity word boundaries
+    for (const std::size_t first : {0, 1, 63, 64, 65, 130}) {
+        const auto view = column.view().subview(first, 50);
+        EXPECT_EQ(50, view.size());
+        EXPECT_EQ(first % 64, view.bitOffset());
+
+        for (std::size_t idx = 0; idx < view.size(); ++idx) {
+            EXPECT_EQ(column.isValid(first + idx), view.isValid(idx)) << "Validity of cell " << idx << " of subview from " << first << " differs";
+            EXPECT_EQ(column.data() + first + idx, &view[idx]);
+        }
+
+        // a subview of a subview
+        const auto inner = view.subview(10, 20);
+
+        for (std::size_t idx = 0; idx < inner.size(); ++idx) {
+            EXPECT_EQ(column.isValid(first + 10 + idx), inner.isValid(idx));
+        }
+    }
+
+    EXPECT_TRUE(column.view().subview(200, 0).isEmpty());
+}
+
+TEST(ColumnViewTest, testStrided)
+{
+    const auto column = testColumn();
+    const auto strided = column.view().strided(3);
+
+    EXPECT_EQ(67, strided.size());
+    EXPECT_EQ(3, strided.stride());
+
+    for (std::size_t idx = 0; idx < strided.size(); ++idx) {
+        EXPECT_EQ(column.data() + idx * 3, &strided[idx]);
+    }
+
+    // every third cell from 1 avoids the multiples of 3
+    const auto offset = column.view().subview(1, 199).strided(3);
+    EXPECT_EQ(67, offset.size());
+    EXPECT_EQ(1.0, offset[0]);
+    EXPECT_EQ(4.0, offset[1]);
+}
+
+TEST(DataFileViewTest, testViews)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "t-test-views-test.csv").string();
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "1,2,3\n4,,6\n7,8";
+    const DataFile<double> data(path);
+    std::filesystem::remove(path);
+
+    const auto column = data.columnView(1);
+    EXPECT_EQ(3, column.size());
+    EXPECT_EQ(2.0, column[0]);
+    EXPECT_FALSE(column.isValid(1));
+    EXPECT_TRUE(std::isnan(column[1]));
+    EXPECT_THROW(static_cast<void>(data.columnView(3)), std::invalid_argument);
+
+    const auto row = data.rowView(2);
+    EXPECT_EQ(3, row.size());
+    EXPECT_EQ(2, row.row());
+    EXPECT_EQ(7.0, row[0]);
+    EXPECT_EQ(8.0, row[1]);
+    EXPECT_FALSE(row.isValid(2));
+    EXPECT_THROW(static_cast<void>(data.rowView(3)), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(data.rowView(-1)), std::invalid_argument);
+
+    for (long r = 0; r < data.rowCount(); ++r) {
+        for (long c = 0; c < data.columnCount(); ++c) {
+            EXPECT_EQ(&data.item(r, c), &data.uncheckedItem(r, c));
+        }
+    }
+}